@@ -37,6 +37,9 @@ PHP_ARG_ENABLE(swoole, swoole support,
 PHP_ARG_ENABLE(mysqlnd, enable mysqlnd support,
 [  --enable-mysqlnd          Enable mysqlnd], no, no)
 
+PHP_ARG_ENABLE(swoole-curl, enable curl support,
+[  --enable-swoole-curl      Drive ext/curl handles with the reactor], no, no)
+
 PHP_ARG_WITH(openssl_dir, dir of openssl,
 [  --with-openssl-dir[=DIR]    Include OpenSSL support (requires OpenSSL >= 0.9.6)], no, no)
 
@@ -405,14 +408,22 @@ if test "$PHP_SWOOLE" != "no"; then
         AC_DEFINE(SW_USE_MYSQLND, 1, [use mysqlnd])
     fi
 
+    if test "$PHP_SWOOLE_CURL" = "yes"; then
+        PHP_ADD_LIBRARY(curl, 1, SWOOLE_SHARED_LIBADD)
+        PHP_ADD_EXTENSION_DEP(swoole, curl, true)
+        AC_DEFINE(SW_USE_CURL, 1, [enable curl support])
+    fi
+
     swoole_source_file=" \
         php_swoole_cxx.cc \
         src/core/array.c \
         src/core/base.c \
         src/core/channel.c \
+        src/core/counter.c \
         src/core/error.cc \
         src/core/hashmap.c \
         src/core/heap.c \
+        src/core/histogram.c \
         src/core/list.c \
         src/core/log.c \
         src/core/rbtree.c \
@@ -422,8 +433,10 @@ if test "$PHP_SWOOLE" != "no"; then
         src/coroutine/base.cc \
         src/coroutine/channel.cc \
         src/coroutine/context.cc \
+        src/coroutine/curl.cc \
         src/coroutine/file_lock.cc \
         src/coroutine/hook.cc \
+        src/coroutine/lock.cc \
         src/coroutine/socket.cc \
         src/coroutine/system.cc \
         src/coroutine/thread_context.cc \
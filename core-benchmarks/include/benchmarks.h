@@ -0,0 +1,23 @@
+#pragma once
+
+#include "swoole.h"
+#include "swoole_api.h"
+#include "coroutine.h"
+
+#include <benchmark/benchmark.h>
+
+/**
+ * run the benchmark loop in a coroutine, the event loop is only used for the waiting coroutines
+ */
+static inline void coro_benchmark(benchmark::State &state, void (*fn)(benchmark::State &))
+{
+    std::pair<benchmark::State *, void (*)(benchmark::State &)> args(&state, fn);
+    swoole_event_init();
+    SwooleTG.reactor->wait_exit = 1;
+    swoole::Coroutine::create([](void *arg)
+    {
+        auto args = (std::pair<benchmark::State *, void (*)(benchmark::State &)> *) arg;
+        args->second(*args->first);
+    }, &args);
+    swoole_event_wait();
+}
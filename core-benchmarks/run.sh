@@ -0,0 +1,10 @@
+#!/bin/bash
+# the json report can be compared with a previous one by tools/compare.py of google benchmark
+# libswoole is rebuilt in release mode, the numbers of a debug build are meaningless
+(cd .. && cmake -DCMAKE_BUILD_TYPE=Release . && make -j8 lib-swoole) && \
+cmake . && make -j8 && ./bin/core_benchmarks \
+    --benchmark_repetitions=5 \
+    --benchmark_report_aggregates_only=true \
+    --benchmark_out=benchmark.json \
+    --benchmark_out_format=json \
+    "$@"
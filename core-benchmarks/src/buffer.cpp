@@ -0,0 +1,44 @@
+#include "benchmarks.h"
+#include "buffer.h"
+#include "connection.h"
+
+#include <sys/socket.h>
+
+/**
+ * append state.range(0) bytes to the output buffer of a socket and flush it to the peer
+ */
+static void buffer_append_flush(benchmark::State &state)
+{
+    int pairs[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, pairs) < 0)
+    {
+        state.SkipWithError("socketpair() failed");
+        return;
+    }
+    swSocket sock;
+    bzero(&sock, sizeof(sock));
+    sock.fd = pairs[0];
+    sock.out_buffer = swBuffer_new(SW_BUFFER_SIZE_STD);
+
+    std::string data(state.range(0), 'x');
+    char buf[65536];
+    for (auto _ : state)
+    {
+        swBuffer_append(sock.out_buffer, data.c_str(), data.length());
+        while (!swBuffer_empty(sock.out_buffer))
+        {
+            if (swConnection_buffer_send(&sock) < 0)
+            {
+                state.SkipWithError("send failed");
+                break;
+            }
+            while (recv(pairs[1], buf, sizeof(buf), MSG_DONTWAIT) > 0) { }
+        }
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+
+    swBuffer_free(sock.out_buffer);
+    close(pairs[0]);
+    close(pairs[1]);
+}
+BENCHMARK(buffer_append_flush)->Arg(64)->Arg(8192)->Arg(65536);
@@ -0,0 +1,47 @@
+#include "benchmarks.h"
+#include "coroutine_channel.h"
+
+using swoole::Coroutine;
+using swoole::coroutine::Channel;
+
+/**
+ * push and pop in the same coroutine, no switch
+ */
+static void channel_push_pop(benchmark::State &state)
+{
+    coro_benchmark(state, [](benchmark::State &state)
+    {
+        Channel chan(state.range(0));
+        int i = 1;
+        for (auto _ : state)
+        {
+            chan.push(&i);
+            benchmark::DoNotOptimize(chan.pop());
+        }
+    });
+}
+BENCHMARK(channel_push_pop)->Arg(1)->Arg(1024);
+
+/**
+ * a consumer coroutine waiting on the channel, every push switches to it
+ */
+static void channel_ping_pong(benchmark::State &state)
+{
+    coro_benchmark(state, [](benchmark::State &state)
+    {
+        Channel chan(1);
+        Coroutine::create([](void *arg)
+        {
+            Channel *chan = (Channel *) arg;
+            while (chan->pop() != nullptr) { }
+        }, &chan);
+
+        int i = 1;
+        for (auto _ : state)
+        {
+            chan.push(&i);
+        }
+        chan.close();
+    });
+}
+BENCHMARK(channel_ping_pong);
@@ -0,0 +1,38 @@
+#include "benchmarks.h"
+
+using swoole::Coroutine;
+
+static void coroutine_create(benchmark::State &state)
+{
+    for (auto _ : state)
+    {
+        Coroutine::create([](void *arg) { }, nullptr);
+    }
+}
+BENCHMARK(coroutine_create);
+
+/**
+ * one iteration is a resume and a yield
+ */
+static void coroutine_switch(benchmark::State &state)
+{
+    bool running = true;
+    long cid = Coroutine::create([](void *arg)
+    {
+        Coroutine *co = Coroutine::get_current();
+        while (*(bool *) arg)
+        {
+            co->yield();
+        }
+    }, &running);
+    Coroutine *co = Coroutine::get_by_cid(cid);
+
+    for (auto _ : state)
+    {
+        co->resume();
+    }
+
+    running = false;
+    co->resume();
+}
+BENCHMARK(coroutine_switch);
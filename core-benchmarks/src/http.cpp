@@ -0,0 +1,39 @@
+#include "benchmarks.h"
+#include "http.h"
+
+static const char request_text[] =
+    "POST /api/v1/users?id=1024&name=swoole HTTP/1.1\r\n"
+    "Host: 127.0.0.1:9501\r\n"
+    "User-Agent: Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 (KHTML, like Gecko) Chrome/78.0 Safari/537.36\r\n"
+    "Accept: text/html,application/xhtml+xml,application/xml;q=0.9,*/*;q=0.8\r\n"
+    "Accept-Encoding: gzip, deflate\r\n"
+    "Accept-Language: en-US,en;q=0.9\r\n"
+    "Connection: keep-alive\r\n"
+    "Content-Type: application/x-www-form-urlencoded\r\n"
+    "Content-Length: 11\r\n"
+    "\r\n"
+    "hello=world";
+
+/**
+ * the parsing done by the reactor before dispatching a request: protocol line, header end and content length
+ */
+static void http_request_parse(benchmark::State &state)
+{
+    swString *buffer = swString_dup(request_text, sizeof(request_text) - 1);
+    swHttpRequest request;
+
+    for (auto _ : state)
+    {
+        bzero(&request, sizeof(request));
+        request.buffer = buffer;
+        buffer->offset = 0;
+        swHttpRequest_get_protocol(&request);
+        swHttpRequest_get_header_length(&request);
+        swHttpRequest_get_header_info(&request);
+        benchmark::DoNotOptimize(request.content_length);
+    }
+    state.SetBytesProcessed(state.iterations() * buffer->length);
+
+    swString_free(buffer);
+}
+BENCHMARK(http_request_parse);
@@ -0,0 +1,15 @@
+#include "benchmarks.h"
+
+int main(int argc, char **argv)
+{
+    swoole_init();
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+    {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+
+    return 0;
+}
@@ -0,0 +1,46 @@
+#include "benchmarks.h"
+
+static int reactor_onRead(swReactor *reactor, swEvent *event)
+{
+    char buf[64];
+    if (read(event->fd, buf, sizeof(buf)) <= 0)
+    {
+        return SW_ERR;
+    }
+    return SW_OK;
+}
+
+/**
+ * one readable pipe per iteration: epoll_wait, handler lookup and dispatch
+ */
+static void reactor_dispatch(benchmark::State &state)
+{
+    int pipes[2];
+    if (pipe(pipes) < 0)
+    {
+        state.SkipWithError("pipe() failed");
+        return;
+    }
+    swoole_event_init();
+    swReactor *reactor = SwooleTG.reactor;
+    swReactor_set_handler(reactor, SW_FD_USER | SW_EVENT_READ, reactor_onRead);
+    swoole_event_add(pipes[0], SW_EVENT_READ, SW_FD_USER);
+    reactor->once = 1;
+
+    char c = 'x';
+    for (auto _ : state)
+    {
+        if (write(pipes[1], &c, 1) != 1)
+        {
+            state.SkipWithError("write() failed");
+            break;
+        }
+        reactor->wait(reactor, nullptr);
+    }
+
+    swoole_event_del(pipes[0]);
+    swoole_event_free();
+    close(pipes[0]);
+    close(pipes[1]);
+}
+BENCHMARK(reactor_dispatch);
@@ -0,0 +1,85 @@
+#include "benchmarks.h"
+#include "table.h"
+
+#include <string>
+#include <vector>
+
+#define TABLE_SIZE   65536
+#define TABLE_KEYS   1024
+
+static swTable *table = nullptr;
+static swTableColumn *column_id = nullptr;
+/**
+ * formatted before the timed loops, so the benchmarks measure the table only
+ */
+static std::vector<std::string> keys;
+
+static void table_setup(const benchmark::State &state)
+{
+    table = swTable_new(TABLE_SIZE, 0.2);
+    swTableColumn_add(table, SW_STRL("id"), SW_TABLE_INT, sizeof(long));
+    swTableColumn_add(table, SW_STRL("name"), SW_TABLE_STRING, 32);
+    swTable_create(table);
+    column_id = swTableColumn_get(table, (char *) SW_STRL("id"));
+    if (keys.empty())
+    {
+        for (size_t n = 0; n < TABLE_KEYS; n++)
+        {
+            keys.push_back("key-" + std::to_string(n));
+        }
+    }
+}
+
+static void table_teardown(const benchmark::State &state)
+{
+    swTable_free(table);
+    table = nullptr;
+}
+
+/**
+ * the threads write the same keys, so the rows are contended
+ */
+static void table_set(benchmark::State &state)
+{
+    long value = 0;
+    size_t n = 0;
+    for (auto _ : state)
+    {
+        value = n;
+        const std::string &key = keys[n++ % TABLE_KEYS];
+        swTableRow *rowlock;
+        swTableRow *row = swTableRow_set(table, key.c_str(), key.length(), &rowlock);
+        if (row)
+        {
+            swTableRow_set_value(row, column_id, &value, sizeof(value));
+        }
+        swTableRow_unlock(rowlock);
+    }
+}
+BENCHMARK(table_set)->Setup(table_setup)->Teardown(table_teardown)->ThreadRange(1, 8)->UseRealTime();
+
+static void table_get(benchmark::State &state)
+{
+    long value = 0;
+    for (auto &key : keys)
+    {
+        swTableRow *rowlock;
+        swTableRow *row = swTableRow_set(table, key.c_str(), key.length(), &rowlock);
+        swTableRow_set_value(row, column_id, &value, sizeof(value));
+        swTableRow_unlock(rowlock);
+    }
+
+    size_t n = 0;
+    for (auto _ : state)
+    {
+        const std::string &key = keys[n++ % TABLE_KEYS];
+        swTableRow *rowlock;
+        swTableRow *row = swTableRow_get(table, key.c_str(), key.length(), &rowlock);
+        if (row)
+        {
+            benchmark::DoNotOptimize(*(long *) (row->data + column_id->index));
+        }
+        swTableRow_unlock(rowlock);
+    }
+}
+BENCHMARK(table_get)->Setup(table_setup)->Teardown(table_teardown)->ThreadRange(1, 8)->UseRealTime();
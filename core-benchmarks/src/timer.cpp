@@ -0,0 +1,31 @@
+#include "benchmarks.h"
+
+#include <vector>
+
+static void timer_callback(swTimer *timer, swTimer_node *tnode) { }
+
+/**
+ * add and delete a timer while state.range(0) other timers are pending
+ */
+static void timer_add_del(benchmark::State &state)
+{
+    swoole_event_init();
+    std::vector<swTimer_node *> pending;
+    for (int64_t i = 0; i < state.range(0); i++)
+    {
+        pending.push_back(swoole_timer_add(1000 + i % 1000, SW_FALSE, timer_callback, nullptr));
+    }
+
+    for (auto _ : state)
+    {
+        swTimer_node *tnode = swoole_timer_add(500, SW_FALSE, timer_callback, nullptr);
+        swoole_timer_del(tnode);
+    }
+
+    for (auto tnode : pending)
+    {
+        swoole_timer_del(tnode);
+    }
+    swoole_event_free();
+}
+BENCHMARK(timer_add_del)->Arg(0)->Arg(1000)->Arg(100000);
@@ -0,0 +1,48 @@
+#include "benchmarks.h"
+#include "websocket.h"
+
+/**
+ * length check and unmasking of a client frame with a payload of state.range(0) bytes
+ */
+static void websocket_decode(benchmark::State &state)
+{
+    std::string payload(state.range(0), 'x');
+    swString *buffer = swString_new(state.range(0) + SW_WEBSOCKET_HEADER_LEN + 64);
+    swWebSocket_encode(buffer, payload.c_str(), payload.length(), WEBSOCKET_OPCODE_TEXT,
+            SW_WEBSOCKET_FLAG_FIN | SW_WEBSOCKET_FLAG_MASK);
+
+    swProtocol protocol;
+    bzero(&protocol, sizeof(protocol));
+    swWebSocket_frame frame;
+
+    for (auto _ : state)
+    {
+        if (swWebSocket_get_package_length(&protocol, nullptr, buffer->str, buffer->length) != (ssize_t) buffer->length)
+        {
+            state.SkipWithError("bad frame");
+            break;
+        }
+        swWebSocket_decode(&frame, buffer);
+        benchmark::DoNotOptimize(frame.payload);
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+
+    swString_free(buffer);
+}
+BENCHMARK(websocket_decode)->Arg(64)->Arg(4096)->Arg(65536);
+
+static void websocket_encode(benchmark::State &state)
+{
+    std::string payload(state.range(0), 'x');
+    swString *buffer = swString_new(state.range(0) + SW_WEBSOCKET_HEADER_LEN + 64);
+
+    for (auto _ : state)
+    {
+        swString_clear(buffer);
+        swWebSocket_encode(buffer, payload.c_str(), payload.length(), WEBSOCKET_OPCODE_TEXT, SW_WEBSOCKET_FLAG_FIN);
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+
+    swString_free(buffer);
+}
+BENCHMARK(websocket_encode)->Arg(64)->Arg(4096)->Arg(65536);
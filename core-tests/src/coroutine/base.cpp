@@ -42,3 +42,34 @@ TEST(coroutine_base, yield_resume)
     Coroutine::get_by_cid(cid)->resume();
     ASSERT_EQ(cid, _cid);
 }
+
+TEST(coroutine_base, reuse)
+{
+    std::vector<long> cids;
+    long last_cid = Coroutine::get_last_cid();
+    for (int i = 0; i < 4096; i++)
+    {
+        long cid = Coroutine::create([](void *arg)
+        {
+            Coroutine::get_current()->yield();
+        });
+        ASSERT_EQ(cid, ++last_cid);
+        ASSERT_EQ(Coroutine::get_by_cid(cid)->get_cid(), cid);
+        cids.push_back(cid);
+        // close every other coroutine, the pooled ones are reused by the next create
+        if (i % 2 == 1)
+        {
+            long prev = cids[cids.size() - 2];
+            Coroutine::get_by_cid(prev)->resume();
+            ASSERT_EQ(Coroutine::get_by_cid(prev), nullptr);
+        }
+    }
+    ASSERT_EQ(Coroutine::count(), 2048);
+    for (size_t i = 1; i < cids.size(); i += 2)
+    {
+        ASSERT_EQ(Coroutine::get_by_cid(cids[i])->get_cid(), cids[i]);
+        Coroutine::get_by_cid(cids[i])->resume();
+    }
+    ASSERT_EQ(Coroutine::count(), 0);
+    ASSERT_LE(Coroutine::get_pool_size(), SW_DEFAULT_CORO_POOL_SIZE);
+}
@@ -99,3 +99,148 @@ TEST(coroutine_channel, pop_timeout)
         ASSERT_EQ(ret, nullptr);
     });
 }
+
+TEST(coroutine_channel, select)
+{
+    Channel chan1(1), chan2(1);
+    Channel *chans[] = {&chan1, &chan2};
+
+    coro_test({
+        make_pair([](void *arg)
+        {
+            auto chans = (Channel **) arg;
+            vector<Channel::select_case_t> cases = {
+                {chans[0], Channel::CONSUMER, nullptr, false},
+                {chans[1], Channel::CONSUMER, nullptr, false},
+            };
+            ASSERT_EQ(Channel::select(cases), 1);
+            ASSERT_EQ(*(int *) cases[1].data, 2);
+            ASSERT_EQ(chans[0]->consumer_num(), 0);
+            ASSERT_EQ(chans[1]->consumer_num(), 0);
+        }, chans),
+
+        make_pair([](void *arg)
+        {
+            auto chans = (Channel **) arg;
+            static int i = 2;
+            ASSERT_TRUE(chans[1]->push(&i));
+        }, chans)
+    });
+}
+
+TEST(coroutine_channel, select_push)
+{
+    coro_test([](void *arg)
+    {
+        Channel chan1(1), chan2(1);
+        int i = 1, j = 2;
+
+        ASSERT_TRUE(chan1.push(&i));
+        vector<Channel::select_case_t> cases = {
+            {&chan1, Channel::PRODUCER, &j, false},
+            {&chan2, Channel::PRODUCER, &j, false},
+        };
+        ASSERT_EQ(Channel::select(cases), 1);
+        ASSERT_EQ(*(int *) chan2.pop(), 2);
+    });
+}
+
+TEST(coroutine_channel, select_push_consumer_close)
+{
+    Channel chan(1);
+
+    coro_test({
+        make_pair([](void *arg)
+        {
+            auto chan = (Channel *) arg;
+            ASSERT_EQ(*(int *) chan->pop(), 3);
+            // the consumer closes the channel before the select returns
+            chan->close();
+        }, &chan),
+
+        make_pair([](void *arg)
+        {
+            auto chan = (Channel *) arg;
+            static int i = 3;
+            vector<Channel::select_case_t> cases = {
+                {chan, Channel::PRODUCER, &i, false},
+            };
+            ASSERT_EQ(Channel::select(cases), 0);
+            ASSERT_FALSE(cases[0].closed);
+            ASSERT_TRUE(chan->is_closed());
+        }, &chan)
+    });
+}
+
+TEST(coroutine_channel, select_timeout)
+{
+    coro_test([](void *arg)
+    {
+        Channel chan1(1), chan2(1);
+        vector<Channel::select_case_t> cases = {
+            {&chan1, Channel::CONSUMER, nullptr, false},
+            {&chan2, Channel::CONSUMER, nullptr, false},
+        };
+        ASSERT_EQ(Channel::select(cases, 0.001), -1);
+        ASSERT_EQ(chan1.consumer_num(), 0);
+        ASSERT_EQ(chan2.consumer_num(), 0);
+    });
+}
+
+TEST(coroutine_channel, push_pop_many)
+{
+    Channel chan(4);
+    static int items[] = {1, 2, 3, 4, 5, 6};
+
+    coro_test({
+        make_pair([](void *arg)
+        {
+            auto chan = (Channel *) arg;
+            void *data[6];
+            for (int i = 0; i < 6; i++)
+            {
+                data[i] = &items[i];
+            }
+            ASSERT_EQ(chan->push_many(data, 6), 4);
+            ASSERT_EQ(chan->push_many(data + 4, 2), 2);
+        }, &chan),
+
+        make_pair([](void *arg)
+        {
+            auto chan = (Channel *) arg;
+            void *data[8];
+            ASSERT_EQ(chan->pop_many(data, 8), 4);
+            for (int i = 0; i < 4; i++)
+            {
+                ASSERT_EQ(*(int *) data[i], i + 1);
+            }
+            ASSERT_EQ(chan->pop_many(data, 8), 2);
+            ASSERT_EQ(*(int *) data[1], 6);
+            ASSERT_EQ(chan->pop_many(data, 8, 0.001), 0);
+        }, &chan)
+    });
+}
+
+TEST(coroutine_channel, ring_grow)
+{
+    coro_test([](void *arg)
+    {
+        Channel chan(SIZE_MAX);
+        static int items[100];
+        for (int i = 0; i < 100; i++)
+        {
+            items[i] = i;
+            ASSERT_TRUE(chan.push(&items[i]));
+            // the head moves, so the elements wrap around the ring before it grows
+            if (i % 3 == 0)
+            {
+                ASSERT_EQ(*(int *) chan.pop(), i / 3);
+            }
+        }
+        for (int i = 34; i < 100; i++)
+        {
+            ASSERT_EQ(*(int *) chan.pop(), i);
+        }
+        ASSERT_TRUE(chan.is_empty());
+    });
+}
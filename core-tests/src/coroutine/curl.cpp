@@ -0,0 +1,89 @@
+#include "tests.h"
+#include "coroutine_curl.h"
+#include "coroutine_socket.h"
+#include "coroutine_system.h"
+
+#ifdef SW_USE_CURL
+using swoole::Coroutine;
+using swoole::coroutine::CurlMulti;
+using swoole::coroutine::Socket;
+using swoole::coroutine::System;
+
+static const int port = 9702;
+static const int client_num = 10;
+
+static size_t write_body(char *data, size_t size, size_t nmemb, void *userp)
+{
+    ((std::string *) userp)->append(data, size * nmemb);
+    return size * nmemb;
+}
+
+/**
+ * every response takes 100ms, the requests run at the same time
+ */
+static void http_server(void *arg)
+{
+    Socket server(SW_SOCK_TCP);
+    ASSERT_TRUE(server.bind("127.0.0.1", port));
+    ASSERT_TRUE(server.listen());
+    for (int i = 0; i < client_num; i++)
+    {
+        Socket *conn = server.accept();
+        ASSERT_NE(conn, nullptr);
+        Coroutine::create([](void *arg) {
+            Socket *conn = (Socket *) arg;
+            char buf[4096];
+            ASSERT_GT(conn->recv(buf, sizeof(buf)), 0);
+            System::sleep(0.1);
+            conn->send(SW_STRL("HTTP/1.1 200 OK\r\nContent-Length: 5\r\nConnection: close\r\n\r\nhello"));
+            conn->close();
+            delete conn;
+        }, conn);
+    }
+}
+
+static void http_client(void *arg)
+{
+    int *done = (int *) arg;
+    CURL *cp = curl_easy_init();
+    std::string body;
+    curl_easy_setopt(cp, CURLOPT_URL, ("http://127.0.0.1:" + std::to_string(port) + "/").c_str());
+    curl_easy_setopt(cp, CURLOPT_WRITEFUNCTION, write_body);
+    curl_easy_setopt(cp, CURLOPT_WRITEDATA, &body);
+    ASSERT_EQ(CurlMulti::exec(cp), CURLE_OK);
+    ASSERT_EQ(body, "hello");
+    curl_easy_cleanup(cp);
+    (*done)++;
+}
+
+TEST(coroutine_curl, exec)
+{
+    int done = 0;
+    double start = swoole_microtime();
+    coro_test({
+        std::make_pair(http_server, nullptr),
+        std::make_pair(http_client, (void *) &done),
+        std::make_pair(http_client, (void *) &done),
+        std::make_pair(http_client, (void *) &done),
+        std::make_pair(http_client, (void *) &done),
+        std::make_pair(http_client, (void *) &done),
+        std::make_pair(http_client, (void *) &done),
+        std::make_pair(http_client, (void *) &done),
+        std::make_pair(http_client, (void *) &done),
+        std::make_pair(http_client, (void *) &done),
+        std::make_pair(http_client, (void *) &done),
+    });
+    ASSERT_EQ(done, client_num);
+    ASSERT_LT(swoole_microtime() - start, 0.1 * client_num / 2);
+}
+
+TEST(coroutine_curl, connect_refused)
+{
+    coro_test([](void *arg) {
+        CURL *cp = curl_easy_init();
+        curl_easy_setopt(cp, CURLOPT_URL, "http://127.0.0.1:9703/");
+        ASSERT_EQ(CurlMulti::exec(cp), CURLE_COULDNT_CONNECT);
+        curl_easy_cleanup(cp);
+    });
+}
+#endif
@@ -127,3 +127,45 @@ TEST(coroutine_socket, accept)
         }
     });
 }
+
+TEST(coroutine_socket, recvfile)
+{
+    coro_test({
+        [](void *arg)
+        {
+            Socket sock(SW_SOCK_TCP);
+            ASSERT_EQ(sock.bind("127.0.0.1", 9910), true);
+            ASSERT_EQ(sock.listen(128), true);
+
+            Socket *conn = sock.accept();
+            ASSERT_NE(conn, nullptr);
+            std::string data;
+            for (int i = 0; i < 256 * 1024; i++)
+            {
+                data.push_back('a' + i % 26);
+            }
+            ASSERT_EQ(conn->send_all(data.c_str(), data.length()), (ssize_t) data.length());
+            conn->close();
+            delete conn;
+        },
+
+        [](void *arg)
+        {
+            Socket sock(SW_SOCK_TCP);
+            ASSERT_EQ(sock.connect("127.0.0.1", 9910, -1), true);
+            FILE *file = tmpfile();
+            int fd = fileno(file);
+            ASSERT_EQ(sock.recvfile(fd, 256 * 1024), true);
+            ASSERT_EQ(lseek(fd, 0, SEEK_CUR), 256 * 1024);
+
+            char buf[26];
+            ASSERT_EQ(pread(fd, buf, sizeof(buf), 26 * 1000), (ssize_t) sizeof(buf));
+            ASSERT_EQ(memcmp(buf, "abcdefghijklmnopqrstuvwxyz", sizeof(buf)), 0);
+
+            // the peer has closed the connection
+            ASSERT_EQ(sock.recvfile(fd, 1), false);
+            ASSERT_EQ(sock.errCode, ECONNRESET);
+            fclose(file);
+        }
+    });
+}
@@ -0,0 +1,117 @@
+#include "swoole.h"
+#include "counter.h"
+#include <gtest/gtest.h>
+#include <sys/wait.h>
+
+#include <set>
+
+TEST(counter, slots)
+{
+    swCounter *counter = swCounter_new(4, 0);
+    ASSERT_NE(counter, nullptr);
+    ASSERT_EQ((uintptr_t) counter->slots % SW_COUNTER_SLOT_SIZE, 0);
+    ASSERT_EQ(sizeof(swCounter_slot), SW_COUNTER_SLOT_SIZE);
+
+    swWorker worker = {};
+    SwooleWG.worker = &worker;
+    for (uint32_t i = 0; i < 8; i++)
+    {
+        SwooleWG.id = i;
+        swCounter_add(counter, 10);
+    }
+    swCounter_sub(counter, 5);
+    SwooleWG.id = 0;
+    SwooleWG.worker = nullptr;
+    ASSERT_EQ(swCounter_get(counter), 75);
+    ASSERT_EQ(counter->slots[1].value, 20);
+
+    swCounter_set(counter, 100);
+    ASSERT_EQ(swCounter_get(counter), 100);
+    swCounter_free(counter, 0);
+
+    counter = swCounter_new(0, 0);
+    ASSERT_EQ(counter->slot_num, SW_CPU_NUM);
+    swCounter_free(counter, 0);
+}
+
+TEST(counter, processes)
+{
+    const int worker_num = 4;
+    const int n = 100000;
+    swCounter *counter = swCounter_new(worker_num, 1);
+    ASSERT_NE(counter, nullptr);
+
+    pid_t pids[worker_num];
+    for (int i = 0; i < worker_num; i++)
+    {
+        pids[i] = fork();
+        ASSERT_GE(pids[i], 0);
+        if (pids[i] == 0)
+        {
+            swWorker worker = {};
+            SwooleWG.worker = &worker;
+            SwooleWG.id = i;
+            for (int j = 0; j < n; j++)
+            {
+                swCounter_add(counter, 1);
+            }
+            _exit(0);
+        }
+    }
+    for (int i = 0; i < worker_num; i++)
+    {
+        int status;
+        ASSERT_EQ(waitpid(pids[i], &status, 0), pids[i]);
+    }
+    ASSERT_EQ(swCounter_get(counter), (long) worker_num * n);
+    for (int i = 0; i < worker_num; i++)
+    {
+        ASSERT_EQ(counter->slots[i].value, n);
+    }
+    swCounter_free(counter, 1);
+}
+
+TEST(counter, processes_without_worker_id)
+{
+    const int process_num = 4;
+    const int n = 1000;
+    swCounter *counter = swCounter_new(process_num, 1);
+    ASSERT_NE(counter, nullptr);
+
+    // the forked processes are not server workers, they are spread by their pids
+    pid_t pids[process_num];
+    for (int i = 0; i < process_num; i++)
+    {
+        pids[i] = fork();
+        ASSERT_GE(pids[i], 0);
+        if (pids[i] == 0)
+        {
+            SwooleG.pid = getpid();
+            for (int j = 0; j < n; j++)
+            {
+                swCounter_add(counter, 1);
+            }
+            _exit(0);
+        }
+    }
+    std::set<uint32_t> slots;
+    for (int i = 0; i < process_num; i++)
+    {
+        int status;
+        ASSERT_EQ(waitpid(pids[i], &status, 0), pids[i]);
+        slots.insert(pids[i] % process_num);
+    }
+    ASSERT_EQ(swCounter_get(counter), (long) process_num * n);
+    ASSERT_GT(slots.size(), 1);
+    uint32_t used_slots = 0;
+    for (int i = 0; i < process_num; i++)
+    {
+        if (counter->slots[i].value > 0)
+        {
+            ASSERT_TRUE(slots.count(i));
+            used_slots++;
+        }
+    }
+    ASSERT_EQ(used_slots, slots.size());
+    swCounter_free(counter, 1);
+}
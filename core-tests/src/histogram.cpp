@@ -0,0 +1,64 @@
+#include "swoole.h"
+#include "histogram.h"
+#include <gtest/gtest.h>
+
+TEST(histogram, index)
+{
+    for (uint64_t value = 0; value < 1000000; value += 7)
+    {
+        uint32_t index = swHistogram_get_index(value);
+        ASSERT_GE(swHistogram_get_value(index), value);
+        ASSERT_LT(swHistogram_get_value(index) - value, value / 16 + 1);
+        if (index > 0)
+        {
+            ASSERT_LT(swHistogram_get_value(index - 1), value);
+        }
+    }
+    ASSERT_EQ(swHistogram_get_index(UINT64_MAX), SW_HISTOGRAM_BUCKET_NUM - 1);
+}
+
+TEST(histogram, percentile)
+{
+    swHistogram histogram;
+    swHistogram_reset(&histogram);
+    ASSERT_EQ(swHistogram_percentile(&histogram, 50), 0);
+
+    for (uint64_t i = 1; i <= 10000; i++)
+    {
+        swHistogram_record(&histogram, i);
+    }
+    ASSERT_EQ(histogram.count, 10000);
+    ASSERT_EQ(histogram.max, 10000);
+    ASSERT_EQ(histogram.sum, 10000 * 10001 / 2);
+
+    uint64_t p50 = swHistogram_percentile(&histogram, 50);
+    ASSERT_GE(p50, 5000);
+    ASSERT_LE(p50, 5000 + 5000 / 16);
+    uint64_t p99 = swHistogram_percentile(&histogram, 99);
+    ASSERT_GE(p99, 9900);
+    ASSERT_LE(p99, 10000);
+    ASSERT_EQ(swHistogram_percentile(&histogram, 100), 10000);
+}
+
+TEST(histogram, sharded)
+{
+    swShardedHistogram *histogram = swShardedHistogram_new(4, 0);
+    ASSERT_NE(histogram, nullptr);
+    ASSERT_EQ((uintptr_t) histogram->shards % SW_HISTOGRAM_ALIGN_SIZE, 0);
+    ASSERT_EQ(swShardedHistogram_get_shard(histogram, 5), &histogram->shards[1]);
+
+    for (uint32_t id = 0; id < 4; id++)
+    {
+        for (uint64_t i = 1; i <= 100; i++)
+        {
+            swHistogram_record(swShardedHistogram_get_shard(histogram, id), i * (id + 1));
+        }
+    }
+    swHistogram result;
+    swShardedHistogram_get(histogram, &result);
+    ASSERT_EQ(result.count, 400);
+    ASSERT_EQ(result.max, 400);
+    ASSERT_EQ(result.sum, 5050 * (1 + 2 + 3 + 4));
+    ASSERT_EQ(swHistogram_percentile(&result, 100), 400);
+    swShardedHistogram_free(histogram, 0);
+}
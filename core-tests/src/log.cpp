@@ -0,0 +1,161 @@
+#include "tests.h"
+
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+static const char *log_file = "/tmp/swoole_core_tests.log";
+
+static std::vector<std::string> read_lines()
+{
+    std::vector<std::string> lines;
+    std::ifstream file(log_file);
+    std::string line;
+    while (std::getline(file, line))
+    {
+        lines.push_back(line);
+    }
+    return lines;
+}
+
+static size_t count_lines(const std::vector<std::string> &lines, const std::string &needle)
+{
+    size_t n = 0;
+    for (auto &line : lines)
+    {
+        if (line.find(needle) != std::string::npos)
+        {
+            n++;
+        }
+    }
+    return n;
+}
+
+static void put(const std::string &line)
+{
+    swLog_put(SW_LOG_WARNING, (char *) line.c_str(), line.length());
+}
+
+TEST(log, async)
+{
+    unlink(log_file);
+    ASSERT_EQ(swLog_init((char *) log_file), SW_OK);
+    SwooleG.log_async = 1;
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; i++)
+    {
+        threads.push_back(std::thread([i]() {
+            for (int j = 0; j < 100; j++)
+            {
+                put("thread-" + std::to_string(i) + "-line-" + std::to_string(j) + "-" + std::string(100, 'x'));
+            }
+        }));
+    }
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+    // the repeated lines are counted
+    for (int i = 0; i < 1000; i++)
+    {
+        put("send to closed fd");
+    }
+    put("the last line");
+    swLog_flush();
+
+    auto lines = read_lines();
+    for (int i = 0; i < 4; i++)
+    {
+        for (int j = 0; j < 100; j++)
+        {
+            ASSERT_EQ(count_lines(lines, "thread-" + std::to_string(i) + "-line-" + std::to_string(j) + "-"), 1);
+        }
+    }
+    // whole lines only
+    for (auto &line : lines)
+    {
+        ASSERT_EQ(line[0], '[');
+    }
+    ASSERT_LE(count_lines(lines, "send to closed fd"), 2);
+    ASSERT_EQ(count_lines(lines, "repeated"), count_lines(lines, "send to closed fd"));
+    ASSERT_EQ(count_lines(lines, "the last line"), 1);
+
+    SwooleG.log_async = 0;
+    swLog_free();
+    unlink(log_file);
+}
+
+TEST(log, async_drop)
+{
+    unlink(log_file);
+    ASSERT_EQ(swLog_init((char *) log_file), SW_OK);
+    SwooleG.log_async = 1;
+    put("start");
+    swLog_flush();
+    // the writer is sleeping, the lines beyond the buffer are dropped
+    usleep(SW_LOG_ASYNC_INTERVAL * 2000);
+    for (int i = 0; i < 1000; i++)
+    {
+        put("line-" + std::to_string(i) + "-" + std::string(1024, 'x'));
+    }
+    swLog_flush();
+
+    auto lines = read_lines();
+    ASSERT_GE(count_lines(lines, "log lines were dropped"), 1);
+    ASSERT_LT(count_lines(lines, "-xxx"), 1000);
+    ASSERT_GT(count_lines(lines, "-xxx"), 0);
+
+    SwooleG.log_async = 0;
+    swLog_free();
+    unlink(log_file);
+}
+
+TEST(log, async_flush_repeated)
+{
+    unlink(log_file);
+    ASSERT_EQ(swLog_init((char *) log_file), SW_OK);
+    SwooleG.log_async = 1;
+    // no line follows the repeated ones, the count is written by the flush
+    for (int i = 0; i < 1000; i++)
+    {
+        put("accept() failed");
+    }
+    swLog_flush();
+
+    auto lines = read_lines();
+    ASSERT_GE(count_lines(lines, "accept() failed"), 1);
+    ASSERT_GE(count_lines(lines, "last message repeated"), 1);
+
+    SwooleG.log_async = 0;
+    swLog_free();
+    unlink(log_file);
+}
+
+TEST(log, async_thread_exit)
+{
+    unlink(log_file);
+    ASSERT_EQ(swLog_init((char *) log_file), SW_OK);
+    SwooleG.log_async = 1;
+    put("start");
+    swLog_flush();
+    // the buffer of the thread is written and freed when it exits, without waiting for the writer
+    std::thread thread([]() {
+        put("the line of the thread");
+        for (int i = 0; i < 10; i++)
+        {
+            put("the repeated line of the thread");
+        }
+    });
+    thread.join();
+
+    auto lines = read_lines();
+    ASSERT_EQ(count_lines(lines, "the line of the thread"), 1);
+    ASSERT_GE(count_lines(lines, "the repeated line of the thread"), 1);
+    ASSERT_GE(count_lines(lines, "last message repeated"), 1);
+
+    SwooleG.log_async = 0;
+    swLog_free();
+    unlink(log_file);
+}
@@ -98,8 +98,8 @@ int my_onReceive(swServer *serv, swEventData *req)
     swConnection *conn = swWorker_get_connection(serv, req->info.fd);
     swoole_rtrim(req->data, req->info.len);
     printf("onReceive[%d]: ip=%s|port=%d Data=%s|Len=%d\n", g_receive_count, 
-            swConnection_get_ip(conn->socket_type, &conn->info),
-            swConnection_get_port(conn->socket_type, &conn->info),
+            swConnection_get_ip(conn->socket_type, &conn->cold->info),
+            swConnection_get_port(conn->socket_type, &conn->cold->info),
             req->data, req->info.len);
 
     int n = snprintf(resp_data, SW_IPC_BUFFER_SIZE, "Server: %.*s\n", req->info.len, req->data);
@@ -0,0 +1,230 @@
+#include "tests.h"
+#include "table.h"
+
+#include <string>
+
+static const char *table_file = "/tmp/swoole_core_tests.table";
+
+static swTable* create_table(int value_size)
+{
+    swTable *table = swTable_new(1024, 0.5);
+    swTableColumn_add(table, SW_STRL("id"), SW_TABLE_INT, 8);
+    swTableColumn_add(table, SW_STRL("name"), SW_TABLE_STRING, value_size);
+    swTable_set_file(table, table_file);
+    swTable_create(table);
+    return table;
+}
+
+static swTable* create_memory_table(uint32_t size)
+{
+    swTable *table = swTable_new(size, 0.2);
+    swTableColumn_add(table, SW_STRL("id"), SW_TABLE_INT, 8);
+    swTableColumn_add(table, SW_STRL("name"), SW_TABLE_STRING, 32);
+    swTable_create(table);
+    return table;
+}
+
+static void set_row(swTable *table, const std::string &key, int64_t id, uint32_t ttl = 0)
+{
+    swTableRow *rowlock;
+    swTableRow *row = swTableRow_set(table, key.c_str(), key.length(), &rowlock);
+    ASSERT_NE(row, nullptr);
+    swTableRow_set_expire(table, row, ttl);
+    swTableRow_set_value(row, swTableColumn_get(table, (char *) SW_STRL("id")), &id, 0);
+    swTableRow_set_value(row, swTableColumn_get(table, (char *) SW_STRL("name")), (void *) key.c_str(), key.length());
+    swTableRow_unlock(rowlock);
+}
+
+static int64_t get_row(swTable *table, const std::string &key)
+{
+    swTableRow *rowlock;
+    swTableRow *row = swTableRow_get(table, key.c_str(), key.length(), &rowlock);
+    int64_t id = -1;
+    if (row)
+    {
+        memcpy(&id, row->data + swTableColumn_get(table, (char *) SW_STRL("id"))->index, sizeof(id));
+    }
+    swTableRow_unlock(rowlock);
+    return id;
+}
+
+TEST(table, file_attach)
+{
+    unlink(table_file);
+    swTable *table = create_table(32);
+    ASSERT_EQ(table->attached, 0);
+    // more rows than slots, the collision chains live in the pool
+    for (int i = 0; i < 600; i++)
+    {
+        set_row(table, "key-" + std::to_string(i), i);
+    }
+    swTableRow_del(table, (char *) SW_STRL("key-7"));
+    void *memory = table->memory;
+    size_t size = table->shm.size;
+    swTable_free(table);
+
+    // keep the old address busy, the rows are rebased to another one
+    void *blocker = mmap(NULL, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    table = create_table(32);
+    ASSERT_EQ(table->attached, 1);
+    ASSERT_NE(table->memory, memory);
+    ASSERT_EQ(table->row_num, 599);
+    ASSERT_EQ(get_row(table, "key-7"), -1);
+    for (int i = 0; i < 600; i += 7)
+    {
+        if (i != 7)
+        {
+            ASSERT_EQ(get_row(table, "key-" + std::to_string(i)), i);
+        }
+    }
+    // the pool keeps working after it was relinked
+    set_row(table, "key-new", 100000);
+    ASSERT_EQ(get_row(table, "key-new"), 100000);
+    swTable_free(table);
+    munmap(blocker, size);
+
+    // another schema drops the rows
+    table = create_table(64);
+    ASSERT_EQ(table->attached, 0);
+    ASSERT_EQ(table->row_num, 0);
+    ASSERT_EQ(get_row(table, "key-1"), -1);
+    swTable_free(table);
+    unlink(table_file);
+}
+
+TEST(table, file_crashed_writer)
+{
+    unlink(table_file);
+    swTable *table = create_table(32);
+    set_row(table, "done", 1);
+
+    // the writer dies while it holds the row
+    swTableRow *rowlock;
+    swTableRow_set(table, SW_STRL("broken"), &rowlock);
+    swTable_free(table);
+
+    table = create_table(32);
+    ASSERT_EQ(table->attached, 1);
+    ASSERT_EQ(get_row(table, "broken"), -1);
+    ASSERT_EQ(get_row(table, "done"), 1);
+    swTable_free(table);
+    unlink(table_file);
+}
+
+TEST(table, file_locked)
+{
+    unlink(table_file);
+    swTable *table = create_table(32);
+    set_row(table, "key", 1);
+
+    // the file is mapped, another table can not attach it and rebase the rows under it
+    swTable *other = swTable_new(1024, 0.5);
+    swTableColumn_add(other, SW_STRL("id"), SW_TABLE_INT, 8);
+    swTableColumn_add(other, SW_STRL("name"), SW_TABLE_STRING, 32);
+    swTable_set_file(other, table_file);
+    ASSERT_EQ(swTable_create(other), SW_ERR);
+    swTable_free(other);
+    ASSERT_EQ(get_row(table, "key"), 1);
+
+    // the forked process shares the lock of its parent
+    pid_t pid = fork();
+    ASSERT_GE(pid, 0);
+    if (pid == 0)
+    {
+        _exit(get_row(table, "key"));
+    }
+    int status;
+    ASSERT_EQ(waitpid(pid, &status, 0), pid);
+    ASSERT_EQ(WEXITSTATUS(status), 1);
+
+    // attached again once the previous table is freed
+    swTable_free(table);
+    table = create_table(32);
+    ASSERT_EQ(table->attached, 1);
+    ASSERT_EQ(get_row(table, "key"), 1);
+    swTable_free(table);
+    unlink(table_file);
+}
+
+static void expire_row(swTable *table, const std::string &key)
+{
+    swTableRow *rowlock;
+    swTableRow *row = swTableRow_get(table, key.c_str(), key.length(), &rowlock);
+    row->expire = time(NULL) - 1;
+    swTableRow_unlock(rowlock);
+}
+
+TEST(table, expire)
+{
+    swTable *table = create_memory_table(1024);
+    for (int i = 0; i < 100; i++)
+    {
+        set_row(table, "key-" + std::to_string(i), i, 60);
+    }
+    set_row(table, "forever", 1);
+    ASSERT_EQ(table->expirable, 1);
+    ASSERT_EQ(get_row(table, "key-1"), 1);
+
+    // removed by the get
+    expire_row(table, "key-1");
+    ASSERT_EQ(get_row(table, "key-1"), -1);
+    ASSERT_EQ(table->row_num, 100);
+
+    // a set starts from an empty row
+    expire_row(table, "key-2");
+    swTableRow *rowlock;
+    swTableRow *row = swTableRow_set(table, SW_STRL("key-2"), &rowlock);
+    ASSERT_EQ(row->expire, 0);
+    int64_t id;
+    memcpy(&id, row->data + swTableColumn_get(table, (char *) SW_STRL("id"))->index, sizeof(id));
+    ASSERT_EQ(id, 0);
+    swTableRow_unlock(rowlock);
+
+    // removed by the sweep
+    for (int i = 10; i < 100; i++)
+    {
+        expire_row(table, "key-" + std::to_string(i));
+    }
+    ASSERT_EQ(swTable_sweep(table, table->size), 90);
+    ASSERT_EQ(table->row_num, 10);
+    ASSERT_EQ(get_row(table, "forever"), 1);
+    ASSERT_EQ(get_row(table, "key-3"), 3);
+
+    // a ttl beyond the 32-bit expiry time is clamped instead of wrapping around
+    set_row(table, "far", 2, UINT32_MAX);
+    row = swTableRow_get(table, SW_STRL("far"), &rowlock);
+    ASSERT_EQ(row->expire, UINT32_MAX);
+    swTableRow_unlock(rowlock);
+    swTable_free(table);
+}
+
+TEST(table, evict_lru)
+{
+    swTable *table = create_memory_table(64);
+    std::string hot = "hot";
+
+    // the pool is full without eviction
+    int i;
+    for (i = 0; i < 1000; i++)
+    {
+        swTableRow *rowlock;
+        swTableRow *row = swTableRow_set(table, ("key-" + std::to_string(i)).c_str(), 4 + std::to_string(i).length(), &rowlock);
+        swTableRow_unlock(rowlock);
+        if (!row)
+        {
+            break;
+        }
+    }
+    ASSERT_LT(i, 1000);
+
+    table->evict_policy = SW_TABLE_EVICT_LRU;
+    set_row(table, hot, 1);
+    for (i = 0; i < 1000; i++)
+    {
+        set_row(table, "lru-" + std::to_string(i), i);
+        ASSERT_EQ(get_row(table, hot), 1);
+    }
+    ASSERT_GT(table->evict_num, 0);
+    ASSERT_EQ(get_row(table, "lru-999"), 999);
+    swTable_free(table);
+}
@@ -32,6 +32,13 @@ SW_EXTERN_C_BEGIN
 #define SW_SSL_BUFFER      1
 #define SW_SSL_CLIENT      2
 
+/**
+ * kernel TLS offload, OpenSSL 3.0+ built with enable-ktls
+ */
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L && defined(SSL_OP_ENABLE_KTLS) && !defined(OPENSSL_NO_KTLS)
+#define SW_SSL_HAVE_KTLS   1
+#endif
+
 typedef struct _swSSL_option
 {
     char *cert_file;
@@ -49,6 +56,7 @@ typedef struct _swSSL_option
     uint8_t disable_compress :1;
     uint8_t verify_peer :1;
     uint8_t allow_self_signed :1;
+    uint8_t ktls :1;
     uint32_t disable_protocols;
 } swSSL_option;
 
@@ -93,6 +93,11 @@ public:
     ~Context();
     bool swap_in();
     bool swap_out();
+    /**
+     * run another function on the stack of an ended context
+     * @return false: the context can not be reused
+     */
+    bool reset(size_t stack_size, coroutine_func_t fn, void* private_data);
 #if defined(SW_USE_ASM_CONTEXT) && defined(SW_LOG_TRACE_OPEN)
     ssize_t get_stack_usage();
 #endif
@@ -24,11 +24,13 @@
 
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #define SW_CORO_STACK_ALIGNED_SIZE (4 * 1024)
 #define SW_CORO_MIN_STACK_SIZE     (256  * 1024)
 #define SW_CORO_MAX_STACK_SIZE     (16 * 1024 * 1024)
 #define SW_CORO_MAX_NUM_LIMIT      LONG_MAX
+#define SW_CORO_TABLE_INIT_SIZE    1024
 
 // TODO: remove it
 typedef enum
@@ -65,6 +67,88 @@ struct socket_poll_fd
     }
 };
 
+class Coroutine;
+
+/**
+ * cid => coroutine, open addressing with linear probing,
+ * the cids are sequential, so the live coroutines rarely share a slot
+ */
+class CoroutineTable
+{
+public:
+    class iterator
+    {
+    public:
+        iterator(const std::vector<Coroutine *> *_slots, size_t _index) :
+                slots(_slots), index(_index)
+        {
+            skip();
+        }
+
+        inline Coroutine* operator*() const
+        {
+            return (*slots)[index];
+        }
+
+        inline iterator& operator++()
+        {
+            index++;
+            skip();
+            return *this;
+        }
+
+        inline bool operator!=(const iterator &other) const
+        {
+            return index != other.index;
+        }
+
+        inline bool operator==(const iterator &other) const
+        {
+            return index == other.index;
+        }
+
+    private:
+        const std::vector<Coroutine *> *slots;
+        size_t index;
+
+        inline void skip()
+        {
+            while (index < slots->size() && (*slots)[index] == nullptr)
+            {
+                index++;
+            }
+        }
+    };
+
+    CoroutineTable() : slots(SW_CORO_TABLE_INIT_SIZE, nullptr), mask(SW_CORO_TABLE_INIT_SIZE - 1) { }
+
+    inline Coroutine* find(long cid) const;
+    void insert(long cid, Coroutine *co);
+    void erase(long cid);
+
+    inline size_t size() const
+    {
+        return count;
+    }
+
+    inline iterator begin() const
+    {
+        return iterator(&slots, 0);
+    }
+
+    inline iterator end() const
+    {
+        return iterator(&slots, slots.size());
+    }
+
+private:
+    std::vector<Coroutine *> slots;
+    size_t mask;
+    size_t count = 0;
+
+    void resize(size_t capacity);
+};
+
 class Coroutine
 {
 public:
@@ -109,16 +193,34 @@ public:
         task = _task;
     }
 
-    static std::unordered_map<long, Coroutine*> coroutines;
+    static CoroutineTable coroutines;
 
     static void set_on_yield(sw_coro_on_swap_t func);
     static void set_on_resume(sw_coro_on_swap_t func);
     static void set_on_close(sw_coro_on_swap_t func);
     static void bailout(sw_coro_bailout_t func);
 
+    /**
+     * the ended coroutines are kept with their stacks and reused by create()
+     */
     static inline long create(coroutine_func_t fn, void* args = nullptr)
     {
-        return (new Coroutine(fn, args))->run();
+        Coroutine *co;
+        if (sw_likely(!pool.empty()))
+        {
+            co = pool.back();
+            pool.pop_back();
+            if (sw_unlikely(!co->reuse(fn, args)))
+            {
+                delete co;
+                co = new Coroutine(fn, args);
+            }
+        }
+        else
+        {
+            co = new Coroutine(fn, args);
+        }
+        return co->run();
     }
 
     static inline Coroutine* get_current()
@@ -147,8 +249,7 @@ public:
 
     static inline Coroutine* get_by_cid(long cid)
     {
-        auto i = coroutines.find(cid);
-        return sw_likely(i != coroutines.end()) ? i->second : nullptr;
+        return coroutines.find(cid);
     }
 
     static inline void* get_task_by_cid(long cid)
@@ -167,6 +268,13 @@ public:
         stack_size = SW_MEM_ALIGNED_SIZE_EX(SW_MAX(SW_CORO_MIN_STACK_SIZE, SW_MIN(size, SW_CORO_MAX_STACK_SIZE)), SW_CORO_STACK_ALIGNED_SIZE);
     }
 
+    static inline size_t get_pool_size()
+    {
+        return pool_size;
+    }
+
+    static void set_pool_size(size_t size);
+
     static inline long get_last_cid()
     {
         return last_cid;
@@ -189,6 +297,8 @@ protected:
     static long last_cid;
     static uint64_t peak_num;
     static size_t stack_size;
+    static std::vector<Coroutine *> pool;
+    static size_t pool_size;
     static sw_coro_on_swap_t on_yield;   /* before yield */
     static sw_coro_on_swap_t on_resume;  /* before resume */
     static sw_coro_on_swap_t on_close;   /* before close */
@@ -202,15 +312,32 @@ protected:
 
     Coroutine(coroutine_func_t fn, void *private_data) :
             ctx(stack_size, fn, private_data)
+    {
+        init();
+    }
+
+    inline void init()
     {
         cid = ++last_cid;
-        coroutines[cid] = this;
+        coroutines.insert(cid, this);
         if (sw_unlikely(count() > peak_num))
         {
             peak_num = count();
         }
     }
 
+    inline bool reuse(coroutine_func_t fn, void *private_data)
+    {
+        if (!ctx.reset(stack_size, fn, private_data))
+        {
+            return false;
+        }
+        state = SW_CORO_INIT;
+        task = nullptr;
+        init();
+        return true;
+    }
+
     inline long run()
     {
         long cid = this->cid;
@@ -223,11 +350,18 @@ protected:
 
     inline void check_end()
     {
+        /**
+         * a coroutine swapped out by yield is the common case, it returns at once
+         */
+        if (sw_likely(!ctx.is_end() && !on_bailout))
+        {
+            return;
+        }
         if (ctx.is_end())
         {
             close();
         }
-        else if (sw_unlikely(on_bailout))
+        else
         {
             SW_ASSERT(current == nullptr);
             on_bailout();
@@ -238,6 +372,21 @@ protected:
 
     void close();
 };
+
+inline Coroutine* CoroutineTable::find(long cid) const
+{
+    size_t i = cid & mask;
+    Coroutine *co;
+    while ((co = slots[i]) != nullptr)
+    {
+        if (sw_likely(co->get_cid() == cid))
+        {
+            return co;
+        }
+        i = (i + 1) & mask;
+    }
+    return nullptr;
+}
 //-------------------------------------------------------------------------------
 namespace coroutine
 {
@@ -8,7 +8,8 @@
 #include <iostream>
 #include <string>
 #include <list>
-#include <queue>
+#include <vector>
+#include <unordered_map>
 
 namespace swoole { namespace coroutine {
 //-------------------------------------------------------------------------------
@@ -30,12 +31,49 @@ public:
         swTimer_node *timer;
     };
 
+    /**
+     * a push or pop operation waited by select, data is the element to push or the popped element
+     */
+    struct select_case_t
+    {
+        Channel *chan;
+        enum opcode type;
+        void *data;
+        /**
+         * set by select when the case was chosen because its channel was closed, nothing was pushed or popped,
+         * the channel may also be closed later by the coroutine which took the pushed data
+         */
+        bool closed;
+    };
+
+    struct select_msg_t
+    {
+        Channel *chan;
+        enum opcode type;
+        Coroutine *co;
+        bool error;
+        swTimer_node *timer;
+    };
+
     void* pop(double timeout = -1);
     bool push(void *data, double timeout = -1);
+    /**
+     * wait until the channel is not empty, then pop up to n elements, return the number of popped elements
+     */
+    size_t pop_many(void **items, size_t n, double timeout = -1);
+    /**
+     * wait until the channel is not full, then push up to n elements, return the number of pushed elements
+     */
+    size_t push_many(void **items, size_t n, double timeout = -1);
     bool close();
+    /**
+     * wait until one of the cases can be done, return its index or -1 on timeout,
+     * the returned case must be checked with its closed flag
+     */
+    static int select(std::vector<select_case_t> &cases, double timeout = -1);
 
     Channel(size_t _capacity = 1) :
-            capacity(_capacity)
+            capacity(_capacity), data_ring(SW_MIN(_capacity, SW_CHANNEL_RING_INIT_SIZE))
     {
     }
 
@@ -58,17 +96,22 @@ public:
 
     inline bool is_empty()
     {
-        return data_queue.size() == 0;
+        return data_count == 0;
     }
 
     inline bool is_full()
     {
-        return data_queue.size() == capacity;
+        return data_count == capacity;
     }
 
     inline size_t length()
     {
-        return data_queue.size();
+        return data_count;
+    }
+
+    inline size_t get_capacity()
+    {
+        return capacity;
     }
 
     inline size_t consumer_num()
@@ -83,13 +126,11 @@ public:
 
     inline void* pop_data()
     {
-        if (data_queue.size() == 0)
+        if (data_count == 0)
         {
             return nullptr;
         }
-        void *data = data_queue.front();
-        data_queue.pop();
-        return data;
+        return ring_pop();
     }
 
 protected:
@@ -97,9 +138,21 @@ protected:
     bool closed = false;
     std::list<Coroutine *> producer_queue;
     std::list<Coroutine *> consumer_queue;
-    std::queue<void *> data_queue;
+    /**
+     * ring of the elements, it starts small and doubles until it reaches the capacity,
+     * so a channel with a huge capacity costs nothing until it is filled
+     */
+    std::vector<void *> data_ring;
+    size_t data_head = 0;
+    size_t data_count = 0;
+
+    /**
+     * the coroutines waiting in select, they may be queued in several channels
+     */
+    static std::unordered_map<Coroutine *, select_msg_t *> selectors;
 
     static void timer_callback(swTimer *timer, swTimer_node *tnode);
+    static void select_timer_callback(swTimer *timer, swTimer_node *tnode);
 
     void yield(enum opcode type);
 
@@ -113,6 +166,74 @@ protected:
         producer_queue.remove(co);
     }
 
+    inline bool pop_ready()
+    {
+        return closed || (!is_empty() && consumer_queue.empty());
+    }
+
+    inline bool push_ready()
+    {
+        return closed || (!is_full() && producer_queue.empty());
+    }
+
+    inline void* ring_pop()
+    {
+        void *data = data_ring[data_head];
+        data_head = data_head + 1 == data_ring.size() ? 0 : data_head + 1;
+        data_count--;
+        return data;
+    }
+
+    inline void ring_push(void *data)
+    {
+        if (sw_unlikely(data_count == data_ring.size()))
+        {
+            ring_grow();
+        }
+        size_t tail = data_head + data_count;
+        if (tail >= data_ring.size())
+        {
+            tail -= data_ring.size();
+        }
+        data_ring[tail] = data;
+        data_count++;
+    }
+
+    void ring_grow();
+
+    /**
+     * wait in the queue of the given type, return false on timeout or close
+     */
+    bool wait(enum opcode type, double timeout);
+
+    inline void* do_pop()
+    {
+        void *data = ring_pop();
+        /**
+         * notify producer
+         */
+        if (!producer_queue.empty())
+        {
+            Coroutine *co = pop_coroutine(PRODUCER);
+            co->resume();
+        }
+        return data;
+    }
+
+    inline void do_push(void *data)
+    {
+        ring_push(data);
+        swTraceLog(SW_TRACE_CHANNEL, "push data to channel, count=%ld", length());
+        /**
+         * notify consumer
+         */
+        if (!consumer_queue.empty())
+        {
+            Coroutine *co = pop_coroutine(CONSUMER);
+            co->resume();
+        }
+    }
+
     inline Coroutine* pop_coroutine(enum opcode type)
     {
         Coroutine* co;
@@ -128,6 +249,15 @@ protected:
             consumer_queue.pop_front();
             swTraceLog(SW_TRACE_CHANNEL, "resume consumer cid=%ld", co->get_cid());
         }
+        if (sw_unlikely(!selectors.empty()))
+        {
+            auto i = selectors.find(co);
+            if (i != selectors.end())
+            {
+                i->second->chan = this;
+                i->second->type = type;
+            }
+        }
         return co;
     }
 };
@@ -0,0 +1,88 @@
+/*
+  +----------------------------------------------------------------------+
+  | Swoole                                                               |
+  +----------------------------------------------------------------------+
+  | This source file is subject to version 2.0 of the Apache license,    |
+  | that is bundled with this package in the file LICENSE, and is        |
+  | available through the world-wide-web at the following url:           |
+  | http://www.apache.org/licenses/LICENSE-2.0.html                      |
+  | If you did not receive a copy of the Apache2.0 license and are unable|
+  | to obtain it through the world-wide-web, please send a note to       |
+  | license@swoole.com so we can mail you a copy immediately.            |
+  +----------------------------------------------------------------------+
+  | Author: Tianfeng Han  <mikan.tenny@gmail.com>                        |
+  +----------------------------------------------------------------------+
+*/
+
+#pragma once
+
+#include "coroutine.h"
+
+#ifdef SW_USE_CURL
+#include <curl/curl.h>
+
+#include <unordered_map>
+#include <vector>
+
+namespace swoole { namespace coroutine {
+//-------------------------------------------------------------------------------
+/**
+ * drives the easy handles of all the coroutines of a thread with one curl_multi,
+ * its sockets and timer are registered in the reactor.
+ * The curl calls are always made by a waiting coroutine, so the callbacks of the handles never run in the scheduler
+ */
+class CurlMulti
+{
+public:
+    struct Handle
+    {
+        CURL *cp;
+        Coroutine *co;
+        /**
+         * yielded in exec(), may be resumed by an event
+         */
+        bool waiting;
+        bool done;
+        CURLcode result;
+        /**
+         * the socket events to be handled by this coroutine, fd => CURL_CSELECT_*
+         */
+        std::vector<std::pair<curl_socket_t, int>> actions;
+    };
+
+    /**
+     * run the transfer of the easy handle, the current coroutine is suspended until it is done
+     */
+    static CURLcode exec(CURL *cp);
+    static void init_reactor(swReactor *reactor);
+
+private:
+    CURLM *multi;
+    swReactor *reactor;
+    swTimer_node *timer = nullptr;
+    bool timeout = false;
+    std::unordered_map<CURL *, Handle *> handles;
+
+    /**
+     * one multi handle per thread, its sockets are added to the reactor of that thread
+     */
+    static thread_local CurlMulti *instance;
+
+    CurlMulti();
+    ~CurlMulti();
+    static CurlMulti* get();
+    static int handle_socket(CURL *cp, curl_socket_t fd, int action, void *userp, void *socketp);
+    static int handle_timer(CURLM *multi, long timeout_ms, void *userp);
+    static void on_timeout(swTimer *timer, swTimer_node *tnode);
+    static int on_event(swReactor *reactor, swEvent *event, int action);
+    static int on_read(swReactor *reactor, swEvent *event);
+    static int on_write(swReactor *reactor, swEvent *event);
+    static int on_error(swReactor *reactor, swEvent *event);
+
+    Handle* get_waiting_handle();
+    void notify(Handle *handle);
+    void run(Handle *handle);
+};
+//-------------------------------------------------------------------------------
+}}
+#endif
@@ -0,0 +1,80 @@
+/*
+ +----------------------------------------------------------------------+
+ | Swoole                                                               |
+ +----------------------------------------------------------------------+
+ | This source file is subject to version 2.0 of the Apache license,    |
+ | that is bundled with this package in the file LICENSE, and is        |
+ | available through the world-wide-web at the following url:           |
+ | http://www.apache.org/licenses/LICENSE-2.0.html                      |
+ | If you did not receive a copy of the Apache2.0 license and are unable|
+ | to obtain it through the world-wide-web, please send a note to       |
+ | license@swoole.com so we can mail you a copy immediately.            |
+ +----------------------------------------------------------------------+
+ | Author: Tianfeng Han  <mikan.tenny@gmail.com>                        |
+ +----------------------------------------------------------------------+
+ */
+
+#ifndef SW_COUNTER_H_
+#define SW_COUNTER_H_
+
+SW_EXTERN_C_BEGIN
+
+#define SW_COUNTER_SLOT_SIZE       64
+
+typedef struct _swCounter_slot
+{
+    sw_atomic_long_t value;
+    char padding[SW_COUNTER_SLOT_SIZE - sizeof(sw_atomic_long_t)];
+} swCounter_slot;
+
+/**
+ * a counter sharded over the slots of its own cache line,
+ * the processes (or the reactor threads) add to their slots and the reader aggregates them,
+ * can be placed in shared memory
+ */
+typedef struct _swCounter
+{
+    uint32_t slot_num;
+    swCounter_slot *slots;
+} swCounter;
+
+swCounter* swCounter_new(uint32_t slot_num, int shared);
+void swCounter_free(swCounter *counter, int shared);
+long swCounter_get(swCounter *counter);
+void swCounter_set(swCounter *counter, long value);
+
+/**
+ * the workers use the slots of their ids, the reactor threads of the master use the ones of the thread ids,
+ * the other processes (Swoole\Process, the scripts without a server) have no worker id, they use their pids
+ */
+static sw_inline uint32_t swCounter_get_slot_id(void)
+{
+    if (swIsMaster())
+    {
+        return SwooleTG.id;
+    }
+    if (SwooleWG.worker)
+    {
+        return SwooleWG.id;
+    }
+    return (uint32_t) SwooleG.pid;
+}
+
+static sw_inline swCounter_slot* swCounter_get_slot(swCounter *counter)
+{
+    return &counter->slots[swCounter_get_slot_id() % counter->slot_num];
+}
+
+static sw_inline long swCounter_add(swCounter *counter, long value)
+{
+    return sw_atomic_fetch_add(&swCounter_get_slot(counter)->value, value);
+}
+
+static sw_inline long swCounter_sub(swCounter *counter, long value)
+{
+    return sw_atomic_fetch_sub(&swCounter_get_slot(counter)->value, value);
+}
+
+SW_EXTERN_C_END
+
+#endif /* SW_COUNTER_H_ */
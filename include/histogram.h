@@ -0,0 +1,102 @@
+/*
+ +----------------------------------------------------------------------+
+ | Swoole                                                               |
+ +----------------------------------------------------------------------+
+ | This source file is subject to version 2.0 of the Apache license,    |
+ | that is bundled with this package in the file LICENSE, and is        |
+ | available through the world-wide-web at the following url:           |
+ | http://www.apache.org/licenses/LICENSE-2.0.html                      |
+ | If you did not receive a copy of the Apache2.0 license and are unable|
+ | to obtain it through the world-wide-web, please send a note to       |
+ | license@swoole.com so we can mail you a copy immediately.            |
+ +----------------------------------------------------------------------+
+ | Author: Tianfeng Han  <mikan.tenny@gmail.com>                        |
+ +----------------------------------------------------------------------+
+ */
+
+#ifndef SW_HISTOGRAM_H_
+#define SW_HISTOGRAM_H_
+
+SW_EXTERN_C_BEGIN
+
+/**
+ * log-linear buckets: every power of two is split into 2^SW_HISTOGRAM_SUB_BITS buckets,
+ * so the relative error of a recorded value is below 1/2^SW_HISTOGRAM_SUB_BITS
+ */
+#define SW_HISTOGRAM_SUB_BITS      4
+#define SW_HISTOGRAM_MAX_BITS      36
+#define SW_HISTOGRAM_BUCKET_NUM    ((SW_HISTOGRAM_MAX_BITS - SW_HISTOGRAM_SUB_BITS + 1) << SW_HISTOGRAM_SUB_BITS)
+
+#define SW_HISTOGRAM_ALIGN_SIZE    64
+
+/**
+ * lock-free, can be placed in shared memory and recorded by several processes,
+ * aligned to the cache line so the shards of a swShardedHistogram do not share one
+ */
+typedef struct _swHistogram
+{
+    sw_atomic_ulong_t count;
+    sw_atomic_ulong_t sum;
+    sw_atomic_ulong_t max;
+    sw_atomic_ulong_t buckets[SW_HISTOGRAM_BUCKET_NUM];
+} __attribute__((aligned(SW_HISTOGRAM_ALIGN_SIZE))) swHistogram;
+
+/**
+ * a histogram for each process (or reactor thread), they are recorded without contention and merged on read,
+ * can be placed in shared memory
+ */
+typedef struct _swShardedHistogram
+{
+    uint32_t shard_num;
+    swHistogram *shards;
+} swShardedHistogram;
+
+void swHistogram_record(swHistogram *histogram, uint64_t value);
+uint64_t swHistogram_percentile(swHistogram *histogram, double percentile);
+void swHistogram_reset(swHistogram *histogram);
+void swHistogram_merge(swHistogram *histogram, swHistogram *other);
+
+swShardedHistogram* swShardedHistogram_new(uint32_t shard_num, int shared);
+void swShardedHistogram_free(swShardedHistogram *histogram, int shared);
+void swShardedHistogram_get(swShardedHistogram *histogram, swHistogram *result);
+
+/**
+ * the workers use the shards of their ids, the reactor threads of the master use the ones of the thread ids
+ */
+static sw_inline swHistogram* swShardedHistogram_get_shard(swShardedHistogram *histogram, uint32_t id)
+{
+    return &histogram->shards[id % histogram->shard_num];
+}
+
+static sw_inline uint32_t swHistogram_get_index(uint64_t value)
+{
+    if (value < (1u << SW_HISTOGRAM_SUB_BITS))
+    {
+        return (uint32_t) value;
+    }
+    uint32_t msb = 63 - __builtin_clzll(value);
+    if (msb >= SW_HISTOGRAM_MAX_BITS)
+    {
+        return SW_HISTOGRAM_BUCKET_NUM - 1;
+    }
+    uint32_t shift = msb - SW_HISTOGRAM_SUB_BITS;
+    return ((shift + 1) << SW_HISTOGRAM_SUB_BITS) + ((value >> shift) & ((1u << SW_HISTOGRAM_SUB_BITS) - 1));
+}
+
+/**
+ * the highest value which is recorded into the bucket
+ */
+static sw_inline uint64_t swHistogram_get_value(uint32_t index)
+{
+    if (index < (1u << SW_HISTOGRAM_SUB_BITS))
+    {
+        return index;
+    }
+    uint32_t shift = (index >> SW_HISTOGRAM_SUB_BITS) - 1;
+    uint64_t sub = index & ((1u << SW_HISTOGRAM_SUB_BITS) - 1);
+    return (((1ull << SW_HISTOGRAM_SUB_BITS) + sub + 1) << shift) - 1;
+}
+
+SW_EXTERN_C_END
+
+#endif /* SW_HISTOGRAM_H_ */
@@ -102,8 +102,16 @@ typedef struct _swHttpRequest
     uint32_t url_length;
 
     uint32_t header_length;
-    uint32_t content_length;
+    uint64_t content_length;
+    /**
+     * the body is dispatched as it arrives (see http_body_stream), the number of bytes not received yet
+     */
+    uint64_t stream_remain;
     swString *buffer;
+    /**
+     * the buffer is a package buffer of this protocol
+     */
+    swProtocol *buffer_protocol;
 
 } swHttpRequest;
 
@@ -117,6 +125,7 @@ char* swHttp_url_encode(char const *str, size_t len);
 int swHttpRequest_get_protocol(swHttpRequest *request);
 int swHttpRequest_get_header_info(swHttpRequest *request);
 int swHttpRequest_get_header_length(swHttpRequest *request);
+uint32_t swHttpRequest_get_pipeline_length(swHttpRequest *request, uint32_t *request_num);
 void swHttpRequest_free(swConnection *conn);
 
 static inline void swHttpRequest_clean(swHttpRequest *request)
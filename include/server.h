@@ -20,6 +20,8 @@
 #include "swoole_api.h"
 #include "buffer.h"
 #include "connection.h"
+#include "histogram.h"
+#include "counter.h"
 
 SW_EXTERN_C_BEGIN
 
@@ -32,6 +34,7 @@ enum swServer_event_type
     SW_SERVER_EVENT_SEND_DATA,
     SW_SERVER_EVENT_SEND_FILE,
     SW_SERVER_EVENT_SNED_DGRAM,
+    SW_SERVER_EVENT_SEND_DGRAM_BATCH,
     //connection event
     SW_SERVER_EVENT_CLOSE,
     SW_SERVER_EVENT_CONNECT,
@@ -151,6 +154,10 @@ typedef struct _swListenPort
     uint8_t ssl;
     int port;
     int sock;
+    /**
+     * SO_REUSEPORT listen sockets indexed by reactor id, see swServer::reactor_accept
+     */
+    int *reactor_socks;
     pthread_t thread_id;
     char host[SW_HOST_MAXSIZE];
 
@@ -212,6 +219,18 @@ typedef struct _swListenPort
      */
     int kernel_socket_recv_buffer_size;
     int kernel_socket_send_buffer_size;
+    /**
+     * number of datagrams received with one recvmmsg call, 0 means recvfrom one by one
+     */
+    uint16_t dgram_recv_batch;
+    /**
+     * bytes reserved for every datagram of a recvmmsg batch, larger datagrams are dropped
+     */
+    uint32_t dgram_max_size;
+    /**
+     * UDP_GRO, the kernel coalesces the datagrams of a flow
+     */
+    uint8_t dgram_gro;
 
 #ifdef SW_USE_OPENSSL
     SSL_CTX *ssl_context;
@@ -317,8 +336,40 @@ typedef struct _swServerStats
     sw_atomic_t connection_num;
     sw_atomic_t tasking_num;
     sw_atomic_long_t accept_count;
-    sw_atomic_long_t close_count;
-    sw_atomic_long_t request_count;
+    /**
+     * datagrams queued by a deferred sendto and then failed to be sent by the flush
+     */
+    sw_atomic_long_t dgram_send_fail_count;
+    /**
+     * sharded, every reactor thread and worker adds to its own cache line
+     */
+    swCounter *close_count;
+    swCounter *request_count;
+    /**
+     * the histograms are sharded like the counters and merged by Server::stats()
+     */
+#ifdef SW_BUFFER_RECV_TIME
+    /**
+     * microseconds from receiving the data to a worker starting to handle it
+     */
+    swShardedHistogram *queue_time;
+    /**
+     * microseconds from a worker sending the response to the reactor writing it to the socket
+     */
+    swShardedHistogram *send_time;
+#endif
+    /**
+     * microseconds spent in the event callback, until it returns or the coroutine yields
+     */
+    swShardedHistogram *handler_time;
+    /**
+     * microseconds spent handling the events of one reactor iteration
+     */
+    swShardedHistogram *reactor_loop_time;
+    /**
+     * events returned by one reactor wait
+     */
+    swShardedHistogram *reactor_event_num;
 } swServerStats;
 
 typedef struct _swServerGS
@@ -339,6 +390,15 @@ typedef struct _swServerGS
 
 } swServerGS;
 
+/**
+ * fds of the active sessions, a closed session is replaced by the last one
+ */
+typedef struct _swConnectionIndex
+{
+    uint32_t count;
+    int fds[0];
+} swConnectionIndex;
+
 struct _swServer
 {
     /**
@@ -430,6 +490,14 @@ struct _swServer
      * parse multipart/form-data files to match $_FILES
      */
     uint32_t http_parse_files :1;
+    /**
+     * dispatch the pipelined requests found in one read to the worker together
+     */
+    uint32_t http_pipeline_batch :1;
+    /**
+     * dispatch the body larger than package_max_length to the worker as it arrives instead of rejecting it
+     */
+    uint32_t http_body_stream :1;
     /**
      * http content compression
      */
@@ -474,6 +542,14 @@ struct _swServer
      * disable multi-threads
      */
     uint32_t single_thread :1;
+    /**
+     * each reactor thread accepts connections on its own SO_REUSEPORT socket
+     */
+    uint32_t reactor_accept :1;
+    /**
+     * steer the new connections to the reactor thread on the receiving CPU
+     */
+    uint32_t reactor_accept_cbpf :1;
     /**
      * server status
      */
@@ -497,7 +573,6 @@ struct _swServer
     long timezone;
     swTimer_node *master_timer;
     swTimer_node *heartbeat_timer;
-    swTimer_node *enable_accept_timer;
 
     /* buffer output/input setting*/
     uint32_t buffer_output_size;
@@ -544,6 +619,8 @@ struct _swServer
 #endif
 
     swConnection *connection_list;
+    swConnectionCold *connection_cold_list;
+    swConnectionIndex *connection_index;
     swSession *session_list;
 
     /**
@@ -559,6 +636,18 @@ struct _swServer
      */
     char *document_root;
     uint16_t document_root_len;
+    /**
+     * cache the static file metadata for seconds, 0 means disabled
+     */
+    uint32_t static_handler_cache_ttl;
+    /**
+     * the content of the cached static file which is not larger than this size is kept in memory
+     */
+    uint32_t static_handler_cache_max_file_size;
+    /**
+     * serve the .gz/.br sidecar file if the client accepts the encoding
+     */
+    uint8_t static_handler_precompressed;
     /**
      * master process pid
      */
@@ -673,6 +762,7 @@ static sw_inline int swEventData_is_dgram(uint8_t type)
     switch (type)
     {
     case SW_SERVER_EVENT_SNED_DGRAM:
+    case SW_SERVER_EVENT_SEND_DGRAM_BATCH:
         return SW_TRUE;
     default:
         return SW_FALSE;
@@ -773,6 +863,32 @@ static sw_inline swConnection* swServer_connection_get(swServer *serv, int fd)
     }
 }
 
+static sw_inline swConnectionCold* swServer_connection_cold(swServer *serv, int fd)
+{
+    return &serv->connection_cold_list[fd];
+}
+
+/**
+ * must be called with swServer_lock held
+ */
+static sw_inline void swServer_connection_index_add(swServer *serv, swConnection *conn)
+{
+    swConnectionIndex *index = serv->connection_index;
+    conn->index = index->count;
+    index->fds[index->count++] = conn->fd;
+}
+
+/**
+ * must be called with swServer_lock held
+ */
+static sw_inline void swServer_connection_index_remove(swServer *serv, swConnection *conn)
+{
+    swConnectionIndex *index = serv->connection_index;
+    int last_fd = index->fds[--index->count];
+    index->fds[conn->index] = last_fd;
+    serv->connection_list[last_fd].index = conn->index;
+}
+
 static sw_inline swSession* swServer_get_session(swServer *serv, uint32_t session_id)
 {
     return &serv->session_list[session_id % SW_SESSION_LIST_SIZE];
@@ -843,17 +959,17 @@ static sw_inline int swServer_worker_schedule(swServer *serv, int fd, swSendData
         //IPv4
         else if (conn->socket_type == SW_SOCK_TCP)
         {
-            key = conn->info.addr.inet_v4.sin_addr.s_addr;
+            key = conn->cold->info.addr.inet_v4.sin_addr.s_addr;
         }
         //IPv6
         else
         {
 #ifdef HAVE_KQUEUE
-            key = *(((uint32_t *) &conn->info.addr.inet_v6.sin6_addr) + 3);
+            key = *(((uint32_t *) &conn->cold->info.addr.inet_v6.sin6_addr) + 3);
 #elif defined(_WIN32)
-            key = conn->info.addr.inet_v6.sin6_addr.u.Word[3];
+            key = conn->cold->info.addr.inet_v6.sin6_addr.u.Word[3];
 #else
-            key = conn->info.addr.inet_v6.sin6_addr.s6_addr32[3];
+            key = conn->cold->info.addr.inet_v6.sin6_addr.s6_addr32[3];
 #endif
         }
     }
@@ -1051,16 +1167,20 @@ int swWorker_loop(swServer *serv, int worker_pti);
 void swWorker_clean_pipe_buffer(swServer *serv);
 int swWorker_send2reactor(swServer *serv, swEventData *ev_data, size_t sendn, int session_id);
 int swWorker_send2worker(swWorker *dst_worker, const void *buf, int n, int flag);
+ssize_t swWorker_udp_sendto(swServer *serv, int server_sock, const char *ip, int port, const char *data, size_t length, int ipv6);
 void swWorker_signal_handler(int signo);
 void swWorker_signal_init(void);
 
 int swReactorThread_create(swServer *serv);
 int swReactorThread_start(swServer *serv);
+int swReactorThread_reuse_port_init(swServer *serv);
 void swReactorThread_set_protocol(swServer *serv, swReactor *reactor);
 void swReactorThread_join(swServer *serv);
 void swReactorThread_free(swServer *serv);
 int swReactorThread_close(swReactor *reactor, int fd);
 int swReactorThread_dispatch(swProtocol *proto, swSocket *_socket, char *data, uint32_t length);
+int swReactorThread_dispatch_batch(swProtocol *proto, swSocket *_socket, char *data, uint32_t length);
+int swReactorThread_dispatch_stream(swProtocol *proto, swSocket *_socket, char *data, uint32_t length, int begin);
 int swReactorThread_send2worker(swServer *serv, swWorker *worker, void *data, int len);
 
 int swReactorProcess_create(swServer *serv);
@@ -21,13 +21,36 @@
 #include "mime_types.h"
 
 #include <string>
+#include <memory>
 
 namespace swoole { namespace http {
 
+/**
+ * the metadata of a static file, cached per thread for static_handler_cache_ttl seconds
+ */
+struct StaticFile
+{
+    std::string filename;
+    struct stat file_stat;
+    std::string mime_type;
+    std::string etag;
+    std::string last_modified;
+    /**
+     * the content of the small file, it will be sent with the header in one packet
+     */
+    std::string content;
+    /**
+     * the size of the precompressed sidecar file (.gz/.br), -1 if not exists
+     */
+    off_t gzip_size;
+    off_t br_size;
+};
+
 class StaticHandler
 {
 private:
     swServer *serv;
+    std::shared_ptr<StaticFile> file;
     std::string request_url;
     struct
     {
@@ -54,6 +77,10 @@ public:
     }
     bool hit();
     bool is_modified(const std::string &date_if_modified_since);
+    bool match_etag(const std::string &if_none_match, const std::string &etag);
+    std::string get_etag(const char *content_encoding);
+    const StaticFile* get_file();
+    bool set_precompressed_file(const char *ext, size_t l_ext, off_t size);
 
     std::string get_date();
 
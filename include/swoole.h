@@ -371,6 +371,14 @@ enum swFd_type
      * c-ares
      */
     SW_FD_ARES,
+    /**
+     * coroutine lock [swCoroLock]
+     */
+    SW_FD_CORO_LOCK,
+    /**
+     * socket of libcurl [coroutine::CurlMulti]
+     */
+    SW_FD_CURL,
     /**
      * SW_FD_USER or SW_FD_USER+n: for custom event
      */
@@ -682,6 +690,7 @@ typedef struct _swSocket
     uint8_t ssl_want_write :1;
     uint8_t ssl_renegotiation :1;
     uint8_t ssl_handshake_buffer_set :1;
+    uint8_t ssl_ktls_send :1;
 #endif
     uint8_t dontwait :1;
     uint8_t close_wait :1;
@@ -691,6 +700,7 @@ typedef struct _swSocket
     uint8_t tcp_nodelay :1;
     uint8_t skip_recv :1;
     uint8_t recv_wait :1;
+    uint8_t recv_package_buffer :1;
 
     /**
      * memory buffer size;
@@ -717,6 +727,26 @@ typedef struct _swSocket
 
 } swSocket;
 
+/**
+ * the rarely accessed part of a connection, kept in a separate table indexed by fd,
+ * so that the connection table stays small and its pages are only touched for used fds
+ */
+typedef struct _swConnectionCold
+{
+    /**
+     * socket address
+     */
+    swSocketAddress info;
+    /**
+     * unfinished data frame
+     */
+    swString *websocket_buffer;
+#ifdef SW_USE_OPENSSL
+    swString *ssl_client_cert;
+    uint16_t ssl_client_cert_pid;
+#endif
+} swConnectionCold;
+
 typedef struct _swConnection
 {
     /**
@@ -783,9 +813,9 @@ typedef struct _swConnection
      */
     sw_atomic_t server_fd;
     /**
-     * socket address
+     * position in the index of the active connections
      */
-    swSocketAddress info;
+    uint32_t index;
     /**
      * link any thing, for kernel, do not use with application.
      */
@@ -819,14 +849,9 @@ typedef struct _swConnection
      */
     uint8_t websocket_status;
     /**
-     * unfinished data frame
+     * address and buffers
      */
-    swString *websocket_buffer;
-
-#ifdef SW_USE_OPENSSL
-    swString *ssl_client_cert;
-    uint16_t ssl_client_cert_pid;
-#endif
+    swConnectionCold *cold;
     sw_atomic_t lock;
 
 } swConnection;
@@ -851,6 +876,12 @@ typedef struct _swProtocol
     int (*onPackage)(struct _swProtocol *, swSocket *, char *, uint32_t);
     ssize_t (*get_package_length)(struct _swProtocol *, swSocket *, char *, uint32_t);
     uint8_t (*get_package_length_size)(swSocket *);
+    /**
+     * optional, creates the buffer of a package which does not fit into the receive buffer,
+     * onPackage may keep a reference to its memory instead of copying the package
+     */
+    swString* (*package_buffer_new)(struct _swProtocol *, size_t);
+    void (*package_buffer_free)(struct _swProtocol *, swString *);
 } swProtocol;
 
 typedef ssize_t (*swProtocol_length_function)(struct _swProtocol *, swSocket *, char *, uint32_t);
@@ -962,6 +993,19 @@ enum _swEventData_flag
     SW_EVENT_DATA_PTR = 1u << 1,
     SW_EVENT_DATA_CHUNK = 1u << 2,
     SW_EVENT_DATA_END = 1u << 3,
+    /**
+     * the data pointer is the body of a package buffer (see swProtocol.package_buffer_new)
+     */
+    SW_EVENT_DATA_OBJ_PTR = 1u << 4,
+    /**
+     * the data holds several pipelined http requests without body (see swHttpRequest_get_pipeline_length)
+     */
+    SW_EVENT_DATA_BATCH = 1u << 5,
+    /**
+     * the header of an http request whose body is dispatched in the following SW_EVENT_DATA_STREAM_BODY messages
+     */
+    SW_EVENT_DATA_STREAM_BEGIN = 1u << 6,
+    SW_EVENT_DATA_STREAM_BODY = 1u << 7,
 };
 
 typedef struct _swDataHead
@@ -1091,6 +1135,7 @@ enum SW_LOCKS
     SW_SEM = 4,
     SW_SPINLOCK = 5,
     SW_ATOMLOCK = 6,
+    SW_COROLOCK = 7,
 };
 
 enum swDNSLookup_cache_type
@@ -1150,6 +1195,22 @@ typedef struct _swSem
 } swSem;
 #endif
 
+/**
+ * coroutine lock, the waiters are parked instead of blocking the process
+ */
+typedef struct _swCoroLock
+{
+    sw_atomic_t lock_t;
+    /**
+     * number of the parked coroutines in all processes
+     */
+    sw_atomic_t waiters;
+    /**
+     * eventfd in semaphore mode, one token is posted for each unlock while there are waiters
+     */
+    int event_fd;
+} swCoroLock;
+
 typedef struct _swLock
 {
     int type;
@@ -1165,6 +1226,7 @@ typedef struct _swLock
         swFileLock filelock;
         swSem sem;
         swAtomicLock atomlock;
+        swCoroLock corolock;
     } object;
 
     int (*lock_rd)(struct _swLock *);
@@ -1260,6 +1322,13 @@ typedef struct _swFixedPool
  */
 swMemoryPool* swFixedPool_new(uint32_t slice_num, uint32_t slice_size, uint8_t shared);
 swMemoryPool* swFixedPool_new2(uint32_t slice_size, void *memory, size_t size);
+swMemoryPool* swFixedPool_attach(void *memory);
+void swFixedPool_relink(swMemoryPool *pool);
+
+static inline swFixedPool_slice* swFixedPool_get_slice(swFixedPool *object, uint32_t index)
+{
+    return (swFixedPool_slice *) ((char *) object->memory + (sizeof(swFixedPool_slice) + object->slice_size) * index);
+}
 swMemoryPool* swMalloc_new();
 
 /**
@@ -1297,6 +1366,10 @@ int swAtomicLock_create(swLock *object, int spin);
 
 int swMutex_create(swLock *lock, int use_in_process);
 int swMutex_lockwait(swLock *lock, int timeout_msec);
+#ifdef HAVE_EVENTFD
+int swCoroLock_create(swLock *lock);
+int swCoroLock_lockwait(swLock *lock, double timeout);
+#endif
 int swCond_create(swCond *cond);
 
 typedef struct _swThreadParam
@@ -1333,6 +1406,7 @@ int swLog_init(char *logfile);
 void swLog_put(int level, char *content, size_t length);
 void swLog_reopen(enum swBool_type redirect);
 void swLog_free(void);
+void swLog_flush(void);
 
 //----------------------Tool Function---------------------
 uint64_t swoole_hash_key(char *str, int str_len);
@@ -1705,6 +1779,12 @@ struct _swReactor
     swDefer_callback idle_task;
     swDefer_callback future_task;
 
+    /**
+     * optional, records the duration (microseconds) and the number of events of each iteration
+     */
+    struct _swHistogram *loop_time;
+    struct _swHistogram *loop_event_num;
+
     void (*onTimeout)(swReactor *);
     void (*onFinish)(swReactor *);
     void (*onBegin)(swReactor *);
@@ -1771,6 +1851,14 @@ struct _swWorker
 
     long dispatch_count;
     long request_count;
+    /**
+     * microseconds spent in the event callbacks
+     */
+    long handler_time;
+    /**
+     * coroutines of the worker, sampled after each event
+     */
+    uint32_t coroutine_num;
 
     /**
      * worker id
@@ -2206,6 +2294,7 @@ int swThreadPool_free(swThreadPool *pool);
 ssize_t swProtocol_get_package_length(swProtocol *protocol, swSocket *conn, char *data, uint32_t size);
 int swProtocol_recv_check_length(swProtocol *protocol, swSocket *conn, swString *buffer);
 int swProtocol_recv_check_eof(swProtocol *protocol, swSocket *conn, swString *buffer);
+swString* swProtocol_package_buffer_new(swProtocol *protocol, swString *buffer, size_t size);
 
 //--------------------------------timer------------------------------
 #define SW_TIMER_MIN_MS  1
@@ -2380,6 +2469,10 @@ typedef struct
     uint32_t log_level;
     char *log_file;
     uint32_t trace_flags;
+    /**
+     * the lines are buffered per thread and written in batches by a writer thread of each process
+     */
+    uint8_t log_async;
 
     void (*write_log)(int level, char *content, size_t len);
     void (*fatal_error)(int code, const char *str, ...);
@@ -62,6 +62,9 @@
 #define SW_HOST_MAXSIZE            sizeof(((struct sockaddr_un *)NULL)->sun_path)  // Linux has 108 UNIX_PATH_MAX, but BSD/MacOS limit is only 104
 
 #define SW_LOG_NO_SRCINFO          1 // no source info
+#define SW_LOG_ASYNC_BUFFER_SIZE   (128*1024) // per thread, must be a power of 2
+#define SW_LOG_ASYNC_INTERVAL      10 // ms, the writer sleeps when all the buffers are empty
+#define SW_LOG_ASYNC_BATCH         32 // buffers written by one writev
 #define SW_CLIENT_BUFFER_SIZE      65536
 #define SW_CLIENT_CONNECT_TIMEOUT  0.5
 #define SW_CLIENT_MAX_PORT         65535
@@ -79,6 +82,10 @@
 #define SW_BUFFER_SIZE_STD         8192
 #define SW_BUFFER_SIZE_BIG         65536
 #define SW_BUFFER_SIZE_UDP         65536
+/**
+ * keep the receive time in swDataHead for Server::getReceivedTime() and the queue_time/send_time stats,
+ * it costs 8 bytes in every message between the reactors and the workers
+ */
 // #define SW_BUFFER_RECV_TIME
 
 #define SW_SENDFILE_CHUNK_SIZE     65536
@@ -151,6 +158,10 @@
  * max accept times for single time
  */
 #define SW_ACCEPT_MAX_COUNT              64
+/**
+ * max vector length of recvmmsg/sendmmsg (UIO_MAXIOV)
+ */
+#define SW_DGRAM_BATCH_MAX               1024
 #define SW_ACCEPT_RETRY_TIME             1.0
 
 #define SW_TCP_KEEPCOUNT                 5
@@ -166,6 +177,7 @@
 
 #define SW_TABLE_CONFLICT_PROPORTION     0.2 // 20%
 #define SW_TABLE_KEY_SIZE                64
+#define SW_TABLE_SWEEP_BUCKETS           4096 // buckets checked for the expired rows on every manager tick
 
 #define SW_SSL_BUFFER_SIZE               16384
 #define SW_SSL_CIPHER_LIST               "EECDH+AESGCM:EDH+AESGCM:AES256+EECDH:AES256+EDH"
@@ -208,6 +220,8 @@
 #define SW_HTTP_ASCTIME_DATE             "%a %b %e %T %Y"
 // #define SW_HTTP_100_CONTINUE
 #define SW_HTTP_SEND_TWICE               1
+#define SW_HTTP_STATIC_CACHE_CAPACITY    1024
+#define SW_HTTP_PIPELINE_BATCH_MAX       64
 
 #define SW_HTTP_BAD_REQUEST_PACKET         "HTTP/1.1 400 Bad Request\r\n\r\n"
 #define SW_HTTP_SERVICE_UNAVAILABLE_PACKET "HTTP/1.1 503 Service Unavailable\r\n\r\n"
@@ -226,6 +240,8 @@
 #define SW_HTTP2_DEFAULT_WINDOW_SIZE           65535
 #define SW_HTTP2_DEFAULT_MAX_HEADER_LIST_SIZE  (1 << 12)
 #define SW_HTTP2_MAX_MAX_HEADER_LIST_SIZE      UINT32_MAX
+#define SW_HTTP2_CLIENT_HEADER_TABLE_SIZE      (1 << 16)
+#define SW_HTTP2_CLIENT_WINDOW_SIZE            SW_HTTP2_MAX_WINDOW_SIZE
 
 #define SW_HTTP_CLIENT_USERAGENT             "swoole-http-client"
 #define SW_HTTP_CLIENT_BOUNDARY_PREKEY       "----SwooleBoundary"
@@ -256,8 +272,10 @@
  * Coroutine
  */
 #define SW_DEFAULT_C_STACK_SIZE          (2 *1024 * 1024)
+#define SW_DEFAULT_CORO_POOL_SIZE        128
 #define SW_CORO_SUPPORT_BAILOUT          1
 #define SW_CORO_SWAP_BAILOUT             1
+#define SW_CHANNEL_RING_INIT_SIZE        16
 
 #ifdef SW_DEBUG
 #ifndef SW_LOG_TRACE_OPEN
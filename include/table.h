@@ -29,10 +29,23 @@ typedef struct _swTableRow
 {
     sw_atomic_t lock;
     pid_t lock_pid;
+    /**
+     * odd while the rows of the slot are being changed,
+     * a slot left odd by a crashed writer is discarded when a table file is attached
+     */
+    uint32_t version;
     /**
      * 1:used, 0:empty
      */
     uint8_t active;
+    /**
+     * CLOCK reference bit, set on every access and cleared when the eviction hand passes the row
+     */
+    uint8_t accessed;
+    /**
+     * unix time when the row expires, 0:never
+     */
+    uint32_t expire;
     /**
      * next slot
      */
@@ -73,8 +86,67 @@ typedef struct
     swTable_iterator *iterator;
 
     void *memory;
+
+    /**
+     * the memory is mapped from this file and kept across restarts
+     */
+    char *file;
+    /**
+     * holds LOCK_EX on the file for the lifetime of the mapping, the rows store absolute pointers
+     * and are rebased on attach, so only one process tree may map the file at a time
+     */
+    int file_fd;
+    swShareMemory shm;
+    /**
+     * the columns, checked when the file is attached again
+     */
+    swString *schema;
+    /**
+     * the rows were restored from the file
+     */
+    uint8_t attached;
+
+    /**
+     * SW_TABLE_EVICT_NONE or SW_TABLE_EVICT_LRU, shared by all processes
+     */
+    uint8_t evict_policy;
+    /**
+     * some rows were set with an expiry time, the table is swept in the background
+     */
+    uint8_t expirable;
+    /**
+     * the bucket checked next by the eviction hand
+     */
+    sw_atomic_t clock_hand;
+    /**
+     * the bucket checked next by the background sweep
+     */
+    sw_atomic_t sweep_index;
+    /**
+     * rows removed by the eviction
+     */
+    sw_atomic_long_t evict_num;
 } swTable;
 
+#define SW_TABLE_FILE_MAGIC     0x54575357
+#define SW_TABLE_FILE_VERSION   1
+
+typedef struct
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t row_header_size;
+    uint32_t schema_length;
+    uint64_t size;
+    uint64_t item_size;
+    uint64_t memory_size;
+    /**
+     * address of the table memory in the last mapping, the pointers in the rows are relative to it
+     */
+    uint64_t base;
+    char schema[0];
+} swTableFileHeader;
+
 typedef struct
 {
    uint8_t type;
@@ -96,6 +168,12 @@ enum swoole_table_type
     SW_TABLE_STRING,
 };
 
+enum swoole_table_evict_policy
+{
+    SW_TABLE_EVICT_NONE = 0,
+    SW_TABLE_EVICT_LRU,
+};
+
 enum swoole_table_find
 {
     SW_TABLE_FIND_EQ = 1,
@@ -110,6 +188,7 @@ enum swoole_table_find
 swTable* swTable_new(uint32_t rows_size, float conflict_proportion);
 size_t swTable_get_memory_size(swTable *table);
 int swTable_create(swTable *table);
+int swTable_set_file(swTable *table, const char *file);
 void swTable_free(swTable *table);
 int swTableColumn_add(swTable *table, const char *name, int len, int type, int size);
 swTableRow* swTableRow_set(swTable *table, const char *key, int keylen, swTableRow **rowlock);
@@ -119,6 +198,7 @@ void swTable_iterator_rewind(swTable *table);
 swTableRow* swTable_iterator_current(swTable *table);
 void swTable_iterator_forward(swTable *table);
 int swTableRow_del(swTable *table, char *key, int keylen);
+uint32_t swTable_sweep(swTable *table, uint32_t bucket_num);
 
 static sw_inline swTableColumn* swTableColumn_get(swTable *table, char *column_key, int keylen)
 {
@@ -159,8 +239,45 @@ static sw_inline void swTableRow_lock(swTableRow *row)
     }
 }
 
+static sw_inline int swTableRow_trylock(swTableRow *row)
+{
+    if (row->lock == 0 && sw_atomic_cmp_set(&row->lock, 0, 1))
+    {
+        row->lock_pid = SwooleG.pid;
+        return 1;
+    }
+    return 0;
+}
+
+static sw_inline int swTableRow_is_expired(swTableRow *row, time_t now)
+{
+    return row->expire != 0 && row->expire <= now;
+}
+
+/**
+ * the expiry time is a 32-bit timestamp, a ttl beyond it is clamped to the largest one
+ */
+static sw_inline void swTableRow_set_expire(swTable *table, swTableRow *row, uint64_t ttl)
+{
+    if (ttl == 0)
+    {
+        row->expire = 0;
+        return;
+    }
+    uint64_t expire = (uint64_t) time(NULL) + ttl;
+    row->expire = expire > UINT32_MAX ? UINT32_MAX : (uint32_t) expire;
+    if (!table->expirable)
+    {
+        table->expirable = 1;
+    }
+}
+
 static sw_inline void swTableRow_unlock(swTableRow *row)
 {
+    if (row->version & 1)
+    {
+        row->version++;
+    }
     sw_spinlock_release(&row->lock);
 }
 
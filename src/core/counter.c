@@ -0,0 +1,78 @@
+/*
+ +----------------------------------------------------------------------+
+ | Swoole                                                               |
+ +----------------------------------------------------------------------+
+ | This source file is subject to version 2.0 of the Apache license,    |
+ | that is bundled with this package in the file LICENSE, and is        |
+ | available through the world-wide-web at the following url:           |
+ | http://www.apache.org/licenses/LICENSE-2.0.html                      |
+ | If you did not receive a copy of the Apache2.0 license and are unable|
+ | to obtain it through the world-wide-web, please send a note to       |
+ | license@swoole.com so we can mail you a copy immediately.            |
+ +----------------------------------------------------------------------+
+ | Author: Tianfeng Han  <mikan.tenny@gmail.com>                        |
+ +----------------------------------------------------------------------+
+ */
+
+#include "swoole.h"
+#include "counter.h"
+
+/**
+ * @param slot_num: 0 means one slot per CPU
+ */
+swCounter* swCounter_new(uint32_t slot_num, int shared)
+{
+    if (slot_num == 0)
+    {
+        slot_num = SW_CPU_NUM;
+    }
+    // one more slot to align them to the cache line
+    size_t size = sizeof(swCounter) + (slot_num + 1) * sizeof(swCounter_slot);
+    swCounter *counter = (swCounter *) (shared ? sw_shm_calloc(1, size) : sw_calloc(1, size));
+    if (counter == NULL)
+    {
+        swWarn("malloc(%zu) failed", size);
+        return NULL;
+    }
+    counter->slot_num = slot_num;
+    counter->slots = (swCounter_slot *) SW_MEM_ALIGNED_SIZE_EX((uintptr_t) (counter + 1), SW_COUNTER_SLOT_SIZE);
+    return counter;
+}
+
+void swCounter_free(swCounter *counter, int shared)
+{
+    if (shared)
+    {
+        sw_shm_free(counter);
+    }
+    else
+    {
+        sw_free(counter);
+    }
+}
+
+long swCounter_get(swCounter *counter)
+{
+    long value = 0;
+    uint32_t i;
+
+    for (i = 0; i < counter->slot_num; i++)
+    {
+        value += counter->slots[i].value;
+    }
+    return value;
+}
+
+/**
+ * not atomic against the concurrent adds, it is meant for the reset
+ */
+void swCounter_set(swCounter *counter, long value)
+{
+    uint32_t i;
+
+    counter->slots[0].value = value;
+    for (i = 1; i < counter->slot_num; i++)
+    {
+        counter->slots[i].value = 0;
+    }
+}
@@ -0,0 +1,139 @@
+/*
+ +----------------------------------------------------------------------+
+ | Swoole                                                               |
+ +----------------------------------------------------------------------+
+ | This source file is subject to version 2.0 of the Apache license,    |
+ | that is bundled with this package in the file LICENSE, and is        |
+ | available through the world-wide-web at the following url:           |
+ | http://www.apache.org/licenses/LICENSE-2.0.html                      |
+ | If you did not receive a copy of the Apache2.0 license and are unable|
+ | to obtain it through the world-wide-web, please send a note to       |
+ | license@swoole.com so we can mail you a copy immediately.            |
+ +----------------------------------------------------------------------+
+ | Author: Tianfeng Han  <mikan.tenny@gmail.com>                        |
+ +----------------------------------------------------------------------+
+ */
+
+#include "swoole.h"
+#include "histogram.h"
+
+void swHistogram_record(swHistogram *histogram, uint64_t value)
+{
+    sw_atomic_fetch_add(&histogram->buckets[swHistogram_get_index(value)], 1);
+    sw_atomic_fetch_add(&histogram->count, 1);
+    sw_atomic_fetch_add(&histogram->sum, value);
+
+    uint64_t max = histogram->max;
+    while (value > max)
+    {
+        if (sw_atomic_cmp_set(&histogram->max, max, value))
+        {
+            break;
+        }
+        max = histogram->max;
+    }
+}
+
+/**
+ * @param percentile: 0 - 100
+ */
+uint64_t swHistogram_percentile(swHistogram *histogram, double percentile)
+{
+    uint64_t total = 0;
+    uint32_t i;
+
+    for (i = 0; i < SW_HISTOGRAM_BUCKET_NUM; i++)
+    {
+        total += histogram->buckets[i];
+    }
+    if (total == 0)
+    {
+        return 0;
+    }
+
+    uint64_t rank = (uint64_t) (total * percentile / 100 + 0.5);
+    if (rank == 0)
+    {
+        rank = 1;
+    }
+    uint64_t n = 0;
+    for (i = 0; i < SW_HISTOGRAM_BUCKET_NUM; i++)
+    {
+        n += histogram->buckets[i];
+        if (n >= rank)
+        {
+            uint64_t value = swHistogram_get_value(i);
+            return value < histogram->max ? value : histogram->max;
+        }
+    }
+    return histogram->max;
+}
+
+void swHistogram_reset(swHistogram *histogram)
+{
+    bzero(histogram, sizeof(swHistogram));
+}
+
+/**
+ * add the values of the other one, which may still be recorded concurrently
+ */
+void swHistogram_merge(swHistogram *histogram, swHistogram *other)
+{
+    uint32_t i;
+
+    for (i = 0; i < SW_HISTOGRAM_BUCKET_NUM; i++)
+    {
+        histogram->buckets[i] += other->buckets[i];
+    }
+    histogram->count += other->count;
+    histogram->sum += other->sum;
+    if (other->max > histogram->max)
+    {
+        histogram->max = other->max;
+    }
+}
+
+swShardedHistogram* swShardedHistogram_new(uint32_t shard_num, int shared)
+{
+    if (shard_num == 0)
+    {
+        shard_num = 1;
+    }
+    // one more shard to align them to the cache line
+    size_t size = sizeof(swShardedHistogram) + (shard_num + 1) * sizeof(swHistogram);
+    swShardedHistogram *histogram = (swShardedHistogram *) (shared ? sw_shm_calloc(1, size) : sw_calloc(1, size));
+    if (histogram == NULL)
+    {
+        swWarn("malloc(%zu) failed", size);
+        return NULL;
+    }
+    histogram->shard_num = shard_num;
+    histogram->shards = (swHistogram *) SW_MEM_ALIGNED_SIZE_EX((uintptr_t) (histogram + 1), SW_HISTOGRAM_ALIGN_SIZE);
+    return histogram;
+}
+
+void swShardedHistogram_free(swShardedHistogram *histogram, int shared)
+{
+    if (shared)
+    {
+        sw_shm_free(histogram);
+    }
+    else
+    {
+        sw_free(histogram);
+    }
+}
+
+/**
+ * merge the shards into the result
+ */
+void swShardedHistogram_get(swShardedHistogram *histogram, swHistogram *result)
+{
+    uint32_t i;
+
+    swHistogram_reset(result);
+    for (i = 0; i < histogram->shard_num; i++)
+    {
+        swHistogram_merge(result, &histogram->shards[i]);
+    }
+}
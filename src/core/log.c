@@ -17,34 +17,106 @@
 #include "swoole.h"
 
 #include <sys/file.h>
+#include <sys/uio.h>
+#include <pthread.h>
+#include "hash.h"
 
 #define SW_LOG_BUFFER_SIZE  (SW_ERROR_MSG_SIZE+256)
 #define SW_LOG_DATE_STRLEN  64
 
 static int is_file = SW_FALSE;
 
+/**
+ * async mode: the lines are appended to a ring buffer of the calling thread (single producer)
+ * and written out in batches by the writer thread of the process (single consumer)
+ */
+typedef struct _swLogBuffer
+{
+    char *data;
+    uint32_t size;
+    /**
+     * read by the owner thread, moved by the writer
+     */
+    uint32_t head;
+    /**
+     * read by the writer, moved by the owner thread
+     */
+    uint32_t tail;
+    /**
+     * lines dropped since the buffer was full, the writer reports the difference
+     */
+    uint64_t dropped;
+    uint64_t dropped_reported;
+    /**
+     * the repeated lines are counted instead of written within the same second,
+     * the count is written by the owner on the next line or by the writer on the drain
+     */
+    uint64_t last_hash;
+    time_t last_time;
+    /**
+     * the tail after the repeated line in the high 32 bits and the count in the low 32 bits,
+     * the owner and the writer take the count with an atomic exchange, whoever gets it writes it
+     */
+    uint64_t repeated;
+    pthread_t owner;
+    struct _swLogBuffer *next;
+} swLogBuffer;
+
+static struct
+{
+    /**
+     * protects the buffer list and the consumer side of the buffers
+     */
+    pthread_mutex_t lock;
+    swLogBuffer *buffers;
+    pthread_t writer;
+    uint8_t writer_running;
+    uint8_t init;
+} swLog_async = { PTHREAD_MUTEX_INITIALIZER };
+
+static __thread swLogBuffer *swLog_buffer = NULL;
+/**
+ * frees the buffer of a thread when it exits
+ */
+static pthread_key_t swLog_buffer_key;
+
+static int swLog_format(int level, char *content, size_t length, char *log_str, size_t size, time_t t);
+static void swLog_write(char *log_str, int n);
+static void swLog_async_put(int level, char *content, size_t length);
+static void swLog_async_start(void);
+
 int swLog_init(char *logfile)
 {
-    SwooleG.log_fd = open(logfile, O_APPEND | O_RDWR | O_CREAT, 0666);
+    int fd = open(logfile, O_APPEND | O_RDWR | O_CREAT, 0666);
+    pthread_mutex_lock(&swLog_async.lock);
+    SwooleG.log_fd = fd;
     if (SwooleG.log_fd < 0)
     {
         printf("open(%s) failed. Error: %s[%d]\n", logfile, strerror(errno), errno);
         SwooleG.log_fd = STDOUT_FILENO;
         is_file = SW_FALSE;
+        pthread_mutex_unlock(&swLog_async.lock);
         return SW_ERR;
     }
     is_file = SW_TRUE;
+    pthread_mutex_unlock(&swLog_async.lock);
     return SW_OK;
 }
 
 void swLog_free(void)
 {
+    /**
+     * the buffered lines still go to the old file
+     */
+    swLog_flush();
+    pthread_mutex_lock(&swLog_async.lock);
     if (is_file)
     {
         close(SwooleG.log_fd);
         SwooleG.log_fd = STDOUT_FILENO;
         is_file = SW_FALSE;
     }
+    pthread_mutex_unlock(&swLog_async.lock);
 }
 
 /**
@@ -68,11 +140,22 @@ void swLog_reopen(enum swBool_type redirect)
 }
 
 void swLog_put(int level, char *content, size_t length)
+{
+    if (SwooleG.log_async)
+    {
+        swLog_async_put(level, content, length);
+        return;
+    }
+
+    char log_str[SW_LOG_BUFFER_SIZE];
+    int n = swLog_format(level, content, length, log_str, sizeof(log_str), time(NULL));
+    swLog_write(log_str, n);
+}
+
+static int swLog_format(int level, char *content, size_t length, char *log_str, size_t size, time_t t)
 {
     const char *level_str;
     char date_str[SW_LOG_DATE_STRLEN];
-    char log_str[SW_LOG_BUFFER_SIZE];
-    int n;
 
     switch (level)
     {
@@ -97,10 +180,8 @@ void swLog_put(int level, char *content, size_t length)
         break;
     }
 
-    time_t t;
-    struct tm *p;
-    t = time(NULL);
-    p = localtime(&t);
+    struct tm tm;
+    struct tm *p = localtime_r(&t, &tm);
     size_t l_data_str = sw_snprintf(
         date_str, SW_LOG_DATE_STRLEN, "%d-%.2d-%.2d %.2d:%.2d:%.2d",
         p->tm_year + 1900, p->tm_mon + 1, p->tm_mday, p->tm_hour, p->tm_min, p->tm_sec
@@ -133,8 +214,11 @@ void swLog_put(int level, char *content, size_t length)
         break;
     }
 
-    n = sw_snprintf(log_str, SW_LOG_BUFFER_SIZE, "[%.*s %c%d.%d]\t%s\t%.*s\n", (int) l_data_str, date_str, process_flag, SwooleG.pid, process_id, level_str, (int) length, content);
+    return sw_snprintf(log_str, size, "[%.*s %c%d.%d]\t%s\t%.*s\n", (int) l_data_str, date_str, process_flag, SwooleG.pid, process_id, level_str, (int) length, content);
+}
 
+static void swLog_write(char *log_str, int n)
+{
     if (is_file && flock(SwooleG.log_fd, LOCK_EX) == -1)
     {
         goto _print;
@@ -148,3 +232,356 @@ void swLog_put(int level, char *content, size_t length)
         printf("flock(%d, LOCK_UN) failed. Error: %s[%d]", SwooleG.log_fd, strerror(errno), errno);
     }
 }
+
+static swLogBuffer* swLog_buffer_new(void)
+{
+    swLogBuffer *buffer = (swLogBuffer *) sw_calloc(1, sizeof(swLogBuffer) + SW_LOG_ASYNC_BUFFER_SIZE);
+    if (buffer == NULL)
+    {
+        return NULL;
+    }
+    buffer->data = (char *) (buffer + 1);
+    buffer->size = SW_LOG_ASYNC_BUFFER_SIZE;
+    buffer->owner = pthread_self();
+
+    pthread_mutex_lock(&swLog_async.lock);
+    buffer->next = swLog_async.buffers;
+    swLog_async.buffers = buffer;
+    pthread_mutex_unlock(&swLog_async.lock);
+    pthread_setspecific(swLog_buffer_key, buffer);
+    return buffer;
+}
+
+static size_t swLog_async_drain(int flush_repeated);
+
+/**
+ * the destructor of swLog_buffer_key, the lines and the repeated count of the thread are written before it is freed
+ */
+static void swLog_buffer_free(void *ptr)
+{
+    swLogBuffer *buffer = (swLogBuffer *) ptr;
+    swLogBuffer **p;
+
+    pthread_mutex_lock(&swLog_async.lock);
+    swLog_async_drain(1);
+    for (p = &swLog_async.buffers; *p; p = &(*p)->next)
+    {
+        if (*p == buffer)
+        {
+            *p = buffer->next;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&swLog_async.lock);
+
+    if (swLog_buffer == buffer)
+    {
+        swLog_buffer = NULL;
+    }
+    sw_free(buffer);
+}
+
+/**
+ * never blocks, the line is dropped and counted when the writer falls behind
+ */
+static void swLog_buffer_push(swLogBuffer *buffer, char *str, uint32_t length)
+{
+    uint32_t head = __atomic_load_n(&buffer->head, __ATOMIC_ACQUIRE);
+    if (buffer->size - (buffer->tail - head) < length)
+    {
+        __atomic_fetch_add(&buffer->dropped, 1, __ATOMIC_RELAXED);
+        return;
+    }
+    uint32_t offset = buffer->tail & (buffer->size - 1);
+    uint32_t n = SW_MIN(length, buffer->size - offset);
+    memcpy(buffer->data + offset, str, n);
+    memcpy(buffer->data, str + n, length - n);
+    __atomic_store_n(&buffer->tail, buffer->tail + length, __ATOMIC_RELEASE);
+}
+
+static void swLog_async_put(int level, char *content, size_t length)
+{
+    char log_str[SW_LOG_BUFFER_SIZE];
+    time_t t = time(NULL);
+    int n;
+
+    if (!swLog_async.writer_running)
+    {
+        swLog_async_start();
+    }
+    if (swLog_buffer == NULL)
+    {
+        swLog_buffer = swLog_buffer_new();
+    }
+    swLogBuffer *buffer = swLog_buffer;
+    if (buffer == NULL || !swLog_async.writer_running)
+    {
+        n = swLog_format(level, content, length, log_str, sizeof(log_str), t);
+        swLog_write(log_str, n);
+        return;
+    }
+
+    /**
+     * a line repeated within the same second is only counted
+     */
+    uint64_t hash = swoole_hash_php(content, length) + level;
+    if (hash == buffer->last_hash && t == buffer->last_time)
+    {
+        __atomic_fetch_add(&buffer->repeated, 1, __ATOMIC_RELEASE);
+        return;
+    }
+    uint32_t repeated = (uint32_t) __atomic_exchange_n(&buffer->repeated, 0, __ATOMIC_ACQ_REL);
+    if (repeated > 0)
+    {
+        char msg[64];
+        int l = sw_snprintf(msg, sizeof(msg), "last message repeated %u times", repeated);
+        n = swLog_format(SW_LOG_NOTICE, msg, l, log_str, sizeof(log_str), buffer->last_time);
+        swLog_buffer_push(buffer, log_str, n);
+    }
+    buffer->last_hash = hash;
+    __atomic_store_n(&buffer->last_time, t, __ATOMIC_RELAXED);
+
+    n = swLog_format(level, content, length, log_str, sizeof(log_str), t);
+    swLog_buffer_push(buffer, log_str, n);
+    __atomic_store_n(&buffer->repeated, (uint64_t) buffer->tail << 32, __ATOMIC_RELEASE);
+}
+
+static size_t swLog_writev(struct iovec *iov, int iovcnt)
+{
+    size_t total = 0;
+
+    if (is_file && flock(SwooleG.log_fd, LOCK_EX) == -1)
+    {
+        printf("flock(%d, LOCK_EX) failed. Error: %s[%d]", SwooleG.log_fd, strerror(errno), errno);
+    }
+    while (iovcnt > 0)
+    {
+        ssize_t n = writev(SwooleG.log_fd, iov, SW_MIN(iovcnt, IOV_MAX));
+        if (n < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            printf("writev(log_fd=%d, iovcnt=%d) failed. Error: %s[%d].\n", SwooleG.log_fd, iovcnt, strerror(errno), errno);
+            break;
+        }
+        total += n;
+        while (iovcnt > 0 && (size_t) n >= iov->iov_len)
+        {
+            n -= iov->iov_len;
+            iov++;
+            iovcnt--;
+        }
+        if (iovcnt > 0)
+        {
+            iov->iov_base = (char *) iov->iov_base + n;
+            iov->iov_len -= n;
+        }
+    }
+    if (is_file && flock(SwooleG.log_fd, LOCK_UN) == -1)
+    {
+        printf("flock(%d, LOCK_UN) failed. Error: %s[%d]", SwooleG.log_fd, strerror(errno), errno);
+    }
+    return total;
+}
+
+/**
+ * write out the lines of all the buffers, SW_LOG_ASYNC_BATCH buffers per writev, the lock must be held,
+ * the pending repeated counts are written once their second has passed, or all of them with flush_repeated
+ */
+static size_t swLog_async_drain(int flush_repeated)
+{
+    struct iovec iov[SW_LOG_ASYNC_BATCH * 4];
+    swLogBuffer *drained[SW_LOG_ASYNC_BATCH];
+    uint32_t tails[SW_LOG_ASYNC_BATCH];
+    char notices[SW_LOG_ASYNC_BATCH][256];
+    char repeat_notices[SW_LOG_ASYNC_BATCH][256];
+    swLogBuffer *buffer = swLog_async.buffers;
+    time_t now = time(NULL);
+    size_t total = 0;
+    int i;
+
+    while (buffer)
+    {
+        int iovcnt = 0;
+        int n = 0;
+
+        for (; buffer && n < SW_LOG_ASYNC_BATCH; buffer = buffer->next)
+        {
+            uint32_t head = buffer->head;
+            uint32_t tail;
+            uint32_t repeated = 0;
+            time_t repeated_time = 0;
+            /**
+             * the count is only taken when it belongs to the last line before the tail,
+             * so it is written right after the drained lines
+             */
+            tail = __atomic_load_n(&buffer->tail, __ATOMIC_ACQUIRE);
+            uint64_t state = __atomic_load_n(&buffer->repeated, __ATOMIC_ACQUIRE);
+            while ((uint32_t) state > 0 && (uint32_t) (state >> 32) == tail)
+            {
+                repeated_time = __atomic_load_n(&buffer->last_time, __ATOMIC_RELAXED);
+                if (!flush_repeated && repeated_time == now)
+                {
+                    break;
+                }
+                if (__atomic_compare_exchange_n(&buffer->repeated, &state, state & ~(uint64_t) UINT32_MAX, 0,
+                        __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+                {
+                    repeated = (uint32_t) state;
+                    break;
+                }
+            }
+            uint64_t dropped = __atomic_load_n(&buffer->dropped, __ATOMIC_RELAXED);
+            if (head == tail && dropped == buffer->dropped_reported && repeated == 0)
+            {
+                continue;
+            }
+            if (dropped != buffer->dropped_reported)
+            {
+                char msg[128];
+                int l = sw_snprintf(msg, sizeof(msg), "%" PRIu64 " log lines were dropped, the log buffer is full",
+                        dropped - buffer->dropped_reported);
+                iov[iovcnt].iov_base = notices[n];
+                iov[iovcnt].iov_len = swLog_format(SW_LOG_WARNING, msg, l, notices[n], sizeof(notices[n]), time(NULL));
+                iovcnt++;
+                buffer->dropped_reported = dropped;
+            }
+            uint32_t offset = head & (buffer->size - 1);
+            uint32_t length = tail - head;
+            uint32_t first = SW_MIN(length, buffer->size - offset);
+            if (first > 0)
+            {
+                iov[iovcnt].iov_base = buffer->data + offset;
+                iov[iovcnt].iov_len = first;
+                iovcnt++;
+            }
+            if (length > first)
+            {
+                iov[iovcnt].iov_base = buffer->data;
+                iov[iovcnt].iov_len = length - first;
+                iovcnt++;
+            }
+            if (repeated > 0)
+            {
+                char msg[64];
+                int l = sw_snprintf(msg, sizeof(msg), "last message repeated %u times", repeated);
+                iov[iovcnt].iov_base = repeat_notices[n];
+                iov[iovcnt].iov_len = swLog_format(SW_LOG_NOTICE, msg, l, repeat_notices[n], sizeof(repeat_notices[n]), repeated_time);
+                iovcnt++;
+            }
+            drained[n] = buffer;
+            tails[n] = tail;
+            n++;
+        }
+        if (n == 0)
+        {
+            break;
+        }
+        total += swLog_writev(iov, iovcnt);
+        for (i = 0; i < n; i++)
+        {
+            __atomic_store_n(&drained[i]->head, tails[i], __ATOMIC_RELEASE);
+        }
+    }
+
+    return total;
+}
+
+static void* swLog_async_writer(void *arg)
+{
+    while (1)
+    {
+        pthread_mutex_lock(&swLog_async.lock);
+        size_t n = swLog_async_drain(0);
+        pthread_mutex_unlock(&swLog_async.lock);
+        if (n == 0)
+        {
+            usleep(SW_LOG_ASYNC_INTERVAL * 1000);
+        }
+    }
+    return NULL;
+}
+
+static void swLog_atfork_prepare(void)
+{
+    pthread_mutex_lock(&swLog_async.lock);
+}
+
+static void swLog_atfork_parent(void)
+{
+    pthread_mutex_unlock(&swLog_async.lock);
+}
+
+/**
+ * the writer thread is not inherited, the lines left in the buffers are written by the parent
+ */
+static void swLog_atfork_child(void)
+{
+    swLogBuffer *buffer = swLog_async.buffers;
+    swLog_async.buffers = NULL;
+    swLog_async.writer_running = 0;
+
+    while (buffer)
+    {
+        swLogBuffer *next = buffer->next;
+        if (buffer == swLog_buffer)
+        {
+            buffer->head = buffer->tail;
+            buffer->dropped_reported = buffer->dropped;
+            buffer->repeated = 0;
+            buffer->next = swLog_async.buffers;
+            swLog_async.buffers = buffer;
+        }
+        else
+        {
+            sw_free(buffer);
+        }
+        buffer = next;
+    }
+    pthread_mutex_unlock(&swLog_async.lock);
+}
+
+static void swLog_async_start(void)
+{
+    pthread_mutex_lock(&swLog_async.lock);
+    if (!swLog_async.init)
+    {
+        pthread_atfork(swLog_atfork_prepare, swLog_atfork_parent, swLog_atfork_child);
+        pthread_key_create(&swLog_buffer_key, swLog_buffer_free);
+        atexit(swLog_flush);
+        swLog_async.init = 1;
+    }
+    if (!swLog_async.writer_running)
+    {
+        /**
+         * the signals are left to the other threads
+         */
+        sigset_t mask, old_mask;
+        sigfillset(&mask);
+        pthread_sigmask(SIG_BLOCK, &mask, &old_mask);
+        if (pthread_create(&swLog_async.writer, NULL, swLog_async_writer, NULL) == 0)
+        {
+            pthread_detach(swLog_async.writer);
+            swLog_async.writer_running = 1;
+        }
+        else
+        {
+            printf("pthread_create() failed. Error: %s[%d]\n", strerror(errno), errno);
+        }
+        pthread_sigmask(SIG_SETMASK, &old_mask, NULL);
+    }
+    pthread_mutex_unlock(&swLog_async.lock);
+}
+
+void swLog_flush(void)
+{
+    if (!swLog_async.init)
+    {
+        return;
+    }
+    pthread_mutex_lock(&swLog_async.lock);
+    swLog_async_drain(1);
+    pthread_mutex_unlock(&swLog_async.lock);
+}
@@ -19,25 +19,102 @@
 
 using namespace swoole;
 
+void CoroutineTable::insert(long cid, Coroutine *co)
+{
+    if (sw_unlikely((count + 1) * 2 > slots.size()))
+    {
+        resize(slots.size() * 2);
+    }
+    size_t i = cid & mask;
+    while (slots[i] != nullptr)
+    {
+        i = (i + 1) & mask;
+    }
+    slots[i] = co;
+    count++;
+}
+
+void CoroutineTable::erase(long cid)
+{
+    size_t i = cid & mask;
+    while (true)
+    {
+        if (slots[i] == nullptr)
+        {
+            return;
+        }
+        if (slots[i]->get_cid() == cid)
+        {
+            break;
+        }
+        i = (i + 1) & mask;
+    }
+    slots[i] = nullptr;
+    count--;
+    /**
+     * backward shift, keep the following entries of the cluster reachable without tombstones
+     */
+    size_t j = i;
+    while (true)
+    {
+        j = (j + 1) & mask;
+        Coroutine *co = slots[j];
+        if (co == nullptr)
+        {
+            return;
+        }
+        size_t home = co->get_cid() & mask;
+        if (((j - home) & mask) >= ((j - i) & mask))
+        {
+            slots[i] = co;
+            slots[j] = nullptr;
+            i = j;
+        }
+    }
+}
+
+void CoroutineTable::resize(size_t capacity)
+{
+    std::vector<Coroutine *> old(capacity, nullptr);
+    old.swap(slots);
+    mask = capacity - 1;
+    for (Coroutine *co : old)
+    {
+        if (co)
+        {
+            size_t i = co->get_cid() & mask;
+            while (slots[i] != nullptr)
+            {
+                i = (i + 1) & mask;
+            }
+            slots[i] = co;
+        }
+    }
+}
+
 Coroutine* Coroutine::current = nullptr;
 long Coroutine::last_cid = 0;
-std::unordered_map<long, Coroutine*> Coroutine::coroutines;
+CoroutineTable Coroutine::coroutines;
 uint64_t Coroutine::peak_num = 0;
 
 size_t Coroutine::stack_size = SW_DEFAULT_C_STACK_SIZE;
-sw_coro_on_swap_t Coroutine::on_yield = nullptr;
-sw_coro_on_swap_t Coroutine::on_resume = nullptr;
-sw_coro_on_swap_t Coroutine::on_close = nullptr;
+std::vector<Coroutine *> Coroutine::pool;
+size_t Coroutine::pool_size = SW_DEFAULT_CORO_POOL_SIZE;
+/**
+ * the hooks are never null, so yield/resume/close call them without a branch
+ */
+static void coroutine_swap_nop(void *task) { }
+
+sw_coro_on_swap_t Coroutine::on_yield = coroutine_swap_nop;
+sw_coro_on_swap_t Coroutine::on_resume = coroutine_swap_nop;
+sw_coro_on_swap_t Coroutine::on_close = coroutine_swap_nop;
 sw_coro_bailout_t Coroutine::on_bailout = nullptr;
 
 void Coroutine::yield()
 {
     SW_ASSERT(current == this || on_bailout != nullptr);
     state = SW_CORO_WAITING;
-    if (sw_likely(on_yield))
-    {
-        on_yield(task);
-    }
+    on_yield(task);
     current = origin;
     ctx.swap_out();
 }
@@ -50,10 +127,7 @@ void Coroutine::resume()
         return;
     }
     state = SW_CORO_RUNNING;
-    if (sw_likely(on_resume))
-    {
-        on_resume(task);
-    }
+    on_resume(task);
     origin = current;
     current = this;
     ctx.swap_in();
@@ -86,24 +160,38 @@ void Coroutine::close()
 {
     SW_ASSERT(current == this);
     state = SW_CORO_END;
-    if (on_close)
-    {
-        on_close(task);
-    }
+    on_close(task);
 #ifdef SW_USE_ASM_CONTEXT
     swTraceLog(SW_TRACE_CONTEXT, "coroutine#%ld stack memory use less than %ld bytes", get_cid(), ctx.get_stack_usage());
 #endif
     current = origin;
     coroutines.erase(cid);
-    delete this;
+    if (pool.size() < pool_size)
+    {
+        pool.push_back(this);
+    }
+    else
+    {
+        delete this;
+    }
+}
+
+void Coroutine::set_pool_size(size_t size)
+{
+    pool_size = size;
+    while (pool.size() > pool_size)
+    {
+        delete pool.back();
+        pool.pop_back();
+    }
 }
 
 void Coroutine::print_list()
 {
-    for (auto i = coroutines.begin(); i != coroutines.end(); i++)
+    for (Coroutine *co : coroutines)
     {
         const char *state;
-        switch(i->second->state){
+        switch(co->state){
         case SW_CORO_INIT:
             state = "[INIT]";
             break;
@@ -120,23 +208,23 @@ void Coroutine::print_list()
             abort();
             return;
         }
-        printf("Coroutine\t%ld\t%s\n", i->first, state);
+        printf("Coroutine\t%ld\t%s\n", co->cid, state);
     }
 }
 
 void Coroutine::set_on_yield(sw_coro_on_swap_t func)
 {
-    on_yield = func;
+    on_yield = func ? func : coroutine_swap_nop;
 }
 
 void Coroutine::set_on_resume(sw_coro_on_swap_t func)
 {
-    on_resume = func;
+    on_resume = func ? func : coroutine_swap_nop;
 }
 
 void Coroutine::set_on_close(sw_coro_on_swap_t func)
 {
-    on_close = func;
+    on_close = func ? func : coroutine_swap_nop;
 }
 
 void Coroutine::bailout(sw_coro_bailout_t func)
@@ -182,7 +270,7 @@ long swoole_coroutine_get_current_id()
 /**
  * for gdb
  */
-static std::unordered_map<long, Coroutine*>::iterator _gdb_iterator;
+static CoroutineTable::iterator _gdb_iterator = Coroutine::coroutines.end();
 
 void swoole_coro_iterator_reset()
 {
@@ -197,23 +285,15 @@ Coroutine* swoole_coro_iterator_each()
     }
     else
     {
-        Coroutine *co = _gdb_iterator->second;
-        _gdb_iterator++;
+        Coroutine *co = *_gdb_iterator;
+        ++_gdb_iterator;
         return co;
     }
 }
 
 Coroutine* swoole_coro_get(long cid)
 {
-    auto i = Coroutine::coroutines.find(cid);
-    if (i == Coroutine::coroutines.end())
-    {
-        return nullptr;
-    }
-    else
-    {
-        return i->second;
-    }
+    return Coroutine::coroutines.find(cid);
 }
 
 size_t swoole_coro_count()
@@ -18,10 +18,10 @@
 
 using swoole::coroutine::Channel;
 
-#include <unordered_map>
-
 using namespace swoole;
 
+std::unordered_map<Coroutine *, Channel::select_msg_t *> Channel::selectors;
+
 void Channel::timer_callback(swTimer *timer, swTimer_node *tnode)
 {
     timer_msg_t *msg = (timer_msg_t *) tnode->data;
@@ -38,6 +38,21 @@ void Channel::timer_callback(swTimer *timer, swTimer_node *tnode)
     msg->co->resume();
 }
 
+/**
+ * only called when the ring is full and below the capacity, the elements are moved to the front
+ */
+void Channel::ring_grow()
+{
+    size_t size = data_ring.size();
+    std::vector<void *> ring(size < capacity / 2 ? size * 2 : capacity);
+    for (size_t i = 0; i < data_count; i++)
+    {
+        ring[i] = data_ring[(data_head + i) % size];
+    }
+    data_ring.swap(ring);
+    data_head = 0;
+}
+
 void Channel::yield(enum opcode type)
 {
     Coroutine *co = Coroutine::get_current_safe();
@@ -54,34 +69,39 @@ void Channel::yield(enum opcode type)
     co->yield();
 }
 
+bool Channel::wait(enum opcode type, double timeout)
+{
+    timer_msg_t msg;
+    msg.error = false;
+    msg.timer = NULL;
+    if (timeout > 0)
+    {
+        long msec = (long) (timeout * 1000);
+        msg.chan = this;
+        msg.type = type;
+        msg.co = Coroutine::get_current();
+        msg.timer = swoole_timer_add(msec, SW_FALSE, timer_callback, &msg);
+    }
+
+    yield(type);
+
+    if (msg.timer)
+    {
+        swoole_timer_del(msg.timer);
+    }
+    return !msg.error && !closed;
+}
+
 void* Channel::pop(double timeout)
 {
-    Coroutine *current_co = Coroutine::get_current_safe();
+    Coroutine::get_current_safe();
     if (closed)
     {
         return nullptr;
     }
     if (is_empty() || !consumer_queue.empty())
     {
-        timer_msg_t msg;
-        msg.error = false;
-        msg.timer = NULL;
-        if (timeout > 0)
-        {
-            long msec = (long) (timeout * 1000);
-            msg.chan = this;
-            msg.type = CONSUMER;
-            msg.co = current_co;
-            msg.timer = swoole_timer_add(msec, SW_FALSE, timer_callback, &msg);
-        }
-
-        yield(CONSUMER);
-
-        if (msg.timer)
-        {
-            swoole_timer_del(msg.timer);
-        }
-        if (msg.error || closed)
+        if (!wait(CONSUMER, timeout))
         {
             return nullptr;
         }
@@ -89,65 +109,89 @@ void* Channel::pop(double timeout)
     /**
      * pop data
      */
-    void *data = data_queue.front();
-    data_queue.pop();
-    /**
-     * notify producer
-     */
-    if (!producer_queue.empty())
-    {
-        Coroutine *co = pop_coroutine(PRODUCER);
-        co->resume();
-    }
-    return data;
+    return do_pop();
 }
 
 bool Channel::push(void *data, double timeout)
 {
-    Coroutine *current_co = Coroutine::get_current_safe();
+    Coroutine::get_current_safe();
     if (closed)
     {
         return false;
     }
     if (is_full() || !producer_queue.empty())
     {
-        timer_msg_t msg;
-        msg.error = false;
-        msg.timer = NULL;
-        if (timeout > 0)
+        if (!wait(PRODUCER, timeout))
         {
-            long msec = (long) (timeout * 1000);
-            msg.chan = this;
-            msg.type = PRODUCER;
-            msg.co = current_co;
-            msg.timer = swoole_timer_add(msec, SW_FALSE, timer_callback, &msg);
+            return false;
         }
+    }
+    /**
+     * push data
+     */
+    do_push(data);
+    return true;
+}
 
-        yield(PRODUCER);
-
-        if (msg.timer)
-        {
-            swoole_timer_del(msg.timer);
-        }
-        if (msg.error || closed)
+size_t Channel::pop_many(void **items, size_t n, double timeout)
+{
+    Coroutine::get_current_safe();
+    if (closed || n == 0)
+    {
+        return 0;
+    }
+    if (is_empty() || !consumer_queue.empty())
+    {
+        if (!wait(CONSUMER, timeout))
         {
-            return false;
+            return 0;
         }
     }
+    size_t count = 0;
+    while (count < n && !is_empty())
+    {
+        items[count++] = ring_pop();
+    }
     /**
-     * push data
+     * notify producers until the freed slots are taken, a producer pushing many elements is resumed only once
      */
-    data_queue.push(data);
-    swTraceLog(SW_TRACE_CHANNEL, "push data to channel, count=%ld", length());
+    while (!producer_queue.empty() && !is_full() && !closed)
+    {
+        Coroutine *co = pop_coroutine(PRODUCER);
+        co->resume();
+    }
+    return count;
+}
+
+size_t Channel::push_many(void **items, size_t n, double timeout)
+{
+    Coroutine::get_current_safe();
+    if (closed || n == 0)
+    {
+        return 0;
+    }
+    if (is_full() || !producer_queue.empty())
+    {
+        if (!wait(PRODUCER, timeout))
+        {
+            return 0;
+        }
+    }
+    size_t count = 0;
+    while (count < n && !is_full())
+    {
+        ring_push(items[count++]);
+    }
+    swTraceLog(SW_TRACE_CHANNEL, "push %zu elements to channel, count=%ld", count, length());
     /**
-     * notify consumer
+     * notify consumers until the elements are taken, a consumer popping many elements is resumed only once
      */
-    if (!consumer_queue.empty())
+    while (!consumer_queue.empty() && !is_empty() && !closed)
     {
         Coroutine *co = pop_coroutine(CONSUMER);
         co->resume();
     }
-    return true;
+    return count;
 }
 
 bool Channel::close()
@@ -170,3 +214,124 @@ bool Channel::close()
     }
     return true;
 }
+
+void Channel::select_timer_callback(swTimer *timer, swTimer_node *tnode)
+{
+    select_msg_t *msg = (select_msg_t *) tnode->data;
+    msg->error = true;
+    msg->timer = nullptr;
+    msg->co->resume();
+}
+
+int Channel::select(std::vector<select_case_t> &cases, double timeout)
+{
+    Coroutine *current_co = Coroutine::get_current_safe();
+    size_t n = cases.size();
+    if (n == 0)
+    {
+        return -1;
+    }
+    /**
+     * start from a random case, so that a busy channel can not starve the others
+     */
+    size_t offset = n > 1 ? swoole_rand(0, n - 1) : 0;
+    for (size_t j = 0; j < n; j++)
+    {
+        size_t i = (offset + j) % n;
+        select_case_t *_case = &cases[i];
+        Channel *chan = _case->chan;
+        if (_case->type == CONSUMER ? chan->pop_ready() : chan->push_ready())
+        {
+            _case->closed = chan->closed;
+            if (_case->closed)
+            {
+                return i;
+            }
+            if (_case->type == CONSUMER)
+            {
+                _case->data = chan->do_pop();
+            }
+            else
+            {
+                chan->do_push(_case->data);
+            }
+            return i;
+        }
+    }
+
+    select_msg_t msg;
+    msg.chan = nullptr;
+    msg.type = CONSUMER;
+    msg.co = current_co;
+    msg.error = false;
+    msg.timer = nullptr;
+    if (timeout > 0)
+    {
+        long msec = (long) (timeout * 1000);
+        msg.timer = swoole_timer_add(msec, SW_FALSE, select_timer_callback, &msg);
+    }
+
+    for (auto &_case : cases)
+    {
+        if (_case.type == CONSUMER)
+        {
+            _case.chan->consumer_queue.push_back(current_co);
+        }
+        else
+        {
+            _case.chan->producer_queue.push_back(current_co);
+        }
+    }
+    selectors[current_co] = &msg;
+    swTraceLog(SW_TRACE_CHANNEL, "select cid=%ld, cases=%zu", current_co->get_cid(), n);
+
+    current_co->yield();
+
+    selectors.erase(current_co);
+    if (msg.timer)
+    {
+        swoole_timer_del(msg.timer);
+    }
+    /**
+     * cancel the cases which were not chosen
+     */
+    for (auto &_case : cases)
+    {
+        if (_case.type == CONSUMER)
+        {
+            _case.chan->consumer_remove(current_co);
+        }
+        else
+        {
+            _case.chan->producer_remove(current_co);
+        }
+    }
+    if (msg.error)
+    {
+        return -1;
+    }
+
+    for (size_t i = 0; i < n; i++)
+    {
+        select_case_t *_case = &cases[i];
+        if (_case->chan != msg.chan || _case->type != msg.type)
+        {
+            continue;
+        }
+        _case->closed = msg.chan->closed;
+        if (_case->closed)
+        {
+            return i;
+        }
+        if (_case->type == CONSUMER)
+        {
+            _case->data = msg.chan->do_pop();
+        }
+        else
+        {
+            msg.chan->do_push(_case->data);
+        }
+        return i;
+    }
+    return -1;
+}
@@ -107,6 +107,20 @@ ssize_t Context::get_stack_usage()
 }
 #endif
 
+bool Context::reset(size_t stack_size, coroutine_func_t fn, void* private_data)
+{
+    if (stack_size != stack_size_)
+    {
+        return false;
+    }
+    fn_ = fn;
+    private_data_ = private_data;
+    end_ = false;
+    swap_ctx_ = nullptr;
+    ctx_ = make_fcontext((char*) stack_ + stack_size_, stack_size_, (void (*)(intptr_t))&context_func);
+    return true;
+}
+
 bool Context::swap_in()
 {
     jump_fcontext(&swap_ctx_, ctx_, (intptr_t) this, true);
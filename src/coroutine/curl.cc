@@ -0,0 +1,291 @@
+/*
+  +----------------------------------------------------------------------+
+  | Swoole                                                               |
+  +----------------------------------------------------------------------+
+  | This source file is subject to version 2.0 of the Apache license,    |
+  | that is bundled with this package in the file LICENSE, and is        |
+  | available through the world-wide-web at the following url:           |
+  | http://www.apache.org/licenses/LICENSE-2.0.html                      |
+  | If you did not receive a copy of the Apache2.0 license and are unable|
+  | to obtain it through the world-wide-web, please send a note to       |
+  | license@swoole.com so we can mail you a copy immediately.            |
+  +----------------------------------------------------------------------+
+  | Author: Tianfeng Han  <mikan.tenny@gmail.com>                        |
+  +----------------------------------------------------------------------+
+*/
+
+#include "coroutine_curl.h"
+
+#ifdef SW_USE_CURL
+#include "swoole_api.h"
+
+using swoole::Coroutine;
+using swoole::coroutine::CurlMulti;
+
+thread_local CurlMulti *CurlMulti::instance = nullptr;
+
+CurlMulti::CurlMulti()
+{
+    multi = curl_multi_init();
+    reactor = SwooleTG.reactor;
+    curl_multi_setopt(multi, CURLMOPT_SOCKETFUNCTION, handle_socket);
+    curl_multi_setopt(multi, CURLMOPT_SOCKETDATA, this);
+    curl_multi_setopt(multi, CURLMOPT_TIMERFUNCTION, handle_timer);
+    curl_multi_setopt(multi, CURLMOPT_TIMERDATA, this);
+}
+
+CurlMulti::~CurlMulti()
+{
+    if (timer)
+    {
+        swoole_timer_del(timer);
+    }
+    curl_multi_cleanup(multi);
+}
+
+/**
+ * the multi handle of a reactor which has been freed (e.g. in a forked child) is dropped
+ */
+CurlMulti* CurlMulti::get()
+{
+    if (instance && instance->reactor != SwooleTG.reactor && instance->handles.empty())
+    {
+        delete instance;
+        instance = nullptr;
+    }
+    if (!instance)
+    {
+        instance = new CurlMulti();
+    }
+    return instance;
+}
+
+void CurlMulti::init_reactor(swReactor *reactor)
+{
+    swReactor_set_handler(reactor, SW_FD_CURL | SW_EVENT_READ, on_read);
+    swReactor_set_handler(reactor, SW_FD_CURL | SW_EVENT_WRITE, on_write);
+    swReactor_set_handler(reactor, SW_FD_CURL | SW_EVENT_ERROR, on_error);
+}
+
+int CurlMulti::handle_socket(CURL *cp, curl_socket_t fd, int action, void *userp, void *socketp)
+{
+    CurlMulti *multi = (CurlMulti *) userp;
+
+    if (action == CURL_POLL_REMOVE)
+    {
+        if (socketp)
+        {
+            swoole_event_del(fd);
+            curl_multi_assign(multi->multi, fd, nullptr);
+        }
+        return 0;
+    }
+
+    int events = 0;
+    if (action & CURL_POLL_IN)
+    {
+        events |= SW_EVENT_READ;
+    }
+    if (action & CURL_POLL_OUT)
+    {
+        events |= SW_EVENT_WRITE;
+    }
+    if (socketp == nullptr)
+    {
+        if (swoole_event_add(fd, events, SW_FD_CURL) < 0)
+        {
+            swWarn("failed to add the curl socket#%d to the reactor", fd);
+            return -1;
+        }
+        curl_multi_assign(multi->multi, fd, multi);
+    }
+    else if (swoole_event_set(fd, events, SW_FD_CURL) < 0)
+    {
+        swWarn("failed to set the events of the curl socket#%d", fd);
+        return -1;
+    }
+    // the connection may be handed over to another easy handle
+    swReactor_get(SwooleTG.reactor, fd)->object = cp;
+    return 0;
+}
+
+int CurlMulti::handle_timer(CURLM *_multi, long timeout_ms, void *userp)
+{
+    CurlMulti *multi = (CurlMulti *) userp;
+    if (multi->timer)
+    {
+        swoole_timer_del(multi->timer);
+        multi->timer = nullptr;
+    }
+    if (timeout_ms >= 0)
+    {
+        multi->timer = swoole_timer_add(SW_MAX(timeout_ms, 1), SW_FALSE, on_timeout, multi);
+    }
+    return 0;
+}
+
+CurlMulti::Handle* CurlMulti::get_waiting_handle()
+{
+    for (auto i = handles.begin(); i != handles.end(); i++)
+    {
+        if (i->second->waiting)
+        {
+            return i->second;
+        }
+    }
+    return nullptr;
+}
+
+void CurlMulti::notify(Handle *handle)
+{
+    if (handle->waiting)
+    {
+        handle->waiting = false;
+        handle->co->resume();
+    }
+}
+
+/**
+ * the timeout of the multi handle is taken by any waiting coroutine
+ */
+void CurlMulti::on_timeout(swTimer *timer, swTimer_node *tnode)
+{
+    CurlMulti *multi = (CurlMulti *) tnode->data;
+    multi->timer = nullptr;
+    multi->timeout = true;
+    Handle *handle = multi->get_waiting_handle();
+    if (handle)
+    {
+        multi->notify(handle);
+    }
+}
+
+int CurlMulti::on_event(swReactor *reactor, swEvent *event, int action)
+{
+    CurlMulti *multi = instance;
+    if (multi == nullptr)
+    {
+        swoole_event_del(event->fd);
+        return SW_OK;
+    }
+    auto i = multi->handles.find((CURL *) event->socket->object);
+    Handle *handle = i == multi->handles.end() ? multi->get_waiting_handle() : i->second;
+    if (handle == nullptr)
+    {
+        // no transfer uses the socket any more, there is no callback of a handle to run
+        int running_handles;
+        curl_multi_socket_action(multi->multi, event->fd, action, &running_handles);
+        return SW_OK;
+    }
+
+    auto &actions = handle->actions;
+    auto j = actions.begin();
+    for (; j != actions.end(); j++)
+    {
+        if (j->first == event->fd)
+        {
+            j->second |= action;
+            break;
+        }
+    }
+    if (j == actions.end())
+    {
+        actions.emplace_back(event->fd, action);
+    }
+    multi->notify(handle);
+    return SW_OK;
+}
+
+int CurlMulti::on_read(swReactor *reactor, swEvent *event)
+{
+    return on_event(reactor, event, CURL_CSELECT_IN);
+}
+
+int CurlMulti::on_write(swReactor *reactor, swEvent *event)
+{
+    return on_event(reactor, event, CURL_CSELECT_OUT);
+}
+
+int CurlMulti::on_error(swReactor *reactor, swEvent *event)
+{
+    return on_event(reactor, event, CURL_CSELECT_ERR);
+}
+
+/**
+ * perform the socket actions given to the coroutine, then resume the coroutines whose transfers are done
+ */
+void CurlMulti::run(Handle *handle)
+{
+    int running_handles;
+
+    while (!handle->actions.empty())
+    {
+        auto action = handle->actions.back();
+        handle->actions.pop_back();
+        curl_multi_socket_action(multi, action.first, action.second, &running_handles);
+    }
+    if (timeout)
+    {
+        timeout = false;
+        curl_multi_socket_action(multi, CURL_SOCKET_TIMEOUT, 0, &running_handles);
+    }
+
+    CURLMsg *msg;
+    int msgs_in_queue;
+    while ((msg = curl_multi_info_read(multi, &msgs_in_queue)))
+    {
+        if (msg->msg != CURLMSG_DONE)
+        {
+            continue;
+        }
+        auto i = handles.find(msg->easy_handle);
+        if (i == handles.end())
+        {
+            continue;
+        }
+        Handle *done_handle = i->second;
+        done_handle->done = true;
+        done_handle->result = msg->data.result;
+        if (done_handle != handle)
+        {
+            notify(done_handle);
+        }
+    }
+}
+
+CURLcode CurlMulti::exec(CURL *cp)
+{
+    CurlMulti *multi = get();
+    Handle handle;
+    handle.cp = cp;
+    handle.co = Coroutine::get_current_safe();
+    handle.waiting = false;
+    handle.done = false;
+    handle.result = CURLE_OK;
+
+    /**
+     * the timeouts of the transfer must not raise signals in a coroutine
+     */
+    curl_easy_setopt(cp, CURLOPT_NOSIGNAL, 1L);
+    if (curl_multi_add_handle(multi->multi, cp) != CURLM_OK)
+    {
+        return CURLE_FAILED_INIT;
+    }
+    multi->handles[cp] = &handle;
+
+    while (true)
+    {
+        multi->run(&handle);
+        if (handle.done)
+        {
+            break;
+        }
+        handle.waiting = true;
+        handle.co->yield();
+    }
+
+    multi->handles.erase(cp);
+    curl_multi_remove_handle(multi->multi, cp);
+    return handle.result;
+}
+#endif
@@ -0,0 +1,273 @@
+/*
+  +----------------------------------------------------------------------+
+  | Swoole                                                               |
+  +----------------------------------------------------------------------+
+  | This source file is subject to version 2.0 of the Apache license,    |
+  | that is bundled with this package in the file LICENSE, and is        |
+  | available through the world-wide-web at the following url:           |
+  | http://www.apache.org/licenses/LICENSE-2.0.html                      |
+  | If you did not receive a copy of the Apache2.0 license and are unable|
+  | to obtain it through the world-wide-web, please send a note to       |
+  | license@swoole.com so we can mail you a copy immediately.            |
+  +----------------------------------------------------------------------+
+  | Author: Tianfeng Han  <mikan.tenny@gmail.com>                        |
+  +----------------------------------------------------------------------+
+*/
+
+#include "swoole.h"
+#include "swoole_api.h"
+#include "coroutine.h"
+
+#ifdef HAVE_EVENTFD
+#include <sys/eventfd.h>
+
+#include <list>
+#include <unordered_map>
+
+using namespace std;
+using namespace swoole;
+
+/**
+ * the waiters of the lock in the current process, woken in FIFO order
+ */
+class coro_lock_waiters
+{
+public:
+    swLock *lock;
+    bool registered = false;
+    list<Coroutine *> _queue;
+};
+
+struct coro_lock_timer_msg
+{
+    coro_lock_waiters *waiters;
+    Coroutine *co;
+    swTimer_node *timer;
+    bool timeout;
+};
+
+static unordered_map<swLock *, coro_lock_waiters *> waiters_map;
+
+static int swCoroLock_lock(swLock *lock);
+static int swCoroLock_unlock(swLock *lock);
+static int swCoroLock_trylock(swLock *lock);
+static int swCoroLock_free(swLock *lock);
+
+int swCoroLock_create(swLock *lock)
+{
+    bzero(lock, sizeof(swLock));
+    lock->type = SW_COROLOCK;
+    int efd = eventfd(0, EFD_NONBLOCK | EFD_SEMAPHORE);
+    if (efd < 0)
+    {
+        swSysWarn("eventfd() failed");
+        return SW_ERR;
+    }
+    lock->object.corolock.event_fd = efd;
+    lock->lock = swCoroLock_lock;
+    lock->unlock = swCoroLock_unlock;
+    lock->trylock = swCoroLock_trylock;
+    lock->free = swCoroLock_free;
+    return SW_OK;
+}
+
+static sw_inline bool swCoroLock_acquire(swCoroLock *object)
+{
+    return object->lock_t == 0 && sw_atomic_cmp_set(&object->lock_t, 0, 1);
+}
+
+static void swCoroLock_post(swCoroLock *object)
+{
+    uint64_t value = 1;
+    if (write(object->event_fd, &value, sizeof(value)) < 0 && errno != EAGAIN)
+    {
+        swSysWarn("write(%d) failed", object->event_fd);
+    }
+}
+
+static void swCoroLock_unregister(coro_lock_waiters *waiters)
+{
+    if (waiters->registered && waiters->_queue.empty())
+    {
+        swoole_event_del(waiters->lock->object.corolock.event_fd);
+        waiters->registered = false;
+    }
+}
+
+static int swCoroLock_onWakeup(swReactor *reactor, swEvent *event)
+{
+    coro_lock_waiters *waiters = (coro_lock_waiters *) event->socket->object;
+    swCoroLock *object = &waiters->lock->object.corolock;
+    uint64_t value;
+
+    if (read(object->event_fd, &value, sizeof(value)) < 0)
+    {
+        // the token was taken by another process
+        return SW_OK;
+    }
+    if (waiters->_queue.empty())
+    {
+        // hand the token over to the other processes
+        swCoroLock_post(object);
+        swCoroLock_unregister(waiters);
+        return SW_OK;
+    }
+    Coroutine *co = waiters->_queue.front();
+    waiters->_queue.pop_front();
+    co->resume();
+    return SW_OK;
+}
+
+static void swCoroLock_onTimeout(swTimer *timer, swTimer_node *tnode)
+{
+    coro_lock_timer_msg *msg = (coro_lock_timer_msg *) tnode->data;
+    msg->timeout = true;
+    msg->timer = nullptr;
+    msg->waiters->_queue.remove(msg->co);
+    msg->co->resume();
+}
+
+static coro_lock_waiters* swCoroLock_get_waiters(swLock *lock)
+{
+    auto i = waiters_map.find(lock);
+    if (i != waiters_map.end())
+    {
+        return i->second;
+    }
+    coro_lock_waiters *waiters = new coro_lock_waiters;
+    waiters->lock = lock;
+    waiters_map[lock] = waiters;
+    return waiters;
+}
+
+int swCoroLock_lockwait(swLock *lock, double timeout)
+{
+    swCoroLock *object = &lock->object.corolock;
+    if (swCoroLock_acquire(object))
+    {
+        return SW_OK;
+    }
+
+    Coroutine *co = Coroutine::get_current();
+    if (sw_unlikely(SwooleTG.reactor == nullptr || !co))
+    {
+        /**
+         * outside a coroutine the lock is polled, the process is blocked until it is acquired or the timeout
+         */
+        if (timeout <= 0)
+        {
+            sw_spinlock(&object->lock_t);
+            return SW_OK;
+        }
+        double deadline = swoole_microtime() + timeout;
+        while (!swCoroLock_acquire(object))
+        {
+            if (swoole_microtime() >= deadline)
+            {
+                return SwooleG.error = ETIMEDOUT;
+            }
+            usleep(1000);
+        }
+        return SW_OK;
+    }
+
+    coro_lock_waiters *waiters = swCoroLock_get_waiters(lock);
+    if (!swReactor_isset_handler(SwooleTG.reactor, SW_FD_CORO_LOCK))
+    {
+        swReactor_set_handler(SwooleTG.reactor, SW_FD_CORO_LOCK | SW_EVENT_READ, swCoroLock_onWakeup);
+    }
+
+    coro_lock_timer_msg msg;
+    msg.waiters = waiters;
+    msg.co = co;
+    msg.timer = nullptr;
+    msg.timeout = false;
+    if (timeout > 0)
+    {
+        msg.timer = swoole_timer_add((long) (timeout * 1000), SW_FALSE, swCoroLock_onTimeout, &msg);
+    }
+
+    int retval = SW_OK;
+    bool requeue = false;
+    sw_atomic_fetch_add(&object->waiters, 1);
+    while (true)
+    {
+        /**
+         * the lock may be released before the waiter was counted, check it again
+         */
+        if (swCoroLock_acquire(object))
+        {
+            break;
+        }
+        if (msg.timeout)
+        {
+            retval = SwooleG.error = ETIMEDOUT;
+            break;
+        }
+        if (!waiters->registered)
+        {
+            if (swoole_event_add(object->event_fd, SW_EVENT_READ, SW_FD_CORO_LOCK) < 0)
+            {
+                retval = SW_ERR;
+                break;
+            }
+            swReactor_get(SwooleTG.reactor, object->event_fd)->object = waiters;
+            waiters->registered = true;
+        }
+        /**
+         * a woken waiter which lost the race keeps its position
+         */
+        if (requeue)
+        {
+            waiters->_queue.push_front(co);
+        }
+        else
+        {
+            waiters->_queue.push_back(co);
+        }
+        co->yield();
+        requeue = true;
+    }
+    sw_atomic_fetch_sub(&object->waiters, 1);
+
+    if (msg.timer)
+    {
+        swoole_timer_del(msg.timer);
+    }
+    swCoroLock_unregister(waiters);
+    return retval;
+}
+
+static int swCoroLock_lock(swLock *lock)
+{
+    return swCoroLock_lockwait(lock, -1);
+}
+
+static int swCoroLock_unlock(swLock *lock)
+{
+    swCoroLock *object = &lock->object.corolock;
+    sw_atomic_cmp_set(&object->lock_t, 1, 0);
+    sw_atomic_memory_barrier();
+    if (object->waiters > 0)
+    {
+        swCoroLock_post(object);
+    }
+    return SW_OK;
+}
+
+static int swCoroLock_trylock(swLock *lock)
+{
+    return swCoroLock_acquire(&lock->object.corolock) ? 0 : EBUSY;
+}
+
+static int swCoroLock_free(swLock *lock)
+{
+    auto i = waiters_map.find(lock);
+    if (i != waiters_map.end())
+    {
+        delete i->second;
+        waiters_map.erase(i);
+    }
+    return close(lock->object.corolock.event_fd);
+}
+#endif
@@ -1504,6 +1504,92 @@ bool Socket::sendfile(const char *filename, off_t offset, size_t length)
     return true;
 }
 
+/**
+ * receive length bytes into the file at its current offset,
+ * on linux the data is moved by splice() through a pipe and never copied into the user space
+ */
+bool Socket::recvfile(int file_fd, size_t length)
+{
+    if (sw_unlikely(!is_available(SW_EVENT_READ)))
+    {
+        return false;
+    }
+    timer_controller timer(&read_timer, read_timeout, this, timer_callback);
+    ssize_t n;
+#ifdef __linux__
+#ifdef SW_USE_OPENSSL
+    if (!socket->ssl)
+#endif
+    {
+        int pipe_fds[2];
+        if (pipe(pipe_fds) < 0)
+        {
+            set_err(errno, cpp_string::format("pipe() failed, %s", strerror(errno)).c_str());
+            return false;
+        }
+        bool retval = false;
+        while (length > 0)
+        {
+            n = ::splice(sock_fd, nullptr, pipe_fds[1], nullptr, SW_MIN(length, SW_SENDFILE_CHUNK_SIZE), SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+            if (n > 0)
+            {
+                length -= n;
+                while (n > 0)
+                {
+                    ssize_t written = ::splice(pipe_fds[0], nullptr, file_fd, nullptr, n, SPLICE_F_MOVE);
+                    if (written <= 0)
+                    {
+                        set_err(errno, cpp_string::format("splice(%d) failed, %s", file_fd, strerror(errno)).c_str());
+                        goto _close_pipe;
+                    }
+                    n -= written;
+                }
+                continue;
+            }
+            else if (n == 0)
+            {
+                set_err(ECONNRESET);
+                goto _close_pipe;
+            }
+            else if (errno != EAGAIN)
+            {
+                set_err(errno);
+                goto _close_pipe;
+            }
+            if (!timer.start() || !wait_event(SW_EVENT_READ))
+            {
+                goto _close_pipe;
+            }
+        }
+        retval = true;
+        _close_pipe:
+        ::close(pipe_fds[0]);
+        ::close(pipe_fds[1]);
+        return retval;
+    }
+#endif
+    swString *buffer = get_read_buffer();
+    while (length > 0)
+    {
+        do
+        {
+            n = swConnection_recv(socket, buffer->str, SW_MIN(length, buffer->size), 0);
+        } while (n < 0 && swConnection_error(errno) == SW_WAIT && timer.start() && wait_event(SW_EVENT_READ));
+        if (n <= 0)
+        {
+            set_err(n == 0 ? ECONNRESET : errno);
+            return false;
+        }
+        if (swoole_sync_writefile(file_fd, buffer->str, n) != (size_t) n)
+        {
+            set_err(errno, cpp_string::format("write(%d) failed, %s", file_fd, strerror(errno)).c_str());
+            return false;
+        }
+        length -= n;
+    }
+    return true;
+}
+
 ssize_t Socket::sendto(const char *address, int port, const void *__buf, size_t __n)
 {
     if (sw_unlikely(!is_available(SW_EVENT_WRITE)))
@@ -56,6 +56,12 @@ Context::~Context()
     thread_.join();
 }
 
+bool Context::reset(size_t stack_size, coroutine_func_t fn, void* private_data)
+{
+    // the thread has exited, it can not be reused
+    return false;
+}
+
 bool Context::swap_in()
 {
     swap_lock_ = current_lock;
@@ -80,6 +80,22 @@ Context::~Context()
     }
 }
 
+bool Context::reset(size_t stack_size, coroutine_func_t fn, void* private_data)
+{
+    if (stack_size != stack_size_ || -1 == getcontext(&ctx_))
+    {
+        return false;
+    }
+    fn_ = fn;
+    private_data_ = private_data;
+    end_ = false;
+    ctx_.uc_stack.ss_sp = stack_;
+    ctx_.uc_stack.ss_size = stack_size_;
+    ctx_.uc_link = NULL;
+    makecontext(&ctx_, (void (*)(void))&context_func, 1, this);
+    return true;
+}
+
 bool Context::swap_in()
 {
     return 0 == swapcontext(&swap_ctx_, &ctx_);
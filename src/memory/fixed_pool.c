@@ -96,6 +96,70 @@ swMemoryPool* swFixedPool_new2(uint32_t slice_size, void *memory, size_t size)
     return pool;
 }
 
+/**
+ * attach to the FixedPool created by swFixedPool_new2 in a memory which is mapped again (maybe at another address),
+ * all the slices are marked idle, the owner marks the busy ones and then calls swFixedPool_relink
+ */
+swMemoryPool* swFixedPool_attach(void *memory)
+{
+    swFixedPool *object = memory;
+    swMemoryPool *pool = (swMemoryPool *) ((char *) memory + sizeof(swFixedPool));
+
+    pool->object = object;
+    pool->alloc = swFixedPool_alloc;
+    pool->free = swFixedPool_free;
+    pool->destroy = swFixedPool_destroy;
+
+    object->memory = (char *) pool + sizeof(swMemoryPool);
+    object->head = object->tail = NULL;
+    object->slice_use = 0;
+
+    uint32_t i;
+    for (i = 0; i < object->slice_num; i++)
+    {
+        swFixedPool_get_slice(object, i)->lock = 0;
+    }
+    return pool;
+}
+
+/**
+ * rebuild the linked list by the lock of the slices, the idle ones first
+ */
+void swFixedPool_relink(swMemoryPool *pool)
+{
+    swFixedPool *object = pool->object;
+    swFixedPool_slice *slice;
+    uint32_t i;
+    uint8_t busy;
+
+    object->head = object->tail = NULL;
+    object->slice_use = 0;
+
+    for (busy = 0; busy < 2; busy++)
+    {
+        for (i = 0; i < object->slice_num; i++)
+        {
+            slice = swFixedPool_get_slice(object, i);
+            if (slice->lock != busy)
+            {
+                continue;
+            }
+            slice->pre = object->tail;
+            slice->next = NULL;
+            if (object->tail)
+            {
+                object->tail->next = slice;
+            }
+            else
+            {
+                object->head = slice;
+            }
+            object->tail = slice;
+            object->slice_use += busy;
+        }
+    }
+}
+
 /**
  * linked list
  */
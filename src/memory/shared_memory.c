@@ -51,8 +51,11 @@ void* sw_shm_calloc(size_t num, size_t _size)
     else
     {
         memcpy(mem, &object, sizeof(swShareMemory));
+        /**
+         * the pages of an anonymous or /dev/zero mapping are zero-filled on first touch,
+         * clearing them here would commit the whole table at once
+         */
         ret_mem = (char *) mem + sizeof(swShareMemory);
-        bzero(ret_mem, size - sizeof(swShareMemory));
         return ret_mem;
     }
 }
@@ -92,24 +95,44 @@ void *swShareMemory_mmap_create(swShareMemory *object, size_t size, char *mapfil
     int tmpfd = -1;
     int flag = MAP_SHARED;
     bzero(object, sizeof(swShareMemory));
+    object->tmpfd = -1;
 
+    /**
+     * named file, the content is kept after the memory is released
+     */
+    if (mapfile)
+    {
+        if ((tmpfd = open(mapfile, O_RDWR | O_CREAT, 0600)) < 0)
+        {
+            swSysWarn("open(%s) failed", mapfile);
+            return NULL;
+        }
+        if (ftruncate(tmpfd, size) < 0)
+        {
+            swSysWarn("ftruncate(%s, %ld) failed", mapfile, size);
+            close(tmpfd);
+            return NULL;
+        }
+    }
+    else
+    {
 #ifdef MAP_ANONYMOUS
-    flag |= MAP_ANONYMOUS;
+        flag |= MAP_ANONYMOUS;
 #else
-    if (mapfile == NULL)
-    {
-        mapfile = "/dev/zero";
+        if ((tmpfd = open("/dev/zero", O_RDWR)) < 0)
+        {
+            return NULL;
+        }
+#endif
     }
-    if ((tmpfd = open(mapfile, O_RDWR)) < 0)
+    if (tmpfd >= 0)
     {
-        return NULL;
+        strncpy(object->mapfile, mapfile ? mapfile : "/dev/zero", SW_SHM_MMAP_FILE_LEN - 1);
+        object->tmpfd = tmpfd;
     }
-    strncpy(object->mapfile, mapfile, SW_SHM_MMAP_FILE_LEN);
-    object->tmpfd = tmpfd;
-#endif
 
 #if defined(SW_USE_HUGEPAGE) && defined(MAP_HUGE_PAGE)
-    if (size > 2 * 1024 * 1024)
+    if (!mapfile && size > 2 * 1024 * 1024)
     {
 #if defined(MAP_HUGETLD)
         flag |= MAP_HUGETLB;
@@ -128,6 +151,10 @@ void *swShareMemory_mmap_create(swShareMemory *object, size_t size, char *mapfil
 #endif
     {
         swSysWarn("mmap(%ld) failed", size);
+        if (tmpfd >= 0)
+        {
+            close(tmpfd);
+        }
         return NULL;
     }
     else
@@ -140,6 +167,11 @@ void *swShareMemory_mmap_create(swShareMemory *object, size_t size, char *mapfil
 
 int swShareMemory_mmap_free(swShareMemory *object)
 {
+    if (object->tmpfd >= 0)
+    {
+        close(object->tmpfd);
+        object->tmpfd = -1;
+    }
     return munmap(object->mem, object->size);
 }
 
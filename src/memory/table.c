@@ -17,6 +17,8 @@
 #include "swoole.h"
 #include "table.h"
 
+#include <sys/file.h>
+
 //#define SW_TABLE_DEBUG 1
 #define SW_TABLE_USE_PHP_HASH
 
@@ -27,6 +29,11 @@ static int conflict_max_level = 0;
 #endif
 
 static void swTableColumn_free(swTableColumn *col);
+static void* swTable_map_file(swTable *table, size_t memory_size);
+static void swTable_attach(swTable *table, ptrdiff_t offset);
+static int swTable_init(swTable *table);
+static void swTable_remove(swTable *table, swTableRow *head, swTableRow *row, swTableRow *prev);
+static int swTable_evict(swTable *table);
 
 static void swTableColumn_free(swTableColumn *col)
 {
@@ -67,19 +74,34 @@ swTable* swTable_new(uint32_t rows_size, float conflict_proportion)
     if (swMutex_create(&table->lock, 1) < 0)
     {
         swWarn("mutex create failed");
+        SwooleG.memory_pool->free(SwooleG.memory_pool, table);
         return NULL;
     }
+    table->columns = NULL;
     table->iterator = sw_malloc(sizeof(swTable_iterator));
     if (!table->iterator)
     {
         swWarn("malloc failed");
-        return NULL;
+        goto _failed;
     }
     table->columns = swHashMap_new(SW_HASHMAP_INIT_BUCKET_N, (swHashMap_dtor)swTableColumn_free);
     if (!table->columns)
     {
-        return NULL;
+        goto _failed;
     }
+    table->schema = swString_new(SW_BUFFER_SIZE_STD);
+    if (!table->schema)
+    {
+        goto _failed;
+    }
+    table->file = NULL;
+    table->file_fd = -1;
+    table->attached = 0;
+    table->evict_policy = SW_TABLE_EVICT_NONE;
+    table->expirable = 0;
+    table->clock_hand = 0;
+    table->sweep_index = 0;
+    table->evict_num = 0;
 
     table->size = rows_size;
     table->mask = rows_size - 1;
@@ -88,6 +110,19 @@ swTable* swTable_new(uint32_t rows_size, float conflict_proportion)
     bzero(table->iterator, sizeof(swTable_iterator));
     table->memory = NULL;
     return table;
+
+    _failed:
+    if (table->columns)
+    {
+        swHashMap_free(table->columns);
+    }
+    if (table->iterator)
+    {
+        sw_free(table->iterator);
+    }
+    table->lock.free(&table->lock);
+    SwooleG.memory_pool->free(SwooleG.memory_pool, table);
+    return NULL;
 }
 
 int swTableColumn_add(swTable *table, const char *name, int len, int type, int size)
@@ -144,9 +179,30 @@ int swTableColumn_add(swTable *table, const char *name, int len, int type, int s
     col->index = table->item_size;
     table->item_size += col->size;
     ++table->column_num;
+
+    char buf[32];
+    int n = sw_snprintf(buf, sizeof(buf), ":%d:%u\n", col->type, col->size);
+    swString_append_ptr(table->schema, name, len);
+    swString_append_ptr(table->schema, buf, n);
+
     return swHashMap_add(table->columns, name, len, col);
 }
 
+int swTable_set_file(swTable *table, const char *file)
+{
+    if (table->memory)
+    {
+        swWarn("the table has been created");
+        return SW_ERR;
+    }
+    if (table->file)
+    {
+        sw_free(table->file);
+    }
+    table->file = sw_strdup(file);
+    return table->file ? SW_OK : SW_ERR;
+}
+
 size_t swTable_get_memory_size(swTable *table)
 {
     /**
@@ -178,11 +234,50 @@ size_t swTable_get_memory_size(swTable *table)
 }
 
 int swTable_create(swTable *table)
+{
+    if (!table->file)
+    {
+        return swTable_init(table);
+    }
+
+    /**
+     * the lock is kept until the table is freed, the forked workers share it with the creator,
+     * another process can only attach the file after the previous one has exited
+     */
+    int fd = open(table->file, O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+    if (fd < 0)
+    {
+        swSysWarn("open(%s) failed", table->file);
+        return SW_ERR;
+    }
+    if (flock(fd, LOCK_EX | LOCK_NB) < 0)
+    {
+        if (errno == EWOULDBLOCK)
+        {
+            swWarn("the table file %s is mapped by another process", table->file);
+        }
+        else
+        {
+            swSysWarn("flock(%s, LOCK_EX) failed", table->file);
+        }
+        close(fd);
+        return SW_ERR;
+    }
+    if (swTable_init(table) < 0)
+    {
+        close(fd);
+        return SW_ERR;
+    }
+    table->file_fd = fd;
+    return SW_OK;
+}
+
+static int swTable_init(swTable *table)
 {
     size_t memory_size = swTable_get_memory_size(table);
     size_t row_memory_size = sizeof(swTableRow) + table->item_size;
 
-    void *memory = sw_shm_malloc(memory_size);
+    void *memory = table->file ? swTable_map_file(table, memory_size) : sw_shm_malloc(memory_size);
     if (memory == NULL)
     {
         return SW_ERR;
@@ -191,6 +286,21 @@ int swTable_create(swTable *table)
     table->memory_size = memory_size;
     table->memory = memory;
 
+    if (table->file)
+    {
+        swTableFileHeader *header = (swTableFileHeader *) table->shm.mem;
+        if (table->attached)
+        {
+            swTable_attach(table, (char *) memory - (char *) header->base);
+        }
+        header->base = (uint64_t) (uintptr_t) memory;
+        if (table->attached)
+        {
+            header->magic = SW_TABLE_FILE_MAGIC;
+            return SW_OK;
+        }
+    }
+
     table->rows = memory;
     memory = (char *) memory + table->size * sizeof(swTableRow *);
     memory_size -= table->size * sizeof(swTableRow *);
@@ -206,9 +316,151 @@ int swTable_create(swTable *table)
     memory_size -= row_memory_size * table->size;
     table->pool = swFixedPool_new2(row_memory_size, memory, memory_size);
 
+    if (table->file)
+    {
+        ((swTableFileHeader *) table->shm.mem)->magic = SW_TABLE_FILE_MAGIC;
+    }
+
     return SW_OK;
 }
 
+static size_t swTable_get_file_header_size(swTable *table)
+{
+    return SW_MEM_ALIGNED_SIZE_EX(sizeof(swTableFileHeader) + table->schema->length, 64);
+}
+
+/**
+ * the file can be attached when it was written by a table with the same layout
+ */
+static int swTable_check_file(swTable *table, size_t memory_size)
+{
+    struct stat file_stat;
+    if (stat(table->file, &file_stat) < 0 || (size_t) file_stat.st_size != swTable_get_file_header_size(table) + memory_size)
+    {
+        return SW_ERR;
+    }
+
+    int fd = open(table->file, O_RDONLY);
+    if (fd < 0)
+    {
+        return SW_ERR;
+    }
+    size_t length = sizeof(swTableFileHeader) + table->schema->length;
+    swTableFileHeader *header = (swTableFileHeader *) sw_malloc(length);
+    int retval = SW_ERR;
+    if (header && pread(fd, header, length, 0) == (ssize_t) length && header->magic == SW_TABLE_FILE_MAGIC
+            && header->version == SW_TABLE_FILE_VERSION && header->row_header_size == sizeof(swTableRow)
+            && header->size == table->size && header->item_size == table->item_size
+            && header->memory_size == memory_size && header->schema_length == table->schema->length
+            && memcmp(header->schema, table->schema->str, table->schema->length) == 0)
+    {
+        retval = SW_OK;
+    }
+    sw_free(header);
+    close(fd);
+    return retval;
+}
+
+static void* swTable_map_file(swTable *table, size_t memory_size)
+{
+    size_t header_size = swTable_get_file_header_size(table);
+
+    table->attached = swTable_check_file(table, memory_size) == SW_OK;
+    /**
+     * the content of a file of another table is dropped, the pages are zero-filled again
+     */
+    if (!table->attached && truncate(table->file, 0) < 0 && errno != ENOENT)
+    {
+        swSysWarn("truncate(%s) failed", table->file);
+        return NULL;
+    }
+
+    void *mem = swShareMemory_mmap_create(&table->shm, header_size + memory_size, table->file);
+    if (mem == NULL)
+    {
+        return NULL;
+    }
+
+    swTableFileHeader *header = (swTableFileHeader *) mem;
+    /**
+     * the header is valid again after the rows have been initialized or rebased
+     */
+    header->magic = 0;
+    if (!table->attached)
+    {
+        header->version = SW_TABLE_FILE_VERSION;
+        header->row_header_size = sizeof(swTableRow);
+        header->schema_length = table->schema->length;
+        header->size = table->size;
+        header->item_size = table->item_size;
+        header->memory_size = memory_size;
+        memcpy(header->schema, table->schema->str, table->schema->length);
+    }
+    return (char *) mem + header_size;
+}
+
+/**
+ * rebase the rows of the file to the new address, drop the slots of the crashed writers
+ * and the broken collision chains, then rebuild the free list of the pool
+ */
+static void swTable_attach(swTable *table, ptrdiff_t offset)
+{
+    size_t row_memory_size = sizeof(swTableRow) + table->item_size;
+    char *memory = (char *) table->memory;
+    size_t i;
+
+    table->rows = (swTableRow **) memory;
+    memory += table->size * sizeof(swTableRow *);
+    for (i = 0; i < table->size; i++)
+    {
+        table->rows[i] = (swTableRow *) (memory + row_memory_size * i);
+    }
+    memory += row_memory_size * table->size;
+
+    table->pool = swFixedPool_attach(memory);
+    swFixedPool *object = (swFixedPool *) table->pool->object;
+    size_t slice_size = sizeof(swFixedPool_slice) + object->slice_size;
+    char *slice_start = (char *) object->memory;
+    char *slice_end = slice_start + slice_size * object->slice_num;
+
+    table->row_num = 0;
+    for (i = 0; i < table->size; i++)
+    {
+        swTableRow *row = table->rows[i];
+        row->lock = 0;
+        row->lock_pid = 0;
+        if ((row->version & 1) || !row->active)
+        {
+            bzero(row, row_memory_size);
+            continue;
+        }
+        table->row_num++;
+        if (row->expire)
+        {
+            table->expirable = 1;
+        }
+
+        while (row->next)
+        {
+            char *next = (char *) row->next + offset;
+            swFixedPool_slice *slice = (swFixedPool_slice *) (next - sizeof(swFixedPool_slice));
+            if ((char *) slice < slice_start || (char *) slice >= slice_end
+                    || ((char *) slice - slice_start) % slice_size != 0 || slice->lock)
+            {
+                row->next = NULL;
+                break;
+            }
+            slice->lock = 1;
+            row->next = (swTableRow *) next;
+            row = row->next;
+            row->lock = 0;
+            table->row_num++;
+        }
+    }
+
+    swFixedPool_relink(table->pool);
+}
+
 void swTable_free(swTable *table)
 {
 #ifdef SW_TABLE_DEBUG
@@ -217,8 +469,21 @@ void swTable_free(swTable *table)
 #endif
 
     swHashMap_free(table->columns);
+    swString_free(table->schema);
     sw_free(table->iterator);
-    if (table->memory)
+    if (table->file)
+    {
+        if (table->memory)
+        {
+            swShareMemory_mmap_free(&table->shm);
+        }
+        if (table->file_fd >= 0)
+        {
+            close(table->file_fd);
+        }
+        sw_free(table->file);
+    }
+    else if (table->memory)
     {
         sw_shm_free(table->memory);
     }
@@ -252,7 +517,7 @@ swTableRow* swTable_iterator_current(swTable *table)
     return table->iterator->row;
 }
 
-void swTable_iterator_forward(swTable *table)
+static void swTable_iterator_next(swTable *table)
 {
     for (; table->iterator->absolute_index < table->size; table->iterator->absolute_index++)
     {
@@ -290,6 +555,18 @@ void swTable_iterator_forward(swTable *table)
     table->iterator->row = NULL;
 }
 
+/**
+ * the expired rows are skipped, they are removed by the next get or sweep
+ */
+void swTable_iterator_forward(swTable *table)
+{
+    time_t now = table->expirable ? time(NULL) : 0;
+    do
+    {
+        swTable_iterator_next(table);
+    } while (now && table->iterator->row && swTableRow_is_expired(table->iterator->row, now));
+}
+
 swTableRow* swTableRow_get(swTable *table, const char *key, int keylen, swTableRow** rowlock)
 {
     if (keylen > SW_TABLE_KEY_SIZE)
@@ -297,9 +574,11 @@ swTableRow* swTableRow_get(swTable *table, const char *key, int keylen, swTableR
         keylen = SW_TABLE_KEY_SIZE;
     }
 
-    swTableRow *row = swTable_hash(table, key, keylen);
-    *rowlock = row;
-    swTableRow_lock(row);
+    swTableRow *head = swTable_hash(table, key, keylen);
+    swTableRow *row = head;
+    swTableRow *prev = NULL;
+    *rowlock = head;
+    swTableRow_lock(head);
 
     for (;;)
     {
@@ -309,6 +588,16 @@ swTableRow* swTableRow_get(swTable *table, const char *key, int keylen, swTableR
             {
                 row = NULL;
             }
+            else if (row->expire && swTableRow_is_expired(row, time(NULL)))
+            {
+                head->version |= 1;
+                swTable_remove(table, head, row, prev);
+                row = NULL;
+            }
+            else
+            {
+                row->accessed = 1;
+            }
             break;
         }
         else if (row->next == NULL)
@@ -318,6 +607,7 @@ swTableRow* swTableRow_get(swTable *table, const char *key, int keylen, swTableR
         }
         else
         {
+            prev = row;
             row = row->next;
         }
     }
@@ -335,6 +625,7 @@ swTableRow* swTableRow_set(swTable *table, const char *key, int keylen, swTableR
     swTableRow *row = swTable_hash(table, key, keylen);
     *rowlock = row;
     swTableRow_lock(row);
+    row->version |= 1;
 
 #ifdef SW_TABLE_DEBUG
     int _conflict_level = 0;
@@ -363,6 +654,12 @@ swTableRow* swTableRow_set(swTable *table, const char *key, int keylen, swTableR
 #endif
                 table->lock.unlock(&table->lock);
 
+                if (!new_row && table->evict_policy == SW_TABLE_EVICT_LRU && swTable_evict(table) == SW_OK)
+                {
+                    table->lock.lock(&table->lock);
+                    new_row = table->pool->alloc(table->pool, 0);
+                    table->lock.unlock(&table->lock);
+                }
                 if (!new_row)
                 {
                     return NULL;
@@ -391,9 +688,18 @@ swTableRow* swTableRow_set(swTable *table, const char *key, int keylen, swTableR
         sw_atomic_fetch_add(&(table->row_num), 1);
     }
 
+    /**
+     * an expired row is reused as a new one
+     */
+    if (row->active && row->expire && swTableRow_is_expired(row, time(NULL)))
+    {
+        bzero(row->data, table->item_size);
+        row->expire = 0;
+    }
     memcpy(row->key, key, keylen);
     row->key[keylen] = '\0';
     row->active = 1;
+    row->accessed = 1;
     return row;
 }
 
@@ -412,62 +718,164 @@ int swTableRow_del(swTable *table, char *key, int keylen)
     }
 
     swTableRow_lock(row);
-    if (row->next == NULL)
+    row->version |= 1;
+
+    swTableRow *tmp = row;
+    swTableRow *prev = NULL;
+    while (tmp)
     {
-        if (strncmp(row->key, key, keylen) == 0)
+        if ((strncmp(tmp->key, key, keylen) == 0))
         {
-            bzero(row, sizeof(swTableRow) + table->item_size);
-            goto _delete_element;
+            break;
         }
-        else
+        prev = tmp;
+        tmp = tmp->next;
+    }
+    if (tmp == NULL || !tmp->active)
+    {
+        swTableRow_unlock(row);
+        return SW_ERR;
+    }
+
+    swTable_remove(table, row, tmp, prev);
+    swTableRow_unlock(row);
+
+    return SW_OK;
+}
+
+/**
+ * remove a row from the chain of the locked head, the lock of the head is kept
+ */
+static void swTable_remove(swTable *table, swTableRow *head, swTableRow *row, swTableRow *prev)
+{
+    if (row == head)
+    {
+        swTableRow *next = head->next;
+        if (next == NULL)
         {
-            goto _not_exists;
+            size_t offset = offsetof(swTableRow, active);
+            bzero((char *) head + offset, sizeof(swTableRow) - offset + table->item_size);
+            sw_atomic_fetch_sub(&(table->row_num), 1);
+            return;
         }
+        //when the deleting element is root, we should move the first element's data to root,
+        //and remove the element from the collision list.
+        head->next = next->next;
+        head->accessed = next->accessed;
+        head->expire = next->expire;
+        memcpy(head->key, next->key, strlen(next->key) + 1);
+        memcpy(head->data, next->data, table->item_size);
+        row = next;
     }
     else
     {
-        swTableRow *tmp = row;
-        swTableRow *prev = NULL;
+        prev->next = row->next;
+    }
 
-        while (tmp)
+    table->lock.lock(&table->lock);
+    bzero(row, sizeof(swTableRow) + table->item_size);
+    table->pool->free(table->pool, row);
+    table->lock.unlock(&table->lock);
+    sw_atomic_fetch_sub(&(table->row_num), 1);
+}
+
+/**
+ * CLOCK eviction, only the chains are visited since their rows hold the slices of the pool.
+ * An expired row is taken at once, otherwise the first row not accessed since the hand passed it last time,
+ * the buckets locked by others (the caller's as well) are skipped
+ */
+static int swTable_evict(swTable *table)
+{
+    time_t now = time(NULL);
+    size_t n = table->size * 2;
+
+    while (n--)
+    {
+        swTableRow *head = table->rows[sw_atomic_fetch_add(&table->clock_hand, 1) & table->mask];
+        if (head->next == NULL || !swTableRow_trylock(head))
+        {
+            continue;
+        }
+
+        swTableRow *row, *prev = NULL;
+        swTableRow *victim = NULL, *victim_prev = NULL;
+        for (row = head; row; prev = row, row = row->next)
         {
-            if ((strncmp(tmp->key, key, keylen) == 0))
+            if (swTableRow_is_expired(row, now))
             {
+                victim = row;
+                victim_prev = prev;
                 break;
             }
-            prev = tmp;
-            tmp = tmp->next;
+            if (row->accessed)
+            {
+                row->accessed = 0;
+            }
+            else if (victim == NULL)
+            {
+                victim = row;
+                victim_prev = prev;
+            }
         }
 
-        if (tmp == NULL)
+        if (victim)
         {
-            _not_exists:
-            swTableRow_unlock(row);
-            return SW_ERR;
+            head->version |= 1;
+            swTable_remove(table, head, victim, victim_prev);
+            sw_atomic_fetch_add(&table->evict_num, 1);
         }
+        swTableRow_unlock(head);
+        if (victim)
+        {
+            return SW_OK;
+        }
+    }
 
-        //when the deleting element is root, we should move the first element's data to root,
-        //and remove the element from the collision list.
-        if (tmp == row)
+    return SW_ERR;
+}
+
+/**
+ * remove the expired rows of the next buckets, a few buckets are locked at a time
+ */
+uint32_t swTable_sweep(swTable *table, uint32_t bucket_num)
+{
+    uint32_t removed = 0;
+    time_t now = time(NULL);
+
+    if (!table->expirable)
+    {
+        return 0;
+    }
+
+    while (bucket_num--)
+    {
+        swTableRow *head = table->rows[sw_atomic_fetch_add(&table->sweep_index, 1) & table->mask];
+        if (!head->active)
         {
-            tmp = tmp->next;
-            row->next = tmp->next;
-            memcpy(row->key, tmp->key, strlen(tmp->key) + 1);
-            memcpy(row->data, tmp->data, table->item_size);
+            continue;
         }
-        if (prev)
+
+        swTableRow_lock(head);
+        swTableRow *row = head, *prev = NULL;
+        while (row && row->active)
         {
-            prev->next = tmp->next;
+            if (!swTableRow_is_expired(row, now))
+            {
+                prev = row;
+                row = row->next;
+                continue;
+            }
+            head->version |= 1;
+            swTable_remove(table, head, row, prev);
+            removed++;
+            //the head holds the next row now
+            if (row != head)
+            {
+                row = prev->next;
+            }
         }
-        table->lock.lock(&table->lock);
-        bzero(tmp, sizeof(swTableRow) + table->item_size);
-        table->pool->free(table->pool, tmp);
-        table->lock.unlock(&table->lock);
+        swTableRow_unlock(head);
     }
 
-    _delete_element:
-    sw_atomic_fetch_sub(&(table->row_num), 1);
-    swTableRow_unlock(row);
-
-    return SW_OK;
+    return removed;
 }
@@ -113,14 +113,14 @@ int swClient_create(swClient *cli, int type, int async)
     }
     else
     {
-        cli->socket = sw_malloc(sizeof(swConnection));
+        cli->socket = sw_malloc(sizeof(swSocket));
     }
 
     cli->buffer_input_size = SW_CLIENT_BUFFER_SIZE;
 
     if (!cli->socket)
     {
-        swWarn("malloc(%d) failed", (int ) sizeof(swConnection));
+        swWarn("malloc(%d) failed", (int ) sizeof(swSocket));
         close(sockfd);
         return SW_ERR;
     }
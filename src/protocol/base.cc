@@ -110,6 +110,22 @@ static sw_inline int swProtocol_split_package_by_eof(swProtocol *protocol, swSoc
     return SW_OK;
 }
 
+/**
+ * move the received part of a package into a buffer created by protocol->package_buffer_new
+ */
+swString* swProtocol_package_buffer_new(swProtocol *protocol, swString *buffer, size_t size)
+{
+    swString *package = protocol->package_buffer_new(protocol, size);
+    if (!package)
+    {
+        return NULL;
+    }
+    memcpy(package->str, buffer->str, buffer->length);
+    package->length = buffer->length;
+    package->offset = buffer->offset;
+    return package;
+}
+
 /**
  * @return SW_ERR: close the connection
  * @return SW_OK: continue
@@ -178,7 +194,21 @@ int swProtocol_recv_check_length(swProtocol *protocol, swSocket *conn, swString
                 }
                 conn->recv_wait = 0;
 
-                if (buffer->length > (size_t) buffer->offset)
+                /**
+                 * the package buffer holds exactly one package, the handler keeps its own reference
+                 */
+                if (conn->recv_package_buffer)
+                {
+                    conn->recv_package_buffer = 0;
+                    conn->recv_buffer = NULL;
+                    protocol->package_buffer_free(protocol, buffer);
+                    buffer = swSocket_get_buffer(conn);
+                    if (!buffer)
+                    {
+                        return SW_ERR;
+                    }
+                }
+                else if (buffer->length > (size_t) buffer->offset)
                 {
                     swString_pop_front(buffer, buffer->offset);
                     goto _do_get_length;
@@ -231,7 +261,18 @@ int swProtocol_recv_check_length(swProtocol *protocol, swSocket *conn, swString
             {
                 if (buffer->size < (size_t) package_length)
                 {
-                    if (swString_extend(buffer, package_length) < 0)
+                    if (protocol->package_buffer_new)
+                    {
+                        swString *package = swProtocol_package_buffer_new(protocol, buffer, package_length);
+                        if (!package)
+                        {
+                            return SW_ERR;
+                        }
+                        swString_free(buffer);
+                        conn->recv_buffer = buffer = package;
+                        conn->recv_package_buffer = 1;
+                    }
+                    else if (swString_extend(buffer, package_length) < 0)
                     {
                         return SW_ERR;
                     }
@@ -26,6 +26,7 @@
 
 using std::string;
 using swoole::http::StaticHandler;
+using swoole::http::StaticFile;
 
 static const char *method_strings[] =
 {
@@ -34,7 +35,7 @@ static const char *method_strings[] =
     "SUBSCRIBE", "UNSUBSCRIBE", "PURGE", "PRI",
 };
 
-string swHttpRequest_get_date_if_modified_since(swHttpRequest *request);
+string swHttpRequest_get_header(swHttpRequest *request, const char *name, size_t name_len);
 
 int swHttp_get_method(const char *method_str, size_t method_len)
 {
@@ -58,6 +59,75 @@ const char* swHttp_get_method_string(int method)
     return method_strings[method - 1];
 }
 
+/**
+ * the q-value of the content-coding in the Accept-Encoding header, that of "*" if it is not listed, 0 if neither is
+ * e.g. "gzip;q=0.8, br" -> gzip: 0.8, br: 1
+ */
+static double swHttp_get_accept_encoding_qvalue(const string &accept_encoding, const char *coding, size_t l_coding)
+{
+    double wildcard_qvalue = 0;
+    bool wildcard = false;
+    const char *p = accept_encoding.c_str();
+    const char *pe = p + accept_encoding.length();
+
+    while (p < pe)
+    {
+        const char *next = (const char *) memchr(p, ',', pe - p);
+        if (next == nullptr)
+        {
+            next = pe;
+        }
+        while (p < next && isspace(*p))
+        {
+            p++;
+        }
+        const char *token_end = (const char *) memchr(p, ';', next - p);
+        if (token_end == nullptr)
+        {
+            token_end = next;
+        }
+        size_t l_token = token_end - p;
+        while (l_token > 0 && isspace(p[l_token - 1]))
+        {
+            l_token--;
+        }
+
+        double q = 1;
+        const char *param = token_end;
+        while (param < next)
+        {
+            param++;
+            while (param < next && isspace(*param))
+            {
+                param++;
+            }
+            if (next - param > 2 && (param[0] == 'q' || param[0] == 'Q') && param[1] == '=')
+            {
+                q = strtod(string(param + 2, next - param - 2).c_str(), nullptr);
+                break;
+            }
+            param = (const char *) memchr(param, ';', next - param);
+            if (param == nullptr)
+            {
+                break;
+            }
+        }
+
+        if (swoole_strcaseeq(p, l_token, coding, l_coding))
+        {
+            return q;
+        }
+        if (l_token == 1 && *p == '*')
+        {
+            wildcard = true;
+            wildcard_qvalue = q;
+        }
+        p = next + 1;
+    }
+
+    return wildcard ? wildcard_qvalue : 0;
+}
+
 int swHttp_static_handler_hit(swServer *serv, swHttpRequest *request, swConnection *conn)
 {
     char *url = request->buffer->str + request->url_offset;
@@ -92,17 +162,67 @@ int swHttp_static_handler_hit(swServer *serv, swHttpRequest *request, swConnecti
     }
 
     auto date_str = handler.get_date();
-    auto date_str_last_modified = handler.get_date_last_modified();
+    const StaticFile *file = handler.get_file();
+
+    /**
+     * precompressed sidecar file, the encoding with the highest q-value is chosen, br wins a tie
+     */
+    const char *content_encoding = nullptr;
+    bool vary = file->gzip_size > 0 || file->br_size > 0;
+    if (vary)
+    {
+        string accept_encoding = swHttpRequest_get_header(request, SW_STRL("Accept-Encoding"));
+        double br_qvalue = file->br_size > 0 ? swHttp_get_accept_encoding_qvalue(accept_encoding, SW_STRL("br")) : 0;
+        double gzip_qvalue = file->gzip_size > 0 ? swHttp_get_accept_encoding_qvalue(accept_encoding, SW_STRL("gzip")) : 0;
+        if (br_qvalue > 0 && br_qvalue >= gzip_qvalue)
+        {
+            if (handler.set_precompressed_file(SW_STRL(".br"), file->br_size))
+            {
+                content_encoding = "br";
+            }
+        }
+        else if (gzip_qvalue > 0)
+        {
+            if (handler.set_precompressed_file(SW_STRL(".gz"), file->gzip_size))
+            {
+                content_encoding = "gzip";
+            }
+        }
+    }
 
-    string date_if_modified_since = swHttpRequest_get_date_if_modified_since(request);
-    if (!date_if_modified_since.empty() && handler.is_modified(date_if_modified_since))
+    string etag = handler.get_etag(content_encoding);
+    char content_encoding_header[64] = "";
+    if (content_encoding)
+    {
+        sw_snprintf(content_encoding_header, sizeof(content_encoding_header),
+                "Content-Encoding: %s\r\n", content_encoding);
+    }
+    const char *vary_header = vary ? "Vary: Accept-Encoding\r\n" : "";
+
+    /**
+     * RFC 7232 section 6, If-Modified-Since is ignored when If-None-Match is present
+     */
+    bool not_modified;
+    string if_none_match = swHttpRequest_get_header(request, SW_STRL("If-None-Match"));
+    if (!if_none_match.empty())
+    {
+        not_modified = handler.match_etag(if_none_match, etag);
+    }
+    else
+    {
+        string date_if_modified_since = swHttpRequest_get_header(request, SW_STRL("If-Modified-Since"));
+        not_modified = !date_if_modified_since.empty() && handler.is_modified(date_if_modified_since);
+    }
+    if (not_modified)
     {
         response.info.len = sw_snprintf(header_buffer, sizeof(header_buffer), "HTTP/1.1 304 Not Modified\r\n"
+                            "%s"
                             "%s"
                             "Date: %s\r\n"
                             "Last-Modified: %s\r\n"
-                            "Server: %s\r\n\r\n", request->keep_alive ? "Connection: keep-alive\r\n" : "", date_str.c_str(),
-                            date_str_last_modified.c_str(),
+                            "ETag: %s\r\n"
+                            "Server: %s\r\n\r\n", request->keep_alive ? "Connection: keep-alive\r\n" : "", vary_header,
+                            date_str.c_str(), file->last_modified.c_str(), etag.c_str(),
                             SW_HTTP_SERVER_SOFTWARE);
         response.data = header_buffer;
         swServer_master_send(serv, &response);
@@ -116,31 +236,48 @@ int swHttp_static_handler_hit(swServer *serv, swHttpRequest *request, swConnecti
             "%s"
             "Content-Length: %ld\r\n"
             "Content-Type: %s\r\n"
+            "%s"
+            "%s"
             "Date: %s\r\n"
             "Last-Modified: %s\r\n"
+            "ETag: %s\r\n"
             "Server: %s\r\n\r\n", request->keep_alive ? "Connection: keep-alive\r\n" : "", (long) task->length,
-            swoole_mime_type_get(handler.get_filename()), date_str.c_str(), date_str_last_modified.c_str(),
-            SW_HTTP_SERVER_SOFTWARE);
+            file->mime_type.c_str(), content_encoding_header, vary_header, date_str.c_str(),
+            file->last_modified.c_str(), etag.c_str(), SW_HTTP_SERVER_SOFTWARE);
 
     response.data = header_buffer;
 
-#ifdef HAVE_TCP_NOPUSH
-    if (conn->socket->tcp_nopush == 0)
+    /**
+     * the content of the small file is cached, send it with the header
+     */
+    if (!content_encoding && !file->content.empty())
+    {
+        string packet(header_buffer, response.info.len);
+        packet.append(file->content);
+        response.info.len = packet.length();
+        response.data = (char *) packet.c_str();
+        swServer_master_send(serv, &response);
+    }
+    else
     {
-        if (swSocket_tcp_nopush(conn->fd, 1) == -1)
+#ifdef HAVE_TCP_NOPUSH
+        if (conn->socket->tcp_nopush == 0)
         {
-            swSysWarn("swSocket_tcp_nopush() failed");
+            if (swSocket_tcp_nopush(conn->fd, 1) == -1)
+            {
+                swSysWarn("swSocket_tcp_nopush() failed");
+            }
+            conn->socket->tcp_nopush = 1;
         }
-        conn->socket->tcp_nopush = 1;
-    }
 #endif
-    swServer_master_send(serv, &response);
+        swServer_master_send(serv, &response);
 
-    response.info.type = SW_SERVER_EVENT_SEND_FILE;
-    response.info.len = sizeof(swSendFile_request) + task->length + 1;
-    response.data = (char*) task;
+        response.info.type = SW_SERVER_EVENT_SEND_FILE;
+        response.info.len = sizeof(swSendFile_request) + task->length + 1;
+        response.data = (char*) task;
 
-    swServer_master_send(serv, &response);
+        swServer_master_send(serv, &response);
+    }
 
     if (!request->keep_alive)
     {
@@ -552,7 +689,11 @@ void swHttpRequest_free(swConnection *conn)
     {
         return;
     }
-    if (request->buffer)
+    if (request->buffer_protocol)
+    {
+        request->buffer_protocol->package_buffer_free(request->buffer_protocol, request->buffer);
+    }
+    else if (request->buffer)
     {
         swString_free(request->buffer);
     }
@@ -591,7 +732,7 @@ int swHttpRequest_get_header_info(swHttpRequest *request)
                 {
                     p++;
                 }
-                request->content_length = atoi(p);
+                request->content_length = strtoull(p, NULL, 10);
                 got_len = 1;
             }
             else if (SW_STRCASECT(p, pe - p, "Connection:"))
@@ -678,15 +819,48 @@ int swHttpRequest_get_header_length(swHttpRequest *request)
     return SW_ERR;
 }
 
-string swHttpRequest_get_date_if_modified_since(swHttpRequest *request)
+/**
+ * the complete requests without body which follow the current one in the buffer,
+ * @return the length of the current request and the following ones
+ */
+uint32_t swHttpRequest_get_pipeline_length(swHttpRequest *request, uint32_t *request_num)
+{
+    swString *buffer = request->buffer;
+    uint32_t offset = request->header_length;
+    swString view;
+    swHttpRequest next;
+
+    *request_num = 1;
+    while (offset < buffer->length && *request_num < SW_HTTP_PIPELINE_BATCH_MAX)
+    {
+        bzero(&view, sizeof(view));
+        view.str = buffer->str + offset;
+        view.length = view.size = buffer->length - offset;
+
+        bzero(&next, sizeof(next));
+        next.buffer = &view;
+        if (swHttpRequest_get_protocol(&next) < 0 || next.method >= SW_HTTP_PRI)
+        {
+            break;
+        }
+        if (swHttpRequest_get_header_length(&next) < 0 || swHttpRequest_get_header_info(&next) == SW_OK)
+        {
+            break;
+        }
+        offset += next.header_length;
+        (*request_num)++;
+    }
+    return offset;
+}
+
+string swHttpRequest_get_header(swHttpRequest *request, const char *name, size_t name_len)
 {
     char *p = request->buffer->str + request->url_offset + request->url_length + 10;
     char *pe = request->buffer->str + request->header_length;
 
     string result;
 
-    char *date_if_modified_since = NULL;
-    size_t length_if_modified_since = 0;
+    char *value = NULL;
 
     int state = 0;
     for (; p < pe; p++)
@@ -694,24 +868,23 @@ string swHttpRequest_get_date_if_modified_since(swHttpRequest *request)
         switch (state)
         {
         case 0:
-            if (SW_STRCASECT(p, pe - p, "If-Modified-Since"))
+            if (swoole_strcasect(p, pe - p, name, name_len))
             {
-                p += sizeof("If-Modified-Since");
+                p += name_len + 1;
                 state = 1;
             }
             break;
         case 1:
             if (!isspace(*p))
             {
-                date_if_modified_since = p;
+                value = p;
                 state = 2;
             }
             break;
         case 2:
             if (SW_STRCASECT(p, pe - p, "\r\n"))
             {
-                length_if_modified_since = p - date_if_modified_since;
-                return string(date_if_modified_since, length_if_modified_since);
+                return string(value, p - value);
             }
             break;
         default:
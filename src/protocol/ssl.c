@@ -37,6 +37,7 @@ static int swSSL_set_default_dhparam(SSL_CTX* ssl_context);
 #endif
 static int swSSL_set_dhparam(SSL_CTX* ssl_context, char *file);
 static int swSSL_set_ecdh_curve(SSL_CTX* ssl_context);
+static sw_inline void swSSL_connection_error(swSocket *conn);
 
 #ifdef TLSEXT_TYPE_next_proto_neg
 static int swSSL_npn_advertised(SSL *ssl, const uchar **out, uint32_t *outlen, void *arg);
@@ -169,6 +170,17 @@ static void MAYBE_UNUSED swSSL_lock_callback(int mode, int type, char *file, int
     }
 }
 
+static sw_inline void swSSL_check_ktls(swSocket *conn)
+{
+#ifdef SW_SSL_HAVE_KTLS
+    if (BIO_get_ktls_send(SSL_get_wbio(conn->ssl)))
+    {
+        conn->ssl_ktls_send = 1;
+        swTraceLog(SW_TRACE_SSL, "fd=%d, kernel TLS send offload enabled", conn->fd);
+    }
+#endif
+}
+
 static sw_inline void swSSL_clear_error(swSocket *conn)
 {
     ERR_clear_error();
@@ -422,6 +434,19 @@ SSL_CTX* swSSL_get_context(swSSL_option *option)
     SSL_CTX_set_mode(ssl_context, SSL_MODE_NO_AUTO_CHAIN);
 #endif
 
+    if (option->ktls)
+    {
+#ifdef SW_SSL_HAVE_KTLS
+        /**
+         * OpenSSL installs the session keys into the kernel TLS ULP after the handshake,
+         * it silently keeps the userspace record layer if the tls module or cipher is not supported
+         */
+        SSL_CTX_set_options(ssl_context, SSL_OP_ENABLE_KTLS);
+#else
+        swTraceLog(SW_TRACE_SSL, "kernel TLS is not supported by this OpenSSL build, ssl_ktls is ignored");
+#endif
+    }
+
     SSL_CTX_set_read_ahead(ssl_context, 1);
     SSL_CTX_set_info_callback(ssl_context, swSSL_info_callback);
 
@@ -792,6 +817,7 @@ int swSSL_accept(swSocket *conn)
     if (n == 1)
     {
         conn->ssl_state = SW_SSL_STATE_READY;
+        swSSL_check_ktls(conn);
 #if OPENSSL_VERSION_NUMBER < 0x10100000L
 #ifdef SSL3_FLAGS_NO_RENEGOTIATE_CIPHERS
         if (conn->ssl->s3)
@@ -847,6 +873,7 @@ int swSSL_connect(swSocket *conn)
     if (n == 1)
     {
         conn->ssl_state = SW_SSL_STATE_READY;
+        swSSL_check_ktls(conn);
 
 #ifdef SW_LOG_TRACE_OPEN
         const char *ssl_version = SSL_get_version(conn->ssl);
@@ -893,8 +920,55 @@ int swSSL_connect(swSocket *conn)
     return SW_ERR;
 }
 
+#ifdef SW_SSL_HAVE_KTLS
+static int swSSL_sendfile_ktls(swSocket *conn, int fd, off_t *offset, size_t size)
+{
+    swSSL_clear_error(conn);
+
+    ossl_ssize_t n = SSL_sendfile(conn->ssl, fd, *offset, size, 0);
+    if (n < 0)
+    {
+        switch (SSL_get_error(conn->ssl, n))
+        {
+        case SSL_ERROR_WANT_READ:
+            conn->ssl_want_read = 1;
+            errno = EAGAIN;
+            break;
+        case SSL_ERROR_WANT_WRITE:
+            conn->ssl_want_write = 1;
+            errno = EAGAIN;
+            break;
+        case SSL_ERROR_SYSCALL:
+            errno = SW_ERROR_SSL_RESET;
+            break;
+        case SSL_ERROR_SSL:
+            swSSL_connection_error(conn);
+            errno = SW_ERROR_SSL_BAD_CLIENT;
+            break;
+        default:
+            errno = SW_ERROR_SSL_RESET;
+            break;
+        }
+        return SW_ERR;
+    }
+    *offset += n;
+    swTraceLog(SW_TRACE_REACTOR, "fd=%d, size=%zu, n=%zd", fd, size, (ssize_t) n);
+    return n;
+}
+#endif
+
 int swSSL_sendfile(swSocket *conn, int fd, off_t *offset, size_t size)
 {
+#ifdef SW_SSL_HAVE_KTLS
+    /**
+     * the records are encrypted by the kernel, the file pages can go out with zero-copy sendfile
+     */
+    if (conn->ssl_ktls_send)
+    {
+        return swSSL_sendfile_ktls(conn, fd, offset, size);
+    }
+#endif
+
     char buf[SW_BUFFER_SIZE_BIG];
     int readn = size > sizeof(buf) ? sizeof(buf) : size;
 
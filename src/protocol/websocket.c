@@ -258,11 +258,11 @@ int swWebSocket_dispatch_frame(swProtocol *proto, swSocket *_socket, char *data,
     switch (ws.header.OPCODE)
     {
     case WEBSOCKET_OPCODE_CONTINUATION:
-        frame_buffer = conn->websocket_buffer;
+        frame_buffer = conn->cold->websocket_buffer;
         if (frame_buffer == NULL)
         {
-            swWarn("bad frame[opcode=0]. remote_addr=%s:%d", swConnection_get_ip(conn->socket_type, &conn->info),
-                    swConnection_get_port(conn->socket_type, &conn->info));
+            swWarn("bad frame[opcode=0]. remote_addr=%s:%d", swConnection_get_ip(conn->socket_type, &conn->cold->info),
+                    swConnection_get_port(conn->socket_type, &conn->cold->info));
             return SW_ERR;
         }
         offset = length - ws.payload_length;
@@ -271,8 +271,8 @@ int swWebSocket_dispatch_frame(swProtocol *proto, swSocket *_socket, char *data,
         //frame data overflow
         if (frame_buffer->length + frame_length > port->protocol.package_max_length)
         {
-            swWarn("websocket frame is too big, remote_addr=%s:%d", swConnection_get_ip(conn->socket_type, &conn->info),
-                    swConnection_get_port(conn->socket_type, &conn->info));
+            swWarn("websocket frame is too big, remote_addr=%s:%d", swConnection_get_ip(conn->socket_type, &conn->cold->info),
+                    swConnection_get_port(conn->socket_type, &conn->cold->info));
             return SW_ERR;
         }
         //merge incomplete data
@@ -282,7 +282,7 @@ int swWebSocket_dispatch_frame(swProtocol *proto, swSocket *_socket, char *data,
         {
             swReactorThread_dispatch(proto, _socket, frame_buffer->str, frame_buffer->length);
             swString_free(frame_buffer);
-            conn->websocket_buffer = NULL;
+            conn->cold->websocket_buffer = NULL;
         }
         break;
 
@@ -294,14 +294,14 @@ int swWebSocket_dispatch_frame(swProtocol *proto, swSocket *_socket, char *data,
         data[offset + 1] = ws.header.OPCODE;
         if (!ws.header.FIN)
         {
-            if (conn->websocket_buffer)
+            if (conn->cold->websocket_buffer)
             {
                 swWarn("merging incomplete frame, bad request. remote_addr=%s:%d",
-                        swConnection_get_ip(conn->socket_type, &conn->info),
-                        swConnection_get_port(conn->socket_type, &conn->info));
+                        swConnection_get_ip(conn->socket_type, &conn->cold->info),
+                        swConnection_get_port(conn->socket_type, &conn->cold->info));
                 return SW_ERR;
             }
-            conn->websocket_buffer = swString_dup(data + offset, length - offset);
+            conn->cold->websocket_buffer = swString_dup(data + offset, length - offset);
         }
         else
         {
@@ -313,8 +313,8 @@ int swWebSocket_dispatch_frame(swProtocol *proto, swSocket *_socket, char *data,
         if (length >= (sizeof(buf) - SW_WEBSOCKET_HEADER_LEN))
         {
             swWarn("ping frame application data is too big. remote_addr=%s:%d",
-                    swConnection_get_ip(conn->socket_type, &conn->info),
-                    swConnection_get_port(conn->socket_type, &conn->info));
+                    swConnection_get_ip(conn->socket_type, &conn->cold->info),
+                    swConnection_get_port(conn->socket_type, &conn->cold->info));
             return SW_ERR;
         }
         else if (length == SW_WEBSOCKET_HEADER_LEN)
@@ -22,10 +22,14 @@
 #include "coroutine_c_api.h"
 #include "coroutine_socket.h"
 #include "coroutine_system.h"
+#include "coroutine_curl.h"
 
 using swoole::CallbackManager;
 using swoole::coroutine::Socket;
 using swoole::coroutine::System;
+#ifdef SW_USE_CURL
+using swoole::coroutine::CurlMulti;
+#endif
 
 #ifdef SW_USE_MALLOC_TRIM
 #ifdef __APPLE__
@@ -74,6 +78,9 @@ int swReactor_create(swReactor *reactor, int max_event)
 
     Socket::init_reactor(reactor);
     System::init_reactor(reactor);
+#ifdef SW_USE_CURL
+    CurlMulti::init_reactor(reactor);
+#endif
     swClient_init_reactor(reactor);
 
     if (SwooleG.hooks[SW_GLOBAL_HOOK_ON_REACTOR_CREATE])
@@ -15,6 +15,7 @@
  */
 
 #include "swoole.h"
+#include "histogram.h"
 
 #ifdef HAVE_EPOLL
 #include <sys/epoll.h>
@@ -192,6 +193,7 @@ static int swReactorEpoll_wait(swReactor *reactor, struct timeval *timeo)
     swReactorEpoll *object = (swReactorEpoll *) reactor->object;
     swReactor_handler handler;
     int i, n, ret;
+    double loop_begin = 0;
 
     int reactor_id = reactor->id;
     int epoll_fd = object->epfd;
@@ -239,6 +241,10 @@ static int swReactorEpoll_wait(swReactor *reactor, struct timeval *timeo)
             }
             SW_REACTOR_CONTINUE;
         }
+        if (reactor->loop_time)
+        {
+            loop_begin = swoole_microtime();
+        }
         for (i = 0; i < n; i++)
         {
             event.fd = events[i].data.u64;
@@ -286,6 +292,11 @@ static int swReactorEpoll_wait(swReactor *reactor, struct timeval *timeo)
                 swReactor_del(reactor, event.fd);
             }
         }
+        if (reactor->loop_time)
+        {
+            swHistogram_record(reactor->loop_time, (swoole_microtime() - loop_begin) * 1000000);
+            swHistogram_record(reactor->loop_event_num, n);
+        }
 
         _continue:
         if (reactor->onFinish)
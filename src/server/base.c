@@ -75,7 +75,7 @@ static int swFactory_dispatch(swFactory *factory, swSendData *task)
     if (task->info.len > 0)
     {
         memcpy(&pkg.info, &task->info, sizeof(pkg.info));
-        pkg.info.flags = SW_EVENT_DATA_PTR;
+        pkg.info.flags = SW_EVENT_DATA_PTR | (task->info.flags & (SW_EVENT_DATA_OBJ_PTR | SW_EVENT_DATA_BATCH | SW_EVENT_DATA_STREAM_BEGIN | SW_EVENT_DATA_STREAM_BODY));
         bzero(&pkg.data, sizeof(pkg.data));
         pkg.data.length = task->info.len;
         pkg.data.str = task->data;
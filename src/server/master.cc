@@ -36,12 +36,29 @@ static int swServer_tcp_feedback(swServer *serv, int session_id, int event);
 
 static swConnection* swServer_connection_new(swServer *serv, swListenPort *ls, int fd, int server_fd);
 
+/**
+ * each of the accepting threads pauses its own listen sockets
+ */
+static __thread swTimer_node *enable_accept_timer = nullptr;
+
+/**
+ * the listen socket accepted by the current thread
+ */
+static sw_inline int swServer_get_accept_socket(swServer *serv, swListenPort *ls)
+{
+    if (serv->reactor_accept && SwooleTG.type == SW_THREAD_REACTOR)
+    {
+        return ls->reactor_socks[SwooleTG.id];
+    }
+    return ls->sock;
+}
+
 static void swServer_disable_accept(swServer *serv)
 {
     swListenPort *ls;
 
-    serv->enable_accept_timer = swoole_timer_add(SW_ACCEPT_RETRY_TIME * 1000, 0, swServer_enable_accept, serv);
-    if (serv->enable_accept_timer == nullptr)
+    enable_accept_timer = swoole_timer_add(SW_ACCEPT_RETRY_TIME * 1000, 0, swServer_enable_accept, serv);
+    if (enable_accept_timer == nullptr)
     {
         return;
     }
@@ -53,7 +70,7 @@ static void swServer_disable_accept(swServer *serv)
         {
             continue;
         }
-        swoole_event_del(ls->sock);
+        swoole_event_del(swServer_get_accept_socket(serv, ls));
     }
 }
 
@@ -68,10 +85,10 @@ static void swServer_enable_accept(swTimer *timer, swTimer_node *tnode)
         {
             continue;
         }
-        swoole_event_add(ls->sock, SW_EVENT_READ, SW_FD_STREAM_SERVER);
+        swoole_event_add(swServer_get_accept_socket(serv, ls), SW_EVENT_READ, SW_FD_STREAM_SERVER);
     }
 
-    serv->enable_accept_timer = nullptr;
+    enable_accept_timer = nullptr;
 }
 
 void swServer_close_port(swServer *serv, enum swBool_type only_stream_port)
@@ -129,7 +146,7 @@ int swServer_master_onAccept(swReactor *reactor, swEvent *event)
 
         //add to connection_list
         swConnection *conn = swServer_connection_new(serv, listen_host, new_fd, event->fd);
-        memcpy(&conn->info.addr, &event->socket->info, sizeof(event->socket->info));
+        memcpy(&conn->cold->info.addr, &event->socket->info, sizeof(event->socket->info));
         conn->socket_type = listen_host->type;
 
 #ifdef SW_USE_OPENSSL
@@ -151,7 +168,10 @@ int swServer_master_onAccept(swReactor *reactor, swEvent *event)
             _socket->ssl = NULL;
         }
 #endif
-        if (serv->single_thread)
+        /**
+         * single thread, or accepted by the reactor thread which owns the connection
+         */
+        if (serv->single_thread || conn->reactor_id == reactor->id)
         {
             if (swServer_connection_incoming(serv, reactor, conn) < 0)
             {
@@ -189,6 +209,11 @@ static int swServer_start_check(swServer *serv)
         swWarn("onPacket event callback must be set");
         return SW_ERR;
     }
+    //only the reactor threads of the process mode, the base mode uses enable_reuse_port
+    if (serv->reactor_accept && (serv->factory_mode != SW_MODE_PROCESS || serv->single_thread))
+    {
+        serv->reactor_accept = 0;
+    }
     //disable notice when use SW_DISPATCH_ROUND and SW_DISPATCH_QUEUE
     if (serv->factory_mode == SW_MODE_PROCESS)
     {
@@ -214,6 +239,12 @@ static int swServer_start_check(swServer *serv)
                 swWarn("cannot set 'onBufferEmpty' event when using dispatch_mode=1/3/7");
                 serv->onBufferEmpty = nullptr;
             }
+            //the chunks of a request body must reach the worker which got its header
+            if (serv->http_body_stream)
+            {
+                swWarn("cannot enable 'http_body_stream' when using dispatch_mode=1/3/7");
+                serv->http_body_stream = 0;
+            }
             serv->disable_notify = 1;
         }
         if (!swServer_support_send_yield(serv))
@@ -310,17 +341,18 @@ void swServer_store_listen_socket(swServer *serv)
         serv->connection_list[sockfd].socket_type = ls->type;
         //save listen_host object
         serv->connection_list[sockfd].object = ls;
+        serv->connection_list[sockfd].cold = swServer_connection_cold(serv, sockfd);
 
         if (swSocket_is_dgram(ls->type))
         {
             if (ls->type == SW_SOCK_UDP)
             {
-                serv->connection_list[sockfd].info.addr.inet_v4.sin_port = htons(ls->port);
+                serv->connection_list[sockfd].cold->info.addr.inet_v4.sin_port = htons(ls->port);
             }
             else if (ls->type == SW_SOCK_UDP6)
             {
                 serv->udp_socket_ipv6 = sockfd;
-                serv->connection_list[sockfd].info.addr.inet_v6.sin6_port = htons(ls->port);
+                serv->connection_list[sockfd].cold->info.addr.inet_v6.sin6_port = htons(ls->port);
             }
         }
         else
@@ -328,12 +360,12 @@ void swServer_store_listen_socket(swServer *serv)
             //IPv4
             if (ls->type == SW_SOCK_TCP)
             {
-                serv->connection_list[sockfd].info.addr.inet_v4.sin_port = htons(ls->port);
+                serv->connection_list[sockfd].cold->info.addr.inet_v4.sin_port = htons(ls->port);
             }
             //IPv6
             else if (ls->type == SW_SOCK_TCP6)
             {
-                serv->connection_list[sockfd].info.addr.inet_v6.sin6_port = htons(ls->port);
+                serv->connection_list[sockfd].cold->info.addr.inet_v6.sin6_port = htons(ls->port);
             }
         }
         if (sockfd >= 0)
@@ -515,7 +547,7 @@ void swServer_reopen_log_file(swServer *serv)
     /**
      * reopen log file
      */
-    close(SwooleG.log_fd);
+    swLog_free();
     swLog_init(SwooleG.log_file);
     /**
      * redirect STDOUT & STDERR to log file
@@ -654,6 +686,34 @@ int swServer_start(swServer *serv)
         }
     }
 
+    /**
+     * the counters updated by all of the workers, a slot for each of them
+     */
+    uint32_t slot_num = SW_MAX(serv->worker_num + serv->task_worker_num, serv->reactor_num);
+    serv->stats->close_count = swCounter_new(slot_num, 1);
+    serv->stats->request_count = swCounter_new(slot_num, 1);
+    if (!serv->stats->close_count || !serv->stats->request_count)
+    {
+        return SW_ERR;
+    }
+    swShardedHistogram **histograms[] = {
+#ifdef SW_BUFFER_RECV_TIME
+        &serv->stats->queue_time,
+        &serv->stats->send_time,
+#endif
+        &serv->stats->handler_time,
+        &serv->stats->reactor_loop_time,
+        &serv->stats->reactor_event_num,
+    };
+    for (auto histogram : histograms)
+    {
+        *histogram = swShardedHistogram_new(slot_num, 1);
+        if (!*histogram)
+        {
+            return SW_ERR;
+        }
+    }
+
     /**
      * user worker process
      */
@@ -667,6 +727,13 @@ int swServer_start(swServer *serv)
             i++;
         }
     }
+    /**
+     * must be done before forking the manager and the worker processes
+     */
+    if (serv->reactor_accept && swReactorThread_reuse_port_init(serv) < 0)
+    {
+        return SW_ERR;
+    }
     serv->running = 1;
     //factory start
     if (factory->start(factory) < 0)
@@ -809,10 +876,10 @@ void swServer_clear_timer(swServer *serv)
         swoole_timer_del(serv->heartbeat_timer);
         serv->heartbeat_timer = nullptr;
     }
-    if (serv->enable_accept_timer)
+    if (enable_accept_timer)
     {
-        swoole_timer_del(serv->enable_accept_timer);
-        serv->enable_accept_timer = nullptr;
+        swoole_timer_del(enable_accept_timer);
+        enable_accept_timer = nullptr;
     }
 }
 
@@ -905,6 +972,33 @@ static int swServer_destory(swServer *serv)
         swReactorThread_free(serv);
     }
     serv->lock.free(&serv->lock);
+    if (serv->stats->close_count)
+    {
+        swCounter_free(serv->stats->close_count, 1);
+        serv->stats->close_count = nullptr;
+    }
+    if (serv->stats->request_count)
+    {
+        swCounter_free(serv->stats->request_count, 1);
+        serv->stats->request_count = nullptr;
+    }
+    swShardedHistogram **histograms[] = {
+#ifdef SW_BUFFER_RECV_TIME
+        &serv->stats->queue_time,
+        &serv->stats->send_time,
+#endif
+        &serv->stats->handler_time,
+        &serv->stats->reactor_loop_time,
+        &serv->stats->reactor_event_num,
+    };
+    for (auto histogram : histograms)
+    {
+        if (*histogram)
+        {
+            swShardedHistogram_free(*histogram, 1);
+            *histogram = nullptr;
+        }
+    }
     SwooleG.serv = nullptr;
     return SW_OK;
 }
@@ -1021,8 +1115,8 @@ int swServer_master_send(swServer *serv, swSendData *_send)
 
     if (!serv->single_thread)
     {
-        assert(fd % serv->reactor_num == reactor->id);
-        assert(fd % serv->reactor_num == SwooleTG.id);
+        assert(conn->reactor_id == reactor->id);
+        assert(conn->reactor_id == SwooleTG.id);
     }
 
     if (serv->factory_mode == SW_MODE_BASE && conn->overflow)
@@ -1799,13 +1893,14 @@ void swServer_connection_each(swServer *serv, void (*callback)(swConnection *con
 {
     swConnection *conn;
 
-    int fd;
-    int serv_max_fd = swServer_get_maxfd(serv);
-    int serv_min_fd = swServer_get_minfd(serv);
+    swConnectionIndex *index = serv->connection_index;
 
-    for (fd = serv_min_fd; fd <= serv_max_fd; fd++)
+    /**
+     * backwards, a connection closed by the callback is replaced by one already visited
+     */
+    for (uint32_t i = index->count; i > 0; i--)
     {
-        conn = swServer_connection_get(serv, fd);
+        conn = swServer_connection_get(serv, index->fds[i - 1]);
         if (conn && conn->socket && conn->active == 1 && conn->closed == 0 && conn->socket->fdtype == SW_FD_SESSION)
         {
             callback(conn);
@@ -1820,10 +1915,22 @@ static swConnection* swServer_connection_new(swServer *serv, swListenPort *ls, i
 {
     swConnection* connection = NULL;
 
-    serv->stats->accept_count++;
+    sw_atomic_fetch_add(&serv->stats->accept_count, 1);
     sw_atomic_fetch_add(&serv->stats->connection_num, 1);
     sw_atomic_fetch_add(&ls->connection_num, 1);
 
+    bool reactor_accept = serv->reactor_accept && SwooleTG.type == SW_THREAD_REACTOR;
+
+    connection = &(serv->connection_list[fd]);
+    bzero(connection, sizeof(swConnection));
+    connection->fd = fd;
+    connection->cold = swServer_connection_cold(serv, fd);
+    bzero(connection->cold, sizeof(swConnectionCold));
+
+    /**
+     * the reactor threads remove the closed connections from the index
+     */
+    swServer_lock(serv);
     if (fd > swServer_get_maxfd(serv))
     {
         swServer_set_maxfd(serv, fd);
@@ -1832,9 +1939,8 @@ static swConnection* swServer_connection_new(swServer *serv, swListenPort *ls, i
     {
         swServer_set_minfd(serv, fd);
     }
-
-    connection = &(serv->connection_list[fd]);
-    bzero(connection, sizeof(swConnection));
+    swServer_connection_index_add(serv, connection);
+    swServer_unlock(serv);
 
     swSocket *_socket = swReactor_get(SwooleTG.reactor, fd);
     _socket->object = connection;
@@ -1871,8 +1977,18 @@ static swConnection* swServer_connection_new(swServer *serv, swListenPort *ls, i
         }
     }
 
-    connection->fd = fd;
-    connection->reactor_id = serv->factory_mode == SW_MODE_BASE ? SwooleWG.id : fd % serv->reactor_num;
+    if (serv->factory_mode == SW_MODE_BASE)
+    {
+        connection->reactor_id = SwooleWG.id;
+    }
+    else if (reactor_accept)
+    {
+        connection->reactor_id = SwooleTG.id;
+    }
+    else
+    {
+        connection->reactor_id = fd % serv->reactor_num;
+    }
     connection->server_fd = (sw_atomic_t) server_fd;
     connection->connect_time = serv->gs->now;
     connection->last_time = serv->gs->now;
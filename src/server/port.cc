@@ -46,6 +46,7 @@ void swPort_init(swListenPort *port)
     port->protocol.package_max_length = SW_BUFFER_INPUT_SIZE;
 
     port->socket_buffer_size = SwooleG.socket_buffer_size;
+    port->dgram_max_size = SW_BUFFER_SIZE_UDP;
 
     char eof[] = SW_DATA_EOF;
     port->protocol.package_eof_len = sizeof(SW_DATA_EOF) - 1;
@@ -309,6 +310,7 @@ static int swPort_onRead_http(swReactor *reactor, swListenPort *port, swEvent *e
     int n = 0;
     char *buf;
     int buf_len;
+    uint32_t chunk_length;
 
     swHttpRequest *request = NULL;
     swProtocol *protocol = &port->protocol;
@@ -373,6 +375,33 @@ static int swPort_onRead_http(swReactor *reactor, swListenPort *port, swEvent *e
     {
         buffer->length += n;
 
+        /**
+         * the body of a streamed request, dispatch the received part directly
+         */
+        if (request->stream_remain > 0)
+        {
+            _stream_body:
+            chunk_length = buffer->length > request->stream_remain ? request->stream_remain : buffer->length;
+            if (chunk_length > 0)
+            {
+                swReactorThread_dispatch_stream(protocol, _socket, buffer->str, chunk_length, 0);
+                request->stream_remain -= chunk_length;
+            }
+            if (request->stream_remain > 0)
+            {
+                buffer->length = 0;
+                goto _recv_data;
+            }
+            if (conn->active && buffer->length > chunk_length)
+            {
+                swString_pop_front(buffer, chunk_length);
+                swHttpRequest_clean(request);
+                goto _parse;
+            }
+            swHttpRequest_free(conn);
+            return SW_OK;
+        }
+
         _parse:
         if (request->method == 0 && swHttpRequest_get_protocol(request) < 0)
         {
@@ -441,7 +470,7 @@ static int swPort_onRead_http(swReactor *reactor, swListenPort *port, swEvent *e
         //http body
         if (request->content_length == 0)
         {
-            swTraceLog(SW_TRACE_SERVER, "content-length=%u, keep-alive=%d", request->content_length, request->keep_alive);
+            swTraceLog(SW_TRACE_SERVER, "content-length=%" PRIu64 ", keep-alive=%d", request->content_length, request->keep_alive);
             // content length field not found
             if (swHttpRequest_get_header_info(request) < 0)
             {
@@ -453,16 +482,33 @@ static int swPort_onRead_http(swReactor *reactor, swListenPort *port, swEvent *e
                      */
                     if (!serv->enable_static_handler || !swHttp_static_handler_hit(serv, request, conn))
                     {
+                        uint32_t request_length = request->header_length;
+                        uint32_t request_num = 1;
+                        /**
+                         * http pipeline, the following complete requests are dispatched with this one,
+                         * the static handler responds in the reactor and would break the order of a batch
+                         */
+                        if (serv->http_pipeline_batch && !serv->enable_static_handler && buffer->length > request_length)
+                        {
+                            request_length = swHttpRequest_get_pipeline_length(request, &request_num);
+                        }
                         /**
                          * dynamic request, dispatch to worker
                          */
-                        swReactorThread_dispatch(protocol, _socket, buffer->str, request->header_length);
+                        if (request_num > 1)
+                        {
+                            swReactorThread_dispatch_batch(protocol, _socket, buffer->str, request_length);
+                        }
+                        else
+                        {
+                            swReactorThread_dispatch(protocol, _socket, buffer->str, request_length);
+                        }
                         /**
                          * http pipeline, multi request
                          */
-                        if (conn->active && buffer->length > request->header_length)
+                        if (conn->active && buffer->length > request_length)
                         {
-                            swString_pop_front(buffer, request->header_length);
+                            swString_pop_front(buffer, request_length);
                             swHttpRequest_clean(request);
                             goto _parse;
                         }
@@ -483,6 +529,22 @@ static int swPort_onRead_http(swReactor *reactor, swListenPort *port, swEvent *e
             }
             else if (request->content_length > (protocol->package_max_length - request->header_length))
             {
+                /**
+                 * the header goes first, the body follows in the chunks as it arrives
+                 */
+                if (serv->http_body_stream)
+                {
+#ifdef SW_HTTP_100_CONTINUE
+                    if (buffer->length == request->header_length && swHttpRequest_has_expect_header(request))
+                    {
+                        swConnection_send(_socket, SW_STRL("HTTP/1.1 100 Continue\r\n\r\n"), 0);
+                    }
+#endif
+                    swReactorThread_dispatch_stream(protocol, _socket, buffer->str, request->header_length, 1);
+                    swString_pop_front(buffer, request->header_length);
+                    request->stream_remain = request->content_length;
+                    goto _stream_body;
+                }
                 swWarn("Content-Length is too big, MaxSize=[%d]", protocol->package_max_length - request->header_length);
                 swConnection_send(_socket, SW_STRL(SW_HTTP_BAD_REQUEST_TOO_LARGE), 0);
                 goto _close_fd;
@@ -491,9 +553,23 @@ static int swPort_onRead_http(swReactor *reactor, swListenPort *port, swEvent *e
 
         //total length
         uint32_t request_size = request->header_length + request->content_length;
-        if (request_size > buffer->size && swString_extend(buffer, request_size) < 0)
+        if (request_size > buffer->size)
         {
-            goto _close_fd;
+            if (protocol->package_buffer_new)
+            {
+                swString *package = swProtocol_package_buffer_new(protocol, buffer, request_size);
+                if (!package)
+                {
+                    goto _close_fd;
+                }
+                swString_free(buffer);
+                request->buffer = buffer = package;
+                request->buffer_protocol = protocol;
+            }
+            else if (swString_extend(buffer, request_size) < 0)
+            {
+                goto _close_fd;
+            }
         }
 
         //discard the redundant data
@@ -538,7 +614,7 @@ static int swPort_onRead_http(swReactor *reactor, swListenPort *port, swEvent *e
             else
             {
                 swTraceLog(
-                    SW_TRACE_SERVER, "PostWait: request->content_length=%d, buffer->length=%zu, request->header_length=%d\n",
+                    SW_TRACE_SERVER, "PostWait: request->content_length=%" PRIu64 ", buffer->length=%zu, request->header_length=%d\n",
                     request->content_length, buffer->length, request->header_length
                 );
             }
@@ -316,10 +316,11 @@ static int process_send_packet(swServer *serv, swPipeBuffer *buf, swSendData *re
     off_t offset = 0;
 
     uint32_t max_length = serv->ipc_max_size - sizeof(buf->info);
+    uint8_t flags = resp->info.flags & (SW_EVENT_DATA_BATCH | SW_EVENT_DATA_STREAM_BEGIN | SW_EVENT_DATA_STREAM_BODY);
 
     if (send_n <= max_length)
     {
-        buf->info.flags = 0;
+        buf->info.flags = flags;
         buf->info.len = send_n;
         memcpy(buf->data, data, send_n);
 
@@ -337,7 +338,7 @@ static int process_send_packet(swServer *serv, swPipeBuffer *buf, swSendData *re
 #ifdef __linux__
     _ipc_use_chunk:
 #endif
-    buf->info.flags = SW_EVENT_DATA_CHUNK;
+    buf->info.flags = SW_EVENT_DATA_CHUNK | flags;
 
     while (send_n > 0)
     {
@@ -471,6 +472,9 @@ static int swFactoryProcess_finish(swFactory *factory, swSendData *resp)
     buf->info.type = resp->info.type;
     buf->info.reactor_id = conn->reactor_id;
     buf->info.server_fd = SwooleWG.id;
+#ifdef SW_BUFFER_RECV_TIME
+    buf->info.time = swoole_microtime();
+#endif
 
     swTrace("worker_id=%d, type=%d",SwooleWG.id, buf->info.type);
 
@@ -43,6 +43,13 @@ int swReactorProcess_create(swServer *serv)
         swSysWarn("calloc[2](%d) failed", (int )(serv->max_connection * sizeof(swConnection)));
         return SW_ERR;
     }
+    serv->connection_cold_list = (swConnectionCold *) sw_calloc(serv->max_connection, sizeof(swConnectionCold));
+    serv->connection_index = (swConnectionIndex *) sw_calloc(1, sizeof(swConnectionIndex) + serv->max_connection * sizeof(int));
+    if (serv->connection_cold_list == NULL || serv->connection_index == NULL)
+    {
+        swSysWarn("calloc[3](%d) failed", (int )(serv->max_connection * sizeof(swConnectionCold)));
+        return SW_ERR;
+    }
     //create factry object
     if (swFactory_create(&(serv->factory)) < 0)
     {
@@ -57,6 +64,8 @@ void swReactorProcess_free(swServer *serv)
 {
     serv->factory.free(&serv->factory);
     sw_free(serv->connection_list);
+    sw_free(serv->connection_cold_list);
+    sw_free(serv->connection_index);
 }
 
 int swReactorProcess_start(swServer *serv)
@@ -354,6 +363,8 @@ static int swReactorProcess_loop(swProcessPool *pool, swWorker *worker)
 
     reactor->id = worker->id;
     reactor->ptr = serv;
+    reactor->loop_time = swShardedHistogram_get_shard(serv->stats->reactor_loop_time, worker->id);
+    reactor->loop_event_num = swShardedHistogram_get_shard(serv->stats->reactor_event_num, worker->id);
 
 #ifdef HAVE_SIGNALFD
     if (SwooleG.use_signalfd)
@@ -452,13 +463,11 @@ static int swReactorProcess_loop(swProcessPool *pool, swWorker *worker)
     /**
      * Close all connections
      */
-    int fd;
-    int serv_max_fd = swServer_get_maxfd(serv);
-    int serv_min_fd = swServer_get_minfd(serv);
+    swConnectionIndex *index = serv->connection_index;
 
-    for (fd = serv_min_fd; fd <= serv_max_fd; fd++)
+    for (uint32_t i = index->count; i > 0; i--)
     {
-        swConnection *conn = swServer_connection_get(serv, fd);
+        swConnection *conn = swServer_connection_get(serv, index->fds[i - 1]);
         if (conn != NULL && conn->active && conn->socket->fdtype == SW_FD_SESSION)
         {
             serv->close(serv, conn->session_id, 1);
@@ -610,13 +619,16 @@ static void swReactorProcess_onTimeout(swTimer *timer, swTimer_node *tnode)
     bzero(&notify_ev, sizeof(notify_ev));
     notify_ev.type = SW_FD_SESSION;
 
-    int serv_max_fd = swServer_get_maxfd(serv);
-    int serv_min_fd = swServer_get_minfd(serv);
+    swConnectionIndex *index = serv->connection_index;
 
     checktime = serv->gs->now - serv->heartbeat_idle_time;
 
-    for (fd = serv_min_fd; fd <= serv_max_fd; fd++)
+    /**
+     * backwards, a closed connection is replaced by one already visited
+     */
+    for (uint32_t i = index->count; i > 0; i--)
     {
+        fd = index->fds[i - 1];
         conn = swServer_connection_get(serv, fd);
 
         if (conn && conn->socket && conn->active == 1 && conn->socket->fdtype == SW_FD_SESSION)
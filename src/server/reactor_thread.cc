@@ -20,6 +20,15 @@
 #include "websocket.h"
 
 #include <unordered_map>
+#include <vector>
+
+#ifdef __linux__
+#include <netinet/udp.h>
+#endif
+
+#ifdef SO_ATTACH_REUSEPORT_CBPF
+#include <linux/filter.h>
+#endif
 
 using std::unordered_map;
 
@@ -30,10 +39,19 @@ static int swReactorThread_onPipeRead(swReactor *reactor, swEvent *ev);
 static int swReactorThread_onRead(swReactor *reactor, swEvent *ev);
 static int swReactorThread_onWrite(swReactor *reactor, swEvent *ev);
 static int swReactorThread_onPacketReceived(swReactor *reactor, swEvent *event);
+#ifdef __linux__
+static int swReactorThread_onPacketBatchReceived(swReactor *reactor, swEvent *event, swListenPort *ls);
+static void swReactorThread_free_dgram_batch();
+#endif
 static int swReactorThread_onClose(swReactor *reactor, swEvent *event);
 static void swReactorThread_onStreamResponse(swStream *stream, char *data, uint32_t length);
 static int swReactorThread_is_empty(swReactor *reactor);
+static int swReactorThread_dispatch_with_flags(swProtocol *proto, swSocket *_socket, char *data, uint32_t length, uint8_t flags);
 static void swReactorThread_shutdown(swReactor *reactor);
+#ifdef HAVE_REUSEPORT
+static int swReactorThread_reuse_port_socket(swListenPort *ls);
+static int swReactorThread_reuse_port_listen(swServer *serv, swListenPort *ls);
+#endif
 
 static void swHeartbeatThread_start(swServer *serv);
 static void swHeartbeatThread_loop(swThreadParam *param);
@@ -128,6 +146,24 @@ static void swReactorThread_onStreamResponse(swStream *stream, char *data, uint3
 /**
  * for udp
  */
+static sw_inline int swReactorThread_get_dgram_fd(int socket_type, swSocketAddress *addr)
+{
+    int fd;
+    if (socket_type == SW_SOCK_UDP)
+    {
+        memcpy(&fd, &addr->addr.inet_v4.sin_addr, sizeof(fd));
+    }
+    else if (socket_type == SW_SOCK_UDP6)
+    {
+        memcpy(&fd, &addr->addr.inet_v6.sin6_addr, sizeof(fd));
+    }
+    else
+    {
+        fd = swoole_crc32(addr->addr.un.sun_path, addr->len);
+    }
+    return fd;
+}
+
 static int swReactorThread_onPacketReceived(swReactor *reactor, swEvent *event)
 {
     int fd = event->fd;
@@ -139,6 +175,14 @@ static int swReactorThread_onPacketReceived(swReactor *reactor, swEvent *event)
     swDgramPacket *pkt = (swDgramPacket *) SwooleTG.buffer_stack->str;
     swFactory *factory = &serv->factory;
 
+#ifdef __linux__
+    swListenPort *ls = (swListenPort *) server_sock->object;
+    if (ls->dgram_recv_batch > 1)
+    {
+        return swReactorThread_onPacketBatchReceived(reactor, event, ls);
+    }
+#endif
+
     pkt->socket_addr.len = sizeof(pkt->socket_addr.addr);
 
     bzero(&task.info, sizeof(task.info));
@@ -170,18 +214,7 @@ static int swReactorThread_onPacketReceived(swReactor *reactor, swEvent *event)
         }
     }
 
-    if (socket_type == SW_SOCK_UDP)
-    {
-        memcpy(&task.info.fd, &pkt->socket_addr.addr.inet_v4.sin_addr, sizeof(task.info.fd));
-    }
-    else if (socket_type == SW_SOCK_UDP6)
-    {
-        memcpy(&task.info.fd, &pkt->socket_addr.addr.inet_v6.sin6_addr, sizeof(task.info.fd));
-    }
-    else
-    {
-        task.info.fd = swoole_crc32(pkt->socket_addr.addr.un.sun_path, pkt->socket_addr.len);
-    }
+    task.info.fd = swReactorThread_get_dgram_fd(socket_type, &pkt->socket_addr);
 
     pkt->socket_type = socket_type;
     pkt->length = ret;
@@ -198,6 +231,262 @@ static int swReactorThread_onPacketReceived(swReactor *reactor, swEvent *event)
     }
 }
 
+#ifdef __linux__
+/**
+ * recvmmsg vectors of the current thread, and the datagrams waiting to be sent to each worker
+ */
+struct swDgramBatch
+{
+    uint32_t size;
+    /**
+     * bytes reserved for every datagram
+     */
+    uint32_t slot_size;
+    struct mmsghdr *msgs;
+    struct iovec *iovs;
+    swSocketAddress *addrs;
+    char *buffers;
+    char *controls;
+    std::vector<swString *> groups;
+};
+
+#ifdef UDP_GRO
+#define SW_DGRAM_CONTROL_SIZE   CMSG_SPACE(sizeof(int))
+#else
+#define SW_DGRAM_CONTROL_SIZE   0
+#endif
+
+static thread_local swDgramBatch *dgram_batch = nullptr;
+
+static swDgramBatch* swReactorThread_get_dgram_batch(swServer *serv, uint32_t size, uint32_t slot_size)
+{
+    if (dgram_batch && dgram_batch->size >= size && dgram_batch->slot_size >= slot_size)
+    {
+        return dgram_batch;
+    }
+    swReactorThread_free_dgram_batch();
+
+    swDgramBatch *batch = new swDgramBatch;
+    batch->size = size;
+    batch->slot_size = slot_size;
+    batch->msgs = new struct mmsghdr[size];
+    batch->iovs = new struct iovec[size];
+    batch->addrs = new swSocketAddress[size];
+    batch->buffers = new char[(size_t) size * slot_size];
+    batch->controls = SW_DGRAM_CONTROL_SIZE > 0 ? new char[size * SW_DGRAM_CONTROL_SIZE] : nullptr;
+    batch->groups.resize(serv->worker_num, nullptr);
+
+    bzero(batch->msgs, sizeof(struct mmsghdr) * size);
+    for (uint32_t i = 0; i < size; i++)
+    {
+        batch->iovs[i].iov_base = batch->buffers + (size_t) i * slot_size;
+        batch->msgs[i].msg_hdr.msg_iov = &batch->iovs[i];
+        batch->msgs[i].msg_hdr.msg_iovlen = 1;
+        batch->msgs[i].msg_hdr.msg_name = &batch->addrs[i].addr;
+        batch->msgs[i].msg_hdr.msg_control = batch->controls ? batch->controls + i * SW_DGRAM_CONTROL_SIZE : nullptr;
+    }
+    dgram_batch = batch;
+    return batch;
+}
+
+static void swReactorThread_free_dgram_batch()
+{
+    swDgramBatch *batch = dgram_batch;
+    if (!batch)
+    {
+        return;
+    }
+    delete[] batch->msgs;
+    delete[] batch->iovs;
+    delete[] batch->addrs;
+    delete[] batch->buffers;
+    delete[] batch->controls;
+    for (auto group : batch->groups)
+    {
+        if (group)
+        {
+            swString_free(group);
+        }
+    }
+    delete batch;
+    dgram_batch = nullptr;
+}
+
+/**
+ * send the grouped datagrams to the worker with one pipe message
+ */
+static int swReactorThread_flush_dgram_group(swServer *serv, swDgramBatch *batch, int worker_id)
+{
+    swString *group = batch->groups[worker_id];
+    if (group == nullptr || group->length == 0)
+    {
+        return SW_OK;
+    }
+    swDataHead *info = (swDataHead *) group->str;
+    info->len = group->length - sizeof(*info);
+    int retval = swReactorThread_send2worker(serv, swServer_get_worker(serv, worker_id), group->str, group->length);
+    group->length = 0;
+    return retval;
+}
+
+static int swReactorThread_dispatch_dgram(swServer *serv, swDgramBatch *batch, swSendData *task, swSocketAddress *addr, char *data, size_t length)
+{
+    int socket_type = serv->connection_list[task->info.server_fd].socket_type;
+    size_t n = sizeof(swDgramPacket) + length;
+
+    task->info.fd = swReactorThread_get_dgram_fd(socket_type, addr);
+
+    /**
+     * group the datagrams by the target worker, only the process mode needs the IPC
+     */
+    if (serv->factory_mode == SW_MODE_PROCESS && !serv->dispatch_func && serv->dispatch_mode != SW_DISPATCH_STREAM
+            && sizeof(swDataHead) + SW_MEM_ALIGNED_SIZE(n) <= serv->ipc_max_size)
+    {
+        task->info.len = n;
+        task->data = nullptr;
+        int worker_id = swServer_worker_schedule(serv, task->info.fd, task);
+        if (worker_id < 0)
+        {
+            return SW_ERR;
+        }
+        swString *group = batch->groups[worker_id];
+        if (group == nullptr)
+        {
+            group = batch->groups[worker_id] = swString_new(SW_BUFFER_SIZE_STD);
+            if (group == nullptr)
+            {
+                return SW_ERR;
+            }
+        }
+        if (group->length + SW_MEM_ALIGNED_SIZE(n) > serv->ipc_max_size)
+        {
+            swReactorThread_flush_dgram_group(serv, batch, worker_id);
+        }
+        if (group->length == 0)
+        {
+            swDataHead *info = (swDataHead *) group->str;
+            *info = task->info;
+            info->type = SW_SERVER_EVENT_SEND_DGRAM_BATCH;
+            info->flags = 0;
+            group->length = sizeof(*info);
+        }
+        if (swString_extend_align(group, group->length + SW_MEM_ALIGNED_SIZE(n)) < 0)
+        {
+            return SW_ERR;
+        }
+        swDgramPacket *pkt = (swDgramPacket *) (group->str + group->length);
+        pkt->socket_type = socket_type;
+        pkt->socket_addr = *addr;
+        pkt->length = length;
+        memcpy(pkt->data, data, length);
+        group->length += SW_MEM_ALIGNED_SIZE(n);
+        return SW_OK;
+    }
+
+    swDgramPacket *pkt = (swDgramPacket *) SwooleTG.buffer_stack->str;
+    pkt->socket_type = socket_type;
+    pkt->socket_addr = *addr;
+    pkt->length = length;
+    memmove(pkt->data, data, length);
+    task->info.len = n;
+    task->data = (char *) pkt;
+    return serv->factory.dispatch(&serv->factory, task);
+}
+
+static int swReactorThread_onPacketBatchReceived(swReactor *reactor, swEvent *event, swListenPort *ls)
+{
+    int fd = event->fd;
+    swServer *serv = (swServer *) reactor->ptr;
+    uint32_t vlen = SW_MIN(ls->dgram_recv_batch, SW_DGRAM_BATCH_MAX);
+    /**
+     * a datagram coalesced by GRO may be as large as an UDP packet can be
+     */
+    uint32_t slot_size = ls->dgram_gro ? SW_BUFFER_SIZE_UDP : ls->dgram_max_size;
+    swDgramBatch *batch = swReactorThread_get_dgram_batch(serv, vlen, slot_size);
+    swSendData task;
+
+    while (true)
+    {
+        for (uint32_t i = 0; i < vlen; i++)
+        {
+            struct msghdr *msg = &batch->msgs[i].msg_hdr;
+            msg->msg_namelen = sizeof(batch->addrs[i].addr);
+            msg->msg_controllen = SW_DGRAM_CONTROL_SIZE;
+            msg->msg_flags = 0;
+            batch->iovs[i].iov_len = slot_size;
+        }
+
+        int n = recvmmsg(fd, batch->msgs, vlen, 0, nullptr);
+        if (n <= 0)
+        {
+            if (n < 0 && errno != EAGAIN && errno != EINTR)
+            {
+                swSysWarn("recvmmsg(%d) failed", fd);
+                return SW_ERR;
+            }
+            return SW_OK;
+        }
+
+        bzero(&task.info, sizeof(task.info));
+        task.info.server_fd = fd;
+        task.info.reactor_id = SwooleTG.id;
+        task.info.type = SW_SERVER_EVENT_SNED_DGRAM;
+#ifdef SW_BUFFER_RECV_TIME
+        task.info.time = swoole_microtime();
+#endif
+
+        for (int i = 0; i < n; i++)
+        {
+            struct msghdr *msg = &batch->msgs[i].msg_hdr;
+            char *data = (char *) batch->iovs[i].iov_base;
+            size_t length = batch->msgs[i].msg_len;
+            size_t segment_size = length;
+            swSocketAddress *addr = &batch->addrs[i];
+
+            if (msg->msg_flags & MSG_TRUNC)
+            {
+                swWarn("datagram from socket#%d is truncated, it is larger than dgram_max_size(%u)", fd, slot_size);
+                continue;
+            }
+            addr->len = msg->msg_namelen;
+#ifdef UDP_GRO
+            /**
+             * coalesced by GRO, split it into the original datagrams
+             */
+            for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(msg); cmsg != nullptr; cmsg = CMSG_NXTHDR(msg, cmsg))
+            {
+                if (cmsg->cmsg_level == SOL_UDP && cmsg->cmsg_type == UDP_GRO)
+                {
+                    int gso_size;
+                    memcpy(&gso_size, CMSG_DATA(cmsg), sizeof(gso_size));
+                    if (gso_size > 0)
+                    {
+                        segment_size = gso_size;
+                    }
+                    break;
+                }
+            }
+#endif
+            for (size_t offset = 0; offset < length; offset += segment_size)
+            {
+                swReactorThread_dispatch_dgram(serv, batch, &task, addr, data + offset, SW_MIN(segment_size, length - offset));
+            }
+        }
+
+        for (size_t worker_id = 0; worker_id < batch->groups.size(); worker_id++)
+        {
+            swReactorThread_flush_dgram_group(serv, batch, worker_id);
+        }
+
+        //drained
+        if ((uint32_t) n < vlen)
+        {
+            return SW_OK;
+        }
+    }
+}
+#endif
+
 /**
  * close connection
  */
@@ -213,8 +502,8 @@ int swReactorThread_close(swReactor *reactor, int fd)
 
     if (serv->factory_mode == SW_MODE_PROCESS)
     {
-        assert(fd % serv->reactor_num == reactor->id);
-        assert(fd % serv->reactor_num == SwooleTG.id);
+        assert(conn->reactor_id == reactor->id);
+        assert(conn->reactor_id == SwooleTG.id);
     }
 
     if (!conn->socket->removed && reactor->del(reactor, fd) < 0)
@@ -222,7 +511,7 @@ int swReactorThread_close(swReactor *reactor, int fd)
         return SW_ERR;
     }
 
-    sw_atomic_fetch_add(&serv->stats->close_count, 1);
+    swCounter_add(serv->stats->close_count, 1);
     sw_atomic_fetch_sub(&serv->stats->connection_num, 1);
 
     swTrace("Close Event.fd=%d|from=%d", fd, reactor->id);
@@ -234,10 +523,17 @@ int swReactorThread_close(swReactor *reactor, int fd)
     }
 #endif
 
+    swListenPort *port = swServer_get_port(serv, fd);
+
     //free the receive memory buffer
+    if (conn->socket->recv_package_buffer)
+    {
+        port->protocol.package_buffer_free(&port->protocol, conn->socket->recv_buffer);
+        conn->socket->recv_buffer = NULL;
+        conn->socket->recv_package_buffer = 0;
+    }
     swConnection_free_buffer(conn->socket);
 
-    swListenPort *port = swServer_get_port(serv, fd);
     sw_atomic_fetch_sub(&port->connection_num, 1);
 
     if (port->open_http_protocol && conn->object)
@@ -265,12 +561,14 @@ int swReactorThread_close(swReactor *reactor, int fd)
 
     swSession *session = swServer_get_session(serv, conn->session_id);
     session->fd = 0;
+
+    swServer_lock(serv);
+    swServer_connection_index_remove(serv, conn);
     /**
      * reset maxfd, for connection_list
      */
     if (fd == swServer_get_maxfd(serv))
     {
-        swServer_lock(serv);
         int find_max_fd = fd - 1;
         swTrace("set_maxfd=%d|close_fd=%d\n", find_max_fd, fd);
         /**
@@ -281,8 +579,8 @@ int swReactorThread_close(swReactor *reactor, int fd)
             //pass
         }
         swServer_set_maxfd(serv, find_max_fd);
-        swServer_unlock(serv);
     }
+    swServer_unlock(serv);
     bzero(conn, sizeof(swConnection));
     return swReactor_close(reactor, fd);
 }
@@ -297,9 +595,6 @@ static int swReactorThread_onClose(swReactor *reactor, swEvent *event)
     swDataHead notify_ev;
     bzero(&notify_ev, sizeof(notify_ev));
 
-    assert(fd % serv->reactor_num == reactor->id);
-    assert(fd % serv->reactor_num == SwooleTG.id);
-
     notify_ev.reactor_id = reactor->id;
     notify_ev.fd = fd;
     notify_ev.type = SW_SERVER_EVENT_CLOSE;
@@ -311,7 +606,11 @@ static int swReactorThread_onClose(swReactor *reactor, swEvent *event)
     {
         return SW_ERR;
     }
-    else if (serv->disable_notify)
+
+    assert(conn->reactor_id == reactor->id);
+    assert(conn->reactor_id == SwooleTG.id);
+
+    if (serv->disable_notify)
     {
         swReactorThread_close(reactor, fd);
         return SW_OK;
@@ -355,18 +654,35 @@ static void swReactorThread_shutdown(swReactor *reactor)
         }
     }
 
-    int fd;
-    int serv_max_fd = swServer_get_maxfd(serv);
-    int serv_min_fd = swServer_get_minfd(serv);
-
-    for (fd = serv_min_fd; fd <= serv_max_fd; fd++)
+#ifdef HAVE_REUSEPORT
+    //stop accepting
+    if (serv->reactor_accept)
     {
-        if (fd % serv->reactor_num != reactor->id)
+        swListenPort *ls;
+        LL_FOREACH(serv->listen_list, ls)
         {
-            continue;
+            if (swSocket_is_dgram(ls->type))
+            {
+                continue;
+            }
+            int sock = ls->reactor_socks[reactor->id];
+            if (!swReactor_get(reactor, sock)->removed)
+            {
+                reactor->del(reactor, sock);
+            }
+            close(sock);
         }
+    }
+#endif
+
+    swConnectionIndex *index = serv->connection_index;
+
+    for (uint32_t i = index->count; i > 0; i--)
+    {
+        int fd = index->fds[i - 1];
         swConnection *conn = swServer_connection_get(serv, fd);
-        if (conn && conn->socket && conn->active && !conn->peer_closed && conn->socket->fdtype == SW_FD_SESSION)
+        if (conn && conn->socket && conn->active && !conn->peer_closed && conn->socket->fdtype == SW_FD_SESSION
+                && conn->reactor_id == reactor->id)
         {
             swReactor_remove_read_event(reactor, fd);
         }
@@ -375,6 +691,20 @@ static void swReactorThread_shutdown(swReactor *reactor)
     reactor->wait_exit = 1;
 }
 
+static sw_inline void swReactorThread_record_send_time(swServer *serv, swDataHead *info)
+{
+#ifdef SW_BUFFER_RECV_TIME
+    if (info->type == SW_SERVER_EVENT_SEND_DATA && info->time > 0)
+    {
+        double now = swoole_microtime();
+        if (now > info->time)
+        {
+            swHistogram_record(swShardedHistogram_get_shard(serv->stats->send_time, SwooleTG.id), (now - info->time) * 1000000);
+        }
+    }
+#endif
+}
+
 /**
  * receive data from worker process pipe
  */
@@ -429,6 +759,7 @@ static int swReactorThread_onPipeRead(swReactor *reactor, swEvent *ev)
                 _send.data = package->str;
                 _send.info.len = package->length;
                 swServer_master_send(serv, &_send);
+                swReactorThread_record_send_time(serv, &_send.info);
                 swString_free(package);
                 _map->erase(key);
             }
@@ -458,6 +789,7 @@ static int swReactorThread_onPipeRead(swReactor *reactor, swEvent *ev)
                     _send.info = resp->info;
                     _send.data = resp->data;
                     swServer_master_send(serv, &_send);
+                    swReactorThread_record_send_time(serv, &_send.info);
                 }
             }
         }
@@ -672,18 +1004,18 @@ static int swReactorThread_onWrite(swReactor *reactor, swEvent *ev)
     swBuffer_chunk *chunk;
     int fd = ev->fd;
 
-    if (serv->factory_mode == SW_MODE_PROCESS)
-    {
-        assert(fd % serv->reactor_num == reactor->id);
-        assert(fd % serv->reactor_num == SwooleTG.id);
-    }
-
     swConnection *conn = swServer_connection_get(serv, fd);
     if (conn == NULL || conn->active == 0)
     {
         return SW_ERR;
     }
 
+    if (serv->factory_mode == SW_MODE_PROCESS)
+    {
+        assert(conn->reactor_id == reactor->id);
+        assert(conn->reactor_id == SwooleTG.id);
+    }
+
     swTraceLog(SW_TRACE_REACTOR, "fd=%d, conn->close_notify=%d, serv->disable_notify=%d, conn->close_force=%d",
             fd, conn->close_notify, serv->disable_notify, conn->close_force);
 
@@ -780,6 +1112,13 @@ int swReactorThread_create(swServer *serv)
         swError("calloc[1] failed");
         return SW_ERR;
     }
+    serv->connection_cold_list = (swConnectionCold *) sw_shm_calloc(serv->max_connection, sizeof(swConnectionCold));
+    serv->connection_index = (swConnectionIndex *) sw_shm_calloc(1, sizeof(swConnectionIndex) + serv->max_connection * sizeof(int));
+    if (serv->connection_cold_list == NULL || serv->connection_index == NULL)
+    {
+        swError("calloc[2] failed");
+        return SW_ERR;
+    }
     if (serv->worker_num < 1)
     {
         swError("Fatal Error: serv->worker_num < 1");
@@ -821,6 +1160,16 @@ int swReactorThread_start(swServer *serv)
         {
             continue;
         }
+#ifdef HAVE_REUSEPORT
+        if (serv->reactor_accept)
+        {
+            if (swReactorThread_reuse_port_listen(serv, ls) < 0)
+            {
+                goto _failed;
+            }
+            continue;
+        }
+#endif
         if (swPort_listen(ls) < 0)
         {
             _failed:
@@ -856,6 +1205,11 @@ int swReactorThread_start(swServer *serv)
         {
             continue;
         }
+        //accepted by the reactor threads
+        if (serv->reactor_accept)
+        {
+            continue;
+        }
         reactor->add(reactor, ls->sock, SW_FD_STREAM_SERVER);
     }
 
@@ -965,6 +1319,8 @@ static int swReactorThread_init(swServer *serv, swReactor *reactor, uint16_t rea
     reactor->max_socket = serv->max_connection;
     reactor->close = swReactorThread_close;
     reactor->is_empty = swReactorThread_is_empty;
+    reactor->loop_time = swShardedHistogram_get_shard(serv->stats->reactor_loop_time, reactor_id);
+    reactor->loop_event_num = swShardedHistogram_get_shard(serv->stats->reactor_event_num, reactor_id);
 
     reactor->default_error_handler = swReactorThread_onClose;
 
@@ -985,11 +1341,11 @@ static int swReactorThread_init(swServer *serv, swReactor *reactor, uint16_t rea
                 }
                 if (ls->type == SW_SOCK_UDP)
                 {
-                    serv->connection_list[ls->sock].info.addr.inet_v4.sin_port = htons(ls->port);
+                    serv->connection_list[ls->sock].cold->info.addr.inet_v4.sin_port = htons(ls->port);
                 }
                 else if (ls->type == SW_SOCK_UDP6)
                 {
-                    serv->connection_list[ls->sock].info.addr.inet_v6.sin6_port = htons(ls->port);
+                    serv->connection_list[ls->sock].cold->info.addr.inet_v6.sin6_port = htons(ls->port);
                 }
                 serv->connection_list[ls->sock].fd = ls->sock;
                 serv->connection_list[ls->sock].socket_type = ls->type;
@@ -1003,6 +1359,26 @@ static int swReactorThread_init(swServer *serv, swReactor *reactor, uint16_t rea
         }
     }
 
+#ifdef HAVE_REUSEPORT
+    //accept in the reactor thread
+    if (serv->reactor_accept)
+    {
+        swReactor_set_handler(reactor, SW_FD_STREAM_SERVER, swServer_master_onAccept);
+        swListenPort *ls;
+        LL_FOREACH(serv->listen_list, ls)
+        {
+            if (swSocket_is_dgram(ls->type))
+            {
+                continue;
+            }
+            if (reactor->add(reactor, ls->reactor_socks[reactor_id], SW_FD_STREAM_SERVER) < 0)
+            {
+                return SW_ERR;
+            }
+        }
+    }
+#endif
+
     //set protocol function point
     swReactorThread_set_protocol(serv, reactor);
 
@@ -1154,15 +1530,52 @@ static int swReactorThread_loop(swThreadParam *param)
     }
     delete _map;
 
+#ifdef __linux__
+    swReactorThread_free_dgram_batch();
+#endif
     swString_free(SwooleTG.buffer_stack);
     pthread_exit(0);
     return SW_OK;
 }
 
+/**
+ * the data is the body of a package buffer, the worker can keep a reference to it instead of copying
+ */
+static bool swReactorThread_is_package_buffer(swServer *serv, swConnection *conn, char *data)
+{
+    swSocket *_socket = conn->socket;
+    if (_socket->recv_package_buffer)
+    {
+        return data == _socket->recv_buffer->str;
+    }
+    swListenPort *port = swServer_get_port(serv, conn->fd);
+    if (port->open_http_protocol && conn->object)
+    {
+        swHttpRequest *request = (swHttpRequest *) conn->object;
+        return request->buffer_protocol && data == request->buffer->str;
+    }
+    return false;
+}
+
 /**
  * dispatch request data [only data frame]
  */
 int swReactorThread_dispatch(swProtocol *proto, swSocket *_socket, char *data, uint32_t length)
+{
+    return swReactorThread_dispatch_with_flags(proto, _socket, data, length, 0);
+}
+
+int swReactorThread_dispatch_batch(swProtocol *proto, swSocket *_socket, char *data, uint32_t length)
+{
+    return swReactorThread_dispatch_with_flags(proto, _socket, data, length, SW_EVENT_DATA_BATCH);
+}
+
+int swReactorThread_dispatch_stream(swProtocol *proto, swSocket *_socket, char *data, uint32_t length, int begin)
+{
+    return swReactorThread_dispatch_with_flags(proto, _socket, data, length, begin ? SW_EVENT_DATA_STREAM_BEGIN : SW_EVENT_DATA_STREAM_BODY);
+}
+
+static int swReactorThread_dispatch_with_flags(swProtocol *proto, swSocket *_socket, char *data, uint32_t length, uint8_t flags)
 {
     swServer *serv = (swServer *) proto->private_data_2;
     swSendData task;
@@ -1174,8 +1587,9 @@ int swReactorThread_dispatch(swProtocol *proto, swSocket *_socket, char *data, u
     task.info.reactor_id = conn->reactor_id;
     task.info.type = SW_SERVER_EVENT_SEND_DATA;
 #ifdef SW_BUFFER_RECV_TIME
-    task.info.info.time = conn->last_time_usec;
+    task.info.time = conn->last_time_usec;
 #endif
+    task.info.flags = flags;
 
     swTrace("send string package, size=%ld bytes", (long)length);
 
@@ -1210,6 +1624,10 @@ int swReactorThread_dispatch(swProtocol *proto, swSocket *_socket, char *data, u
         task.info.fd = conn->fd;
         task.info.len = length;
         task.data = data;
+        if (proto->package_buffer_new && swReactorThread_is_package_buffer(serv, conn, data))
+        {
+            task.info.flags |= SW_EVENT_DATA_OBJ_PTR;
+        }
         return serv->factory.dispatch(&serv->factory, &task);
     }
 }
@@ -1271,8 +1689,152 @@ void swReactorThread_free(swServer *serv)
 {
     serv->factory.free(&serv->factory);
     sw_shm_free(serv->connection_list);
+    sw_shm_free(serv->connection_cold_list);
+    sw_shm_free(serv->connection_index);
+
+    swListenPort *ls;
+    LL_FOREACH(serv->listen_list, ls)
+    {
+        if (ls->reactor_socks)
+        {
+            sw_free(ls->reactor_socks);
+            ls->reactor_socks = nullptr;
+        }
+    }
+}
+
+/**
+ * [master] replace the listen sockets with SO_REUSEPORT ones before the worker processes are forked,
+ * otherwise the reactor threads can not bind the same address
+ */
+int swReactorThread_reuse_port_init(swServer *serv)
+{
+#ifdef HAVE_REUSEPORT
+    swListenPort *ls;
+    LL_FOREACH(serv->listen_list, ls)
+    {
+        if (swSocket_is_dgram(ls->type))
+        {
+            continue;
+        }
+        int sock = swReactorThread_reuse_port_socket(ls);
+        if (sock < 0)
+        {
+            return SW_ERR;
+        }
+        //keep the file descriptor, the socket is never listened
+        if (dup2(sock, ls->sock) < 0)
+        {
+            swSysWarn("dup2(%d, %d) failed", sock, ls->sock);
+            close(sock);
+            return SW_ERR;
+        }
+        close(sock);
+    }
+    return SW_OK;
+#else
+    swWarn("reactor_accept requires SO_REUSEPORT");
+    serv->reactor_accept = 0;
+    return SW_OK;
+#endif
+}
+
+#ifdef HAVE_REUSEPORT
+static int swReactorThread_reuse_port_socket(swListenPort *ls)
+{
+    int sock = swSocket_create(ls->type);
+    if (sock < 0)
+    {
+        swSysWarn("create socket failed");
+        return SW_ERR;
+    }
+    int option = 1;
+    if (setsockopt(sock, SOL_SOCKET, SO_REUSEPORT, &option, sizeof(option)) != 0)
+    {
+        swSysWarn("setsockopt(SO_REUSEPORT) failed");
+        close(sock);
+        return SW_ERR;
+    }
+    if (swSocket_bind(sock, ls->type, ls->host, &ls->port) < 0)
+    {
+        close(sock);
+        return SW_ERR;
+    }
+    swSocket_set_nonblock(sock);
+    return sock;
 }
 
+/**
+ * [master] the sockets join the reuseport group in the order of the reactor id
+ */
+static int swReactorThread_reuse_port_listen(swServer *serv, swListenPort *ls)
+{
+    ls->reactor_socks = (int *) sw_calloc(serv->reactor_num, sizeof(int));
+    if (ls->reactor_socks == nullptr)
+    {
+        swWarn("malloc[reactor_socks] failed");
+        return SW_ERR;
+    }
+
+    int master_sock = ls->sock;
+    for (int i = 0; i < serv->reactor_num; i++)
+    {
+        int sock = swReactorThread_reuse_port_socket(ls);
+        if (sock < 0)
+        {
+            return SW_ERR;
+        }
+        ls->sock = sock;
+        if (swPort_listen(ls) < 0)
+        {
+            ls->sock = master_sock;
+            close(sock);
+            return SW_ERR;
+        }
+        ls->reactor_socks[i] = sock;
+
+        swConnection *conn = &serv->connection_list[sock];
+        conn->fd = sock;
+        conn->socket_type = ls->type;
+        conn->object = ls;
+        conn->cold = swServer_connection_cold(serv, sock);
+        if (ls->type == SW_SOCK_TCP)
+        {
+            conn->cold->info.addr.inet_v4.sin_port = htons(ls->port);
+        }
+        else if (ls->type == SW_SOCK_TCP6)
+        {
+            conn->cold->info.addr.inet_v6.sin6_port = htons(ls->port);
+        }
+    }
+    ls->sock = master_sock;
+
+#ifdef SO_ATTACH_REUSEPORT_CBPF
+    /**
+     * return the index of the socket in the reuseport group: cpu % reactor_num,
+     * the reactor threads should be bound to the CPUs with open_cpu_affinity
+     */
+    if (serv->reactor_accept_cbpf)
+    {
+        struct sock_filter code[] =
+        {
+            { BPF_LD | BPF_W | BPF_ABS, 0, 0, (uint32_t) (SKF_AD_OFF + SKF_AD_CPU) },
+            { BPF_ALU | BPF_MOD | BPF_K, 0, 0, (uint32_t) serv->reactor_num },
+            { BPF_RET | BPF_A, 0, 0, 0 },
+        };
+        struct sock_fprog prog;
+        prog.len = sizeof(code) / sizeof(code[0]);
+        prog.filter = code;
+        if (setsockopt(ls->reactor_socks[0], SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &prog, sizeof(prog)) != 0)
+        {
+            swSysWarn("setsockopt(SO_ATTACH_REUSEPORT_CBPF) failed");
+        }
+    }
+#endif
+    return SW_OK;
+}
+#endif
+
 static void swHeartbeatThread_start(swServer *serv)
 {
     pthread_t thread_id;
@@ -1302,22 +1864,22 @@ static void swHeartbeatThread_loop(swThreadParam *param)
     swReactor *reactor;
 
     int fd;
-    int serv_max_fd;
-    int serv_min_fd;
     int checktime;
+    swConnectionIndex *index = serv->connection_index;
 
     SwooleTG.type = SW_THREAD_HEARTBEAT;
     SwooleTG.id = serv->reactor_num;
 
     while (SwooleG.running)
     {
-        serv_max_fd = swServer_get_maxfd(serv);
-        serv_min_fd = swServer_get_minfd(serv);
-
         checktime = (int) time(NULL) - serv->heartbeat_idle_time;
 
-        for (fd = serv_min_fd; fd <= serv_max_fd; fd++)
+        /**
+         * the reactor threads may remove connections meanwhile, a skipped connection is checked next round
+         */
+        for (uint32_t i = index->count; i > 0; i--)
         {
+            fd = index->fds[i - 1];
             swTrace("check fd=%d", fd);
             conn = swServer_connection_get(serv, fd);
 
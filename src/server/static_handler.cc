@@ -15,16 +15,24 @@
  */
 
 #include "static_handler.h"
+#include "lru_cache.h"
 
 #include <string>
 #include <unordered_set>
 
 using namespace std;
+using swoole::LRUCache;
 using swoole::http::StaticHandler;
+using swoole::http::StaticFile;
 
 unordered_set<string> types;
 unordered_set<string> locations;
 
+/**
+ * the static handler is called in the reactor threads, each thread owns its cache
+ */
+static thread_local LRUCache *static_file_cache = nullptr;
+
 bool StaticHandler::is_modified(const string &date_if_modified_since)
 {
     char date_tmp[64];
@@ -75,6 +83,96 @@ std::string StaticHandler::get_date_last_modified()
     return std::string(date_last_modified);
 }
 
+bool StaticHandler::match_etag(const string &if_none_match, const string &etag)
+{
+    if (if_none_match.empty())
+    {
+        return false;
+    }
+    return if_none_match == "*" || if_none_match.find(etag) != string::npos;
+}
+
+/**
+ * the representations of the different encodings are different entities, each one has its own ETag
+ * "5e8c6b2a-5800" -> "5e8c6b2a-5800-gzip"
+ */
+string StaticHandler::get_etag(const char *content_encoding)
+{
+    const string &etag = get_file()->etag;
+    if (!content_encoding)
+    {
+        return etag;
+    }
+    string encoded_etag(etag, 0, etag.length() - 1);
+    encoded_etag.append("-");
+    encoded_etag.append(content_encoding);
+    encoded_etag.append("\"");
+    return encoded_etag;
+}
+
+static off_t static_file_get_precompressed_size(const string &filename, const char *ext)
+{
+    struct stat file_stat;
+    string sidecar = filename + ext;
+    if (stat(sidecar.c_str(), &file_stat) < 0 || (file_stat.st_mode & S_IFMT) != S_IFREG)
+    {
+        return -1;
+    }
+    return file_stat.st_size;
+}
+
+const StaticFile* StaticHandler::get_file()
+{
+    if (file)
+    {
+        return file.get();
+    }
+
+    file = make_shared<StaticFile>();
+    file->filename.assign(task.filename, l_filename);
+    file->file_stat = file_stat;
+    file->mime_type = swoole_mime_type_get(task.filename);
+    file->last_modified = get_date_last_modified();
+
+    char etag[64];
+    int n = sw_snprintf(etag, sizeof(etag), "\"%lx-%lx\"", (long) get_file_mtime(), (long) get_filesize());
+    file->etag.assign(etag, n);
+
+    if (serv->static_handler_cache_ttl > 0 && get_filesize() <= (off_t) serv->static_handler_cache_max_file_size)
+    {
+        swString *content = swoole_file_get_contents(task.filename);
+        if (content)
+        {
+            file->content.assign(content->str, content->length);
+            swString_free(content);
+        }
+    }
+
+    if (serv->static_handler_precompressed)
+    {
+        file->gzip_size = static_file_get_precompressed_size(file->filename, ".gz");
+        file->br_size = static_file_get_precompressed_size(file->filename, ".br");
+    }
+    else
+    {
+        file->gzip_size = file->br_size = -1;
+    }
+
+    return file.get();
+}
+
+bool StaticHandler::set_precompressed_file(const char *ext, size_t l_ext, off_t size)
+{
+    if (l_filename + l_ext >= sizeof(task.filename))
+    {
+        return false;
+    }
+    memcpy(task.filename + l_filename, ext, l_ext + 1);
+    l_filename += l_ext;
+    task.length = size;
+    return true;
+}
+
 bool StaticHandler::hit()
 {
     char *p = task.filename;
@@ -114,6 +212,26 @@ bool StaticHandler::hit()
         return false;
     }
 
+    string cache_key;
+    if (serv->static_handler_cache_ttl > 0)
+    {
+        if (!static_file_cache)
+        {
+            static_file_cache = new LRUCache(SW_HTTP_STATIC_CACHE_CAPACITY);
+        }
+        cache_key.assign(url, n);
+        auto cache = static_file_cache->get(cache_key);
+        if (cache)
+        {
+            file = static_pointer_cast<StaticFile>(cache);
+            l_filename = file->filename.length();
+            memcpy(task.filename, file->filename.c_str(), l_filename + 1);
+            file_stat = file->file_stat;
+            task.length = get_filesize();
+            return true;
+        }
+    }
+
     memcpy(p, url, n);
     p += n;
     *p = '\0';
@@ -184,6 +302,12 @@ bool StaticHandler::hit()
     }
     task.length = get_filesize();
 
+    if (serv->static_handler_cache_ttl > 0)
+    {
+        get_file();
+        static_file_cache->set(cache_key, file, serv->static_handler_cache_ttl);
+    }
+
     return true;
 }
 
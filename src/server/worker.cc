@@ -17,10 +17,13 @@
 #include "server.h"
 #include "client.h"
 #include "async.h"
+#include "coroutine.h"
 
 #include <pwd.h>
 #include <grp.h>
 
+#include <vector>
+
 static int swWorker_onPipeReceive(swReactor *reactor, swEvent *event);
 static int swWorker_onStreamAccept(swReactor *reactor, swEvent *event);
 static int swWorker_onStreamRead(swReactor *reactor, swEvent *event);
@@ -234,15 +237,190 @@ typedef int (*task_callback)(swServer *, swEventData *);
 
 static sw_inline void swWorker_do_task(swServer *serv, swWorker *worker, swEventData *task, task_callback callback)
 {
+    double begin = swoole_microtime();
 #ifdef SW_BUFFER_RECV_TIME
+    if (task->info.time > 0 && begin > task->info.time)
+    {
+        swHistogram_record(swShardedHistogram_get_shard(serv->stats->queue_time, SwooleWG.id), (begin - task->info.time) * 1000000);
+    }
     serv->last_receive_usec = task->info.time;
 #endif
+
     callback(serv, task);
+
 #ifdef SW_BUFFER_RECV_TIME
     serv->last_receive_usec = 0;
 #endif
+    long handler_time = (swoole_microtime() - begin) * 1000000;
+    swHistogram_record(swShardedHistogram_get_shard(serv->stats->handler_time, SwooleWG.id), handler_time);
+    worker->handler_time += handler_time;
+    worker->coroutine_num = swoole_coro_count();
     worker->request_count++;
-    sw_atomic_fetch_add(&serv->stats->request_count, 1);
+    swCounter_add(serv->stats->request_count, 1);
+}
+
+#ifdef __linux__
+/**
+ * datagrams sent by the server while a batch is being handled, flushed with sendmmsg
+ */
+struct swDgramSendEntry
+{
+    swSocketAddress addr;
+    size_t offset;
+    size_t length;
+};
+
+static bool dgram_send_deferred = false;
+static int dgram_send_sock = -1;
+static std::vector<swDgramSendEntry> dgram_send_queue;
+static swString *dgram_send_buffer = nullptr;
+
+static void swWorker_flush_dgram()
+{
+    size_t n = dgram_send_queue.size();
+    if (n == 0)
+    {
+        return;
+    }
+
+    std::vector<struct mmsghdr> msgs(n);
+    std::vector<struct iovec> iovs(n);
+    for (size_t i = 0; i < n; i++)
+    {
+        swDgramSendEntry *entry = &dgram_send_queue[i];
+        iovs[i].iov_base = dgram_send_buffer->str + entry->offset;
+        iovs[i].iov_len = entry->length;
+        bzero(&msgs[i], sizeof(msgs[i]));
+        msgs[i].msg_hdr.msg_name = &entry->addr.addr;
+        msgs[i].msg_hdr.msg_namelen = entry->addr.len;
+        msgs[i].msg_hdr.msg_iov = &iovs[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    size_t i = 0;
+    while (i < n)
+    {
+        int ret = sendmmsg(dgram_send_sock, &msgs[i], n - i, 0);
+        if (ret > 0)
+        {
+            i += ret;
+            continue;
+        }
+        if (ret < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        //the socket buffer is full, send the rest one by one
+        for (; i < n; i++)
+        {
+            if (swSocket_sendto_blocking(dgram_send_sock, iovs[i].iov_base, iovs[i].iov_len, 0,
+                    (struct sockaddr *) msgs[i].msg_hdr.msg_name, msgs[i].msg_hdr.msg_namelen) < 0)
+            {
+                swSysWarn("sendto(%d) failed", dgram_send_sock);
+                sw_atomic_fetch_add(&SwooleG.serv->stats->dgram_send_fail_count, 1);
+            }
+        }
+    }
+
+    dgram_send_queue.clear();
+    dgram_send_buffer->length = 0;
+}
+
+/**
+ * the datagrams grouped by the reactor thread
+ */
+static void swWorker_do_dgram_batch(swServer *serv, swWorker *worker, swEventData *task)
+{
+    char *data;
+    size_t length = swWorker_get_data(serv, task, &data);
+
+    swPacket_ptr pkt;
+    pkt.info = task->info;
+    pkt.info.type = SW_SERVER_EVENT_SNED_DGRAM;
+    pkt.info.flags = SW_EVENT_DATA_PTR;
+    bzero(&pkt.data, sizeof(pkt.data));
+
+    dgram_send_deferred = true;
+    size_t offset = 0;
+    while (offset + sizeof(swDgramPacket) <= length)
+    {
+        swDgramPacket *packet = (swDgramPacket *) (data + offset);
+        size_t n = sizeof(*packet) + packet->length;
+        pkt.info.len = n;
+        pkt.data.str = (char *) packet;
+        pkt.data.length = n;
+        swWorker_do_task(serv, worker, (swEventData *) &pkt, serv->onPacket);
+        offset += SW_MEM_ALIGNED_SIZE(n);
+    }
+    dgram_send_deferred = false;
+    swWorker_flush_dgram();
+}
+#endif
+
+/**
+ * while onPacket handles a batch the datagram is only queued and the length is returned,
+ * it is sent when the batch is done, a failure is logged and counted in dgram_send_fail_count
+ */
+ssize_t swWorker_udp_sendto(swServer *serv, int server_sock, const char *ip, int port, const char *data, size_t length, int ipv6)
+{
+#ifdef __linux__
+    if (dgram_send_deferred)
+    {
+        swDgramSendEntry entry;
+        bzero(&entry.addr, sizeof(entry.addr));
+        if (ipv6)
+        {
+            if (inet_pton(AF_INET6, ip, &entry.addr.addr.inet_v6.sin6_addr) <= 0)
+            {
+                swWarn("ip[%s] is invalid", ip);
+                return SW_ERR;
+            }
+            entry.addr.addr.inet_v6.sin6_family = AF_INET6;
+            entry.addr.addr.inet_v6.sin6_port = htons(port);
+            entry.addr.len = sizeof(entry.addr.addr.inet_v6);
+        }
+        else
+        {
+            if (inet_aton(ip, &entry.addr.addr.inet_v4.sin_addr) == 0)
+            {
+                swWarn("ip[%s] is invalid", ip);
+                return SW_ERR;
+            }
+            entry.addr.addr.inet_v4.sin_family = AF_INET;
+            entry.addr.addr.inet_v4.sin_port = htons(port);
+            entry.addr.len = sizeof(entry.addr.addr.inet_v4);
+        }
+        if (dgram_send_buffer == nullptr)
+        {
+            dgram_send_buffer = swString_new(SW_BUFFER_SIZE_BIG);
+            if (dgram_send_buffer == nullptr)
+            {
+                return SW_ERR;
+            }
+        }
+        if (dgram_send_queue.size() >= SW_DGRAM_BATCH_MAX || (dgram_send_queue.size() > 0 && dgram_send_sock != server_sock))
+        {
+            swWorker_flush_dgram();
+        }
+        entry.offset = dgram_send_buffer->length;
+        entry.length = length;
+        if (swString_append_ptr(dgram_send_buffer, data, length) < 0)
+        {
+            return SW_ERR;
+        }
+        dgram_send_sock = server_sock;
+        dgram_send_queue.push_back(entry);
+        return length;
+    }
+#endif
+    if (ipv6)
+    {
+        return swSocket_udp_sendto6(server_sock, ip, port, data, length);
+    }
+    else
+    {
+        return swSocket_udp_sendto(server_sock, ip, port, data, length);
+    }
 }
 
 int swWorker_onTask(swFactory *factory, swEventData *task)
@@ -285,13 +463,19 @@ int swWorker_onTask(swFactory *factory, swEventData *task)
         swWorker_do_task(serv, worker, task, serv->onPacket);
         break;
 
+#ifdef __linux__
+    case SW_SERVER_EVENT_SEND_DGRAM_BATCH:
+        swWorker_do_dgram_batch(serv, worker, task);
+        break;
+#endif
+
     case SW_SERVER_EVENT_CLOSE:
 #ifdef SW_USE_OPENSSL
         conn = swServer_connection_verify_no_ssl(serv, task->info.fd);
-        if (conn && conn->ssl_client_cert && conn->ssl_client_cert_pid == SwooleG.pid)
+        if (conn && conn->cold->ssl_client_cert && conn->cold->ssl_client_cert_pid == SwooleG.pid)
         {
-            sw_free(conn->ssl_client_cert);
-            conn->ssl_client_cert = nullptr;
+            sw_free(conn->cold->ssl_client_cert);
+            conn->cold->ssl_client_cert = nullptr;
         }
 #endif
         factory->end(factory, task->info.fd);
@@ -305,8 +489,8 @@ int swWorker_onTask(swFactory *factory, swEventData *task)
             conn = swServer_connection_verify_no_ssl(serv, task->info.fd);
             char *cert_data = NULL;
             size_t length = swWorker_get_data(serv, task, &cert_data);
-            conn->ssl_client_cert = swString_dup(cert_data, length);
-            conn->ssl_client_cert_pid = SwooleG.pid;
+            conn->cold->ssl_client_cert = swString_dup(cert_data, length);
+            conn->cold->ssl_client_cert_pid = SwooleG.pid;
         }
 #endif
         if (serv->onConnect)
@@ -517,12 +701,11 @@ void swWorker_stop(swWorker *worker)
         {
             swReactor_remove_read_event(reactor, worker->pipe_master);
         }
-        int fd;
-        int serv_max_fd = swServer_get_maxfd(serv);
-        int serv_min_fd = swServer_get_minfd(serv);
+        swConnectionIndex *index = serv->connection_index;
 
-        for (fd = serv_min_fd; fd <= serv_max_fd; fd++)
+        for (uint32_t i = index->count; i > 0; i--)
         {
+            int fd = index->fds[i - 1];
             swConnection *conn = swServer_connection_get(serv, fd);
             if (conn && conn->socket && conn->active && !conn->peer_closed && conn->socket->fdtype == SW_FD_SESSION)
             {
@@ -602,6 +602,9 @@ PHP_MINFO_FUNCTION(swoole)
 #ifdef SW_USE_HTTP2
     php_info_print_table_row(2, "http2", "enabled");
 #endif
+#ifdef SW_USE_CURL
+    php_info_print_table_row(2, "curl-native", "enabled");
+#endif
 #ifdef HAVE_PCRE
     php_info_print_table_row(2, "pcre", "enabled");
 #endif
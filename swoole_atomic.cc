@@ -15,6 +15,7 @@
 */
 
 #include "php_swoole.h"
+#include "counter.h"
 
 #ifdef HAVE_FUTEX
 #include <linux/futex.h>
@@ -154,6 +155,91 @@ static zend_object *php_swoole_atomic_long_create_object(zend_class_entry *ce)
     return &atomic_long->std;
 }
 
+typedef struct
+{
+    swCounter *counter;
+    /**
+     * the increments are added to the shared counter every batch_size times
+     */
+    uint32_t batch_size;
+    uint32_t batch_count;
+    zend_long batch_value;
+    /**
+     * the process that owns the batch, it is not inherited by the forked children
+     */
+    pid_t batch_pid;
+    zend_object std;
+} atomic_counter_t;
+
+zend_class_entry *swoole_atomic_counter_ce;
+static zend_object_handlers swoole_atomic_counter_handlers;
+
+static sw_inline atomic_counter_t* php_swoole_atomic_counter_fetch_object(zend_object *obj)
+{
+    return (atomic_counter_t *) ((char *) obj - swoole_atomic_counter_handlers.offset);
+}
+
+static atomic_counter_t* php_swoole_atomic_counter_get_and_check(zval *zobject)
+{
+    atomic_counter_t *atomic_counter = php_swoole_atomic_counter_fetch_object(Z_OBJ_P(zobject));
+    if (UNEXPECTED(!atomic_counter->counter))
+    {
+        php_swoole_fatal_error(E_ERROR, "you must call Counter constructor first");
+    }
+    return atomic_counter;
+}
+
+static void php_swoole_atomic_counter_flush(atomic_counter_t *atomic_counter)
+{
+    if (atomic_counter->batch_count > 0)
+    {
+        if (atomic_counter->batch_pid == SwooleG.pid)
+        {
+            swCounter_add(atomic_counter->counter, atomic_counter->batch_value);
+        }
+        atomic_counter->batch_count = 0;
+        atomic_counter->batch_value = 0;
+    }
+}
+
+static void php_swoole_atomic_counter_batch(atomic_counter_t *atomic_counter, zend_long value)
+{
+    /**
+     * the batch inherited from the parent is added by the parent, the child starts its own one
+     */
+    if (atomic_counter->batch_count == 0 || atomic_counter->batch_pid != SwooleG.pid)
+    {
+        atomic_counter->batch_pid = SwooleG.pid;
+        atomic_counter->batch_count = 0;
+        atomic_counter->batch_value = 0;
+    }
+    atomic_counter->batch_value += value;
+    if (++atomic_counter->batch_count >= atomic_counter->batch_size)
+    {
+        php_swoole_atomic_counter_flush(atomic_counter);
+    }
+}
+
+static void php_swoole_atomic_counter_free_object(zend_object *object)
+{
+    atomic_counter_t *atomic_counter = php_swoole_atomic_counter_fetch_object(object);
+    if (atomic_counter->counter)
+    {
+        php_swoole_atomic_counter_flush(atomic_counter);
+        swCounter_free(atomic_counter->counter, 1);
+    }
+    zend_object_std_dtor(object);
+}
+
+static zend_object *php_swoole_atomic_counter_create_object(zend_class_entry *ce)
+{
+    atomic_counter_t *atomic_counter = (atomic_counter_t *) ecalloc(1, sizeof(atomic_counter_t) + zend_object_properties_size(ce));
+    zend_object_std_init(&atomic_counter->std, ce);
+    object_properties_init(&atomic_counter->std, ce);
+    atomic_counter->std.handlers = &swoole_atomic_counter_handlers;
+    return &atomic_counter->std;
+}
+
 static PHP_METHOD(swoole_atomic, __construct);
 static PHP_METHOD(swoole_atomic, add);
 static PHP_METHOD(swoole_atomic, sub);
@@ -170,10 +256,22 @@ static PHP_METHOD(swoole_atomic_long, get);
 static PHP_METHOD(swoole_atomic_long, set);
 static PHP_METHOD(swoole_atomic_long, cmpset);
 
+static PHP_METHOD(swoole_atomic_counter, __construct);
+static PHP_METHOD(swoole_atomic_counter, add);
+static PHP_METHOD(swoole_atomic_counter, sub);
+static PHP_METHOD(swoole_atomic_counter, get);
+static PHP_METHOD(swoole_atomic_counter, set);
+static PHP_METHOD(swoole_atomic_counter, flush);
+
 ZEND_BEGIN_ARG_INFO_EX(arginfo_swoole_atomic_construct, 0, 0, 0)
     ZEND_ARG_INFO(0, value)
 ZEND_END_ARG_INFO()
 
+ZEND_BEGIN_ARG_INFO_EX(arginfo_swoole_atomic_counter_construct, 0, 0, 0)
+    ZEND_ARG_INFO(0, slot_num)
+    ZEND_ARG_INFO(0, batch_size)
+ZEND_END_ARG_INFO()
+
 ZEND_BEGIN_ARG_INFO_EX(arginfo_swoole_atomic_add, 0, 0, 0)
     ZEND_ARG_INFO(0, add_value)
 ZEND_END_ARG_INFO()
@@ -226,6 +324,17 @@ static const zend_function_entry swoole_atomic_long_methods[] =
     PHP_FE_END
 };
 
+static const zend_function_entry swoole_atomic_counter_methods[] =
+{
+    PHP_ME(swoole_atomic_counter, __construct, arginfo_swoole_atomic_counter_construct, ZEND_ACC_PUBLIC)
+    PHP_ME(swoole_atomic_counter, add, arginfo_swoole_atomic_add, ZEND_ACC_PUBLIC)
+    PHP_ME(swoole_atomic_counter, sub, arginfo_swoole_atomic_sub, ZEND_ACC_PUBLIC)
+    PHP_ME(swoole_atomic_counter, get, arginfo_swoole_atomic_get, ZEND_ACC_PUBLIC)
+    PHP_ME(swoole_atomic_counter, set, arginfo_swoole_atomic_set, ZEND_ACC_PUBLIC)
+    PHP_ME(swoole_atomic_counter, flush, arginfo_swoole_atomic_get, ZEND_ACC_PUBLIC)
+    PHP_FE_END
+};
+
 void php_swoole_atomic_minit(int module_number)
 {
     SW_INIT_CLASS_ENTRY(swoole_atomic, "Swoole\\Atomic", "swoole_atomic", NULL, swoole_atomic_methods);
@@ -239,6 +348,12 @@ void php_swoole_atomic_minit(int module_number)
     SW_SET_CLASS_CLONEABLE(swoole_atomic_long, sw_zend_class_clone_deny);
     SW_SET_CLASS_UNSET_PROPERTY_HANDLER(swoole_atomic_long, sw_zend_class_unset_property_deny);
     SW_SET_CLASS_CUSTOM_OBJECT(swoole_atomic_long, php_swoole_atomic_long_create_object, php_swoole_atomic_long_free_object, atomic_long_t, std);
+
+    SW_INIT_CLASS_ENTRY(swoole_atomic_counter, "Swoole\\Atomic\\Counter", "swoole_atomic_counter", NULL, swoole_atomic_counter_methods);
+    SW_SET_CLASS_SERIALIZABLE(swoole_atomic_counter, zend_class_serialize_deny, zend_class_unserialize_deny);
+    SW_SET_CLASS_CLONEABLE(swoole_atomic_counter, sw_zend_class_clone_deny);
+    SW_SET_CLASS_UNSET_PROPERTY_HANDLER(swoole_atomic_counter, sw_zend_class_unset_property_deny);
+    SW_SET_CLASS_CUSTOM_OBJECT(swoole_atomic_counter, php_swoole_atomic_counter_create_object, php_swoole_atomic_counter_free_object, atomic_counter_t, std);
 }
 
 PHP_METHOD(swoole_atomic, __construct)
@@ -430,3 +545,104 @@ PHP_METHOD(swoole_atomic_long, cmpset)
 
     RETURN_BOOL(sw_atomic_cmp_set(atomic_long, (sw_atomic_long_t) cmp_value, (sw_atomic_long_t) set_value));
 }
+
+PHP_METHOD(swoole_atomic_counter, __construct)
+{
+    atomic_counter_t *atomic_counter = php_swoole_atomic_counter_fetch_object(Z_OBJ_P(ZEND_THIS));
+    zend_long slot_num = 0;
+    zend_long batch_size = 0;
+
+    ZEND_PARSE_PARAMETERS_START_EX(ZEND_PARSE_PARAMS_THROW, 0, 2)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_LONG(slot_num)
+        Z_PARAM_LONG(batch_size)
+    ZEND_PARSE_PARAMETERS_END_EX(RETURN_FALSE);
+
+    if (atomic_counter->counter)
+    {
+        php_swoole_fatal_error(E_ERROR, "Constructor of %s can only be called once", SW_Z_OBJCE_NAME_VAL_P(ZEND_THIS));
+        RETURN_FALSE;
+    }
+
+    atomic_counter->counter = swCounter_new(SW_MAX(SW_MIN(slot_num, (zend_long) UINT16_MAX), 0), 1);
+    if (atomic_counter->counter == NULL)
+    {
+        zend_throw_exception(swoole_exception_ce, "global memory allocation failure", SW_ERROR_MALLOC_FAIL);
+        RETURN_FALSE;
+    }
+    atomic_counter->batch_size = SW_MAX(SW_MIN(batch_size, (zend_long) UINT32_MAX), 0);
+}
+
+PHP_METHOD(swoole_atomic_counter, add)
+{
+    atomic_counter_t *atomic_counter = php_swoole_atomic_counter_get_and_check(ZEND_THIS);
+    zend_long add_value = 1;
+
+    ZEND_PARSE_PARAMETERS_START(0, 1)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_LONG(add_value)
+    ZEND_PARSE_PARAMETERS_END_EX(RETURN_FALSE);
+
+    if (atomic_counter->batch_size > 1)
+    {
+        php_swoole_atomic_counter_batch(atomic_counter, add_value);
+    }
+    else
+    {
+        swCounter_add(atomic_counter->counter, add_value);
+    }
+    RETURN_TRUE;
+}
+
+PHP_METHOD(swoole_atomic_counter, sub)
+{
+    atomic_counter_t *atomic_counter = php_swoole_atomic_counter_get_and_check(ZEND_THIS);
+    zend_long sub_value = 1;
+
+    ZEND_PARSE_PARAMETERS_START(0, 1)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_LONG(sub_value)
+    ZEND_PARSE_PARAMETERS_END_EX(RETURN_FALSE);
+
+    if (atomic_counter->batch_size > 1)
+    {
+        php_swoole_atomic_counter_batch(atomic_counter, -sub_value);
+    }
+    else
+    {
+        swCounter_sub(atomic_counter->counter, sub_value);
+    }
+    RETURN_TRUE;
+}
+
+/**
+ * the pending batch of the current process is flushed first,
+ * the ones of the other processes are not seen
+ */
+PHP_METHOD(swoole_atomic_counter, get)
+{
+    atomic_counter_t *atomic_counter = php_swoole_atomic_counter_get_and_check(ZEND_THIS);
+    php_swoole_atomic_counter_flush(atomic_counter);
+    RETURN_LONG(swCounter_get(atomic_counter->counter));
+}
+
+PHP_METHOD(swoole_atomic_counter, set)
+{
+    atomic_counter_t *atomic_counter = php_swoole_atomic_counter_get_and_check(ZEND_THIS);
+    zend_long set_value;
+
+    ZEND_PARSE_PARAMETERS_START(1, 1)
+        Z_PARAM_LONG(set_value)
+    ZEND_PARSE_PARAMETERS_END_EX(RETURN_FALSE);
+
+    atomic_counter->batch_count = 0;
+    atomic_counter->batch_value = 0;
+    swCounter_set(atomic_counter->counter, set_value);
+}
+
+PHP_METHOD(swoole_atomic_counter, flush)
+{
+    atomic_counter_t *atomic_counter = php_swoole_atomic_counter_get_and_check(ZEND_THIS);
+    php_swoole_atomic_counter_flush(atomic_counter);
+    RETURN_TRUE;
+}
@@ -35,11 +35,14 @@ typedef struct
 static PHP_METHOD(swoole_channel_coro, __construct);
 static PHP_METHOD(swoole_channel_coro, push);
 static PHP_METHOD(swoole_channel_coro, pop);
+static PHP_METHOD(swoole_channel_coro, pushMany);
+static PHP_METHOD(swoole_channel_coro, popMany);
 static PHP_METHOD(swoole_channel_coro, close);
 static PHP_METHOD(swoole_channel_coro, stats);
 static PHP_METHOD(swoole_channel_coro, length);
 static PHP_METHOD(swoole_channel_coro, isEmpty);
 static PHP_METHOD(swoole_channel_coro, isFull);
+static PHP_METHOD(swoole_channel_coro, select);
 
 ZEND_BEGIN_ARG_INFO_EX(arginfo_swoole_channel_coro_construct, 0, 0, 0)
     ZEND_ARG_INFO(0, size)
@@ -54,6 +57,22 @@ ZEND_BEGIN_ARG_INFO_EX(arginfo_swoole_channel_coro_pop, 0, 0, 0)
     ZEND_ARG_INFO(0, timeout)
 ZEND_END_ARG_INFO()
 
+ZEND_BEGIN_ARG_INFO_EX(arginfo_swoole_channel_coro_pushMany, 0, 0, 1)
+    ZEND_ARG_ARRAY_INFO(0, data_list, 0)
+    ZEND_ARG_INFO(0, timeout)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_swoole_channel_coro_popMany, 0, 0, 1)
+    ZEND_ARG_INFO(0, max_num)
+    ZEND_ARG_INFO(0, timeout)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_swoole_channel_coro_select, 0, 0, 1)
+    ZEND_ARG_ARRAY_INFO(0, read_list, 0)
+    ZEND_ARG_ARRAY_INFO(0, write_list, 1)
+    ZEND_ARG_INFO(0, timeout)
+ZEND_END_ARG_INFO()
+
 ZEND_BEGIN_ARG_INFO_EX(arginfo_swoole_void, 0, 0, 0)
 ZEND_END_ARG_INFO()
 
@@ -62,11 +81,14 @@ static const zend_function_entry swoole_channel_coro_methods[] =
     PHP_ME(swoole_channel_coro, __construct, arginfo_swoole_channel_coro_construct, ZEND_ACC_PUBLIC)
     PHP_ME(swoole_channel_coro, push, arginfo_swoole_channel_coro_push, ZEND_ACC_PUBLIC)
     PHP_ME(swoole_channel_coro, pop,  arginfo_swoole_channel_coro_pop,  ZEND_ACC_PUBLIC)
+    PHP_ME(swoole_channel_coro, pushMany, arginfo_swoole_channel_coro_pushMany, ZEND_ACC_PUBLIC)
+    PHP_ME(swoole_channel_coro, popMany, arginfo_swoole_channel_coro_popMany, ZEND_ACC_PUBLIC)
     PHP_ME(swoole_channel_coro, isEmpty, arginfo_swoole_void, ZEND_ACC_PUBLIC)
     PHP_ME(swoole_channel_coro, isFull, arginfo_swoole_void, ZEND_ACC_PUBLIC)
     PHP_ME(swoole_channel_coro, close, arginfo_swoole_void, ZEND_ACC_PUBLIC)
     PHP_ME(swoole_channel_coro, stats, arginfo_swoole_void, ZEND_ACC_PUBLIC)
     PHP_ME(swoole_channel_coro, length, arginfo_swoole_void, ZEND_ACC_PUBLIC)
+    PHP_ME(swoole_channel_coro, select, arginfo_swoole_channel_coro_select, ZEND_ACC_PUBLIC | ZEND_ACC_STATIC)
     PHP_FE_END
 };
 
@@ -132,6 +154,9 @@ void php_swoole_channel_coro_minit(int module_number)
     zend_declare_property_long(swoole_channel_coro_ce, ZEND_STRL("capacity"), 0, ZEND_ACC_PUBLIC);
     zend_declare_property_long(swoole_channel_coro_ce, ZEND_STRL("errCode"), 0, ZEND_ACC_PUBLIC);
 
+    zend_declare_class_constant_long(swoole_channel_coro_ce, ZEND_STRL("PUSH"), Channel::PRODUCER);
+    zend_declare_class_constant_long(swoole_channel_coro_ce, ZEND_STRL("POP"), Channel::CONSUMER);
+
     SW_REGISTER_LONG_CONSTANT("SWOOLE_CHANNEL_OK", SW_CHANNEL_OK);
     SW_REGISTER_LONG_CONSTANT("SWOOLE_CHANNEL_TIMEOUT", SW_CHANNEL_TIMEOUT);
     SW_REGISTER_LONG_CONSTANT("SWOOLE_CHANNEL_CLOSED", SW_CHANNEL_CLOSED);
@@ -226,6 +251,107 @@ static PHP_METHOD(swoole_channel_coro, pop)
     }
 }
 
+/**
+ * push the elements which fit into the channel, return the number of pushed elements
+ */
+static PHP_METHOD(swoole_channel_coro, pushMany)
+{
+    Channel *chan = php_swoole_get_channel(ZEND_THIS);
+    if (chan->is_closed())
+    {
+        zend_update_property_long(swoole_channel_coro_ce, ZEND_THIS, ZEND_STRL("errCode"), SW_CHANNEL_CLOSED);
+        RETURN_FALSE;
+    }
+    else
+    {
+        zend_update_property_long(swoole_channel_coro_ce, ZEND_THIS, ZEND_STRL("errCode"), SW_CHANNEL_OK);
+    }
+
+    zval *zdata_list;
+    double timeout = -1;
+
+    ZEND_PARSE_PARAMETERS_START_EX(ZEND_PARSE_PARAMS_THROW, 1, 2)
+        Z_PARAM_ARRAY(zdata_list)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_DOUBLE(timeout)
+    ZEND_PARSE_PARAMETERS_END_EX(RETURN_FALSE);
+
+    uint32_t n = zend_hash_num_elements(Z_ARRVAL_P(zdata_list));
+    if (n == 0)
+    {
+        RETURN_LONG(0);
+    }
+
+    std::vector<void *> items;
+    items.reserve(n);
+    zval *zdata;
+    ZEND_HASH_FOREACH_VAL(Z_ARRVAL_P(zdata_list), zdata)
+    {
+        Z_TRY_ADDREF_P(zdata);
+        items.push_back(sw_zval_dup(zdata));
+    }
+    ZEND_HASH_FOREACH_END();
+
+    size_t count = chan->push_many(items.data(), n, timeout);
+    for (size_t i = count; i < n; i++)
+    {
+        sw_zval_free((zval *) items[i]);
+    }
+    if (count == 0)
+    {
+        zend_update_property_long(swoole_channel_coro_ce, ZEND_THIS, ZEND_STRL("errCode"), chan->is_closed() ? SW_CHANNEL_CLOSED : SW_CHANNEL_TIMEOUT);
+        RETURN_FALSE;
+    }
+    RETURN_LONG(count);
+}
+
+/**
+ * pop up to $max_num elements at once
+ */
+static PHP_METHOD(swoole_channel_coro, popMany)
+{
+    Channel *chan = php_swoole_get_channel(ZEND_THIS);
+    if (chan->is_closed())
+    {
+        zend_update_property_long(swoole_channel_coro_ce, ZEND_THIS, ZEND_STRL("errCode"), SW_CHANNEL_CLOSED);
+        RETURN_FALSE;
+    }
+    else
+    {
+        zend_update_property_long(swoole_channel_coro_ce, ZEND_THIS, ZEND_STRL("errCode"), SW_CHANNEL_OK);
+    }
+
+    zend_long max_num;
+    double timeout = -1;
+
+    ZEND_PARSE_PARAMETERS_START_EX(ZEND_PARSE_PARAMS_THROW, 1, 2)
+        Z_PARAM_LONG(max_num)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_DOUBLE(timeout)
+    ZEND_PARSE_PARAMETERS_END_EX(RETURN_FALSE);
+
+    if (max_num <= 0)
+    {
+        php_swoole_fatal_error(E_WARNING, "max_num must be greater than 0");
+        RETURN_FALSE;
+    }
+
+    std::vector<void *> items(SW_MIN((size_t) max_num, chan->get_capacity()));
+    size_t count = chan->pop_many(items.data(), items.size(), timeout);
+    if (count == 0)
+    {
+        zend_update_property_long(swoole_channel_coro_ce, ZEND_THIS, ZEND_STRL("errCode"), chan->is_closed() ? SW_CHANNEL_CLOSED : SW_CHANNEL_TIMEOUT);
+        RETURN_FALSE;
+    }
+    array_init_size(return_value, count);
+    for (size_t i = 0; i < count; i++)
+    {
+        zval *zdata = (zval *) items[i];
+        add_next_index_zval(return_value, zdata);
+        efree(zdata);
+    }
+}
+
 static PHP_METHOD(swoole_channel_coro, close)
 {
     Channel *chan = php_swoole_get_channel(ZEND_THIS);
@@ -259,3 +385,104 @@ static PHP_METHOD(swoole_channel_coro, stats)
     add_assoc_long_ex(return_value, ZEND_STRL("queue_num"), chan->length());
 }
 
+
+/**
+ * $read_list is a list of channels to pop from, $write_list is a list of [channel, data] pairs,
+ * return false on timeout, or the first case which was done: [channel, opcode, data]
+ */
+static PHP_METHOD(swoole_channel_coro, select)
+{
+    zval *zread_list;
+    zval *zwrite_list = nullptr;
+    double timeout = -1;
+
+    ZEND_PARSE_PARAMETERS_START_EX(ZEND_PARSE_PARAMS_THROW, 1, 3)
+        Z_PARAM_ARRAY(zread_list)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_ARRAY_EX(zwrite_list, 1, 0)
+        Z_PARAM_DOUBLE(timeout)
+    ZEND_PARSE_PARAMETERS_END_EX(RETURN_FALSE);
+
+    std::vector<Channel::select_case_t> cases;
+    std::vector<zval *> zchans;
+    zval *zchan;
+
+    ZEND_HASH_FOREACH_VAL(Z_ARRVAL_P(zread_list), zchan)
+    {
+        if (Z_TYPE_P(zchan) != IS_OBJECT || !instanceof_function(Z_OBJCE_P(zchan), swoole_channel_coro_ce))
+        {
+            php_swoole_fatal_error(E_WARNING, "the read list can only contain channels");
+            RETURN_FALSE;
+        }
+        cases.push_back({php_swoole_get_channel(zchan), Channel::CONSUMER, nullptr, false});
+        zchans.push_back(zchan);
+    }
+    ZEND_HASH_FOREACH_END();
+
+    if (zwrite_list)
+    {
+        zval *zcase;
+        ZEND_HASH_FOREACH_VAL(Z_ARRVAL_P(zwrite_list), zcase)
+        {
+            zval *zdata;
+            if (Z_TYPE_P(zcase) != IS_ARRAY || !(zchan = zend_hash_index_find(Z_ARRVAL_P(zcase), 0))
+                    || !(zdata = zend_hash_index_find(Z_ARRVAL_P(zcase), 1))
+                    || Z_TYPE_P(zchan) != IS_OBJECT || !instanceof_function(Z_OBJCE_P(zchan), swoole_channel_coro_ce))
+            {
+                php_swoole_fatal_error(E_WARNING, "the write list can only contain [channel, data] pairs");
+                for (auto &_case : cases)
+                {
+                    if (_case.type == Channel::PRODUCER)
+                    {
+                        sw_zval_free((zval *) _case.data);
+                    }
+                }
+                RETURN_FALSE;
+            }
+            Z_TRY_ADDREF_P(zdata);
+            cases.push_back({php_swoole_get_channel(zchan), Channel::PRODUCER, sw_zval_dup(zdata), false});
+            zchans.push_back(zchan);
+        }
+        ZEND_HASH_FOREACH_END();
+    }
+
+    int i = Channel::select(cases, timeout);
+    for (size_t j = 0; j < cases.size(); j++)
+    {
+        /**
+         * the data of the cases which were not done is still owned by us, the pushed data is owned by the consumer,
+         * which may have closed the channel already
+         */
+        if (cases[j].type == Channel::PRODUCER && ((int) j != i || cases[j].closed))
+        {
+            sw_zval_free((zval *) cases[j].data);
+        }
+    }
+    if (i < 0)
+    {
+        RETURN_FALSE;
+    }
+
+    Channel::select_case_t *_case = &cases[i];
+    zchan = zchans[i];
+    zend_update_property_long(swoole_channel_coro_ce, zchan, ZEND_STRL("errCode"), _case->closed ? SW_CHANNEL_CLOSED : SW_CHANNEL_OK);
+
+    array_init(return_value);
+    Z_ADDREF_P(zchan);
+    add_next_index_zval(return_value, zchan);
+    add_next_index_long(return_value, _case->type);
+    if (_case->closed)
+    {
+        add_next_index_bool(return_value, 0);
+    }
+    else if (_case->type == Channel::CONSUMER)
+    {
+        zval *zdata = (zval *) _case->data;
+        add_next_index_zval(return_value, zdata);
+        efree(zdata);
+    }
+    else
+    {
+        add_next_index_bool(return_value, 1);
+    }
+}
@@ -312,6 +312,10 @@ void php_swoole_client_check_ssl_setting(swClient *cli, zval *zset)
     {
         cli->ssl_option.allow_self_signed = zval_is_true(ztmp);
     }
+    if (php_swoole_array_get_value(vht, "ssl_ktls", ztmp))
+    {
+        cli->ssl_option.ktls = zval_is_true(ztmp);
+    }
     if (php_swoole_array_get_value(vht, "ssl_cafile", ztmp))
     {
         zend::string str_v(ztmp);
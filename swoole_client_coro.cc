@@ -576,6 +576,10 @@ bool php_swoole_socket_set_ssl(Socket *sock, zval *zset)
     {
         sock->ssl_option.allow_self_signed = zval_is_true(ztmp);
     }
+    if (php_swoole_array_get_value(vht, "ssl_ktls", ztmp))
+    {
+        sock->ssl_option.ktls = zval_is_true(ztmp);
+    }
     if (php_swoole_array_get_value(vht, "ssl_cafile", ztmp))
     {
         if (sock->ssl_option.cafile)
@@ -1131,8 +1131,8 @@ PHP_METHOD(swoole_coroutine, list)
 {
     zval zlist;
     array_init(&zlist);
-    for (auto &co : Coroutine::coroutines) {
-        add_next_index_long(&zlist, co.second->get_cid());
+    for (Coroutine *co : Coroutine::coroutines) {
+        add_next_index_long(&zlist, co->get_cid());
     }
     object_init_ex(return_value, swoole_coroutine_iterator_ce);
     sw_zend_call_method_with_1_params(
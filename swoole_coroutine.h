@@ -42,6 +42,7 @@ enum sw_coro_hook_type
     SW_HOOK_FILE              = 1u << 8,
     SW_HOOK_SLEEP             = 1u << 9,
     SW_HOOK_PROC              = 1u << 10,
+    SW_HOOK_NATIVE_CURL       = 1u << 11,
     SW_HOOK_CURL              = 1u << 28,
     SW_HOOK_BLOCKING_FUNCTION = 1u << 30,
 
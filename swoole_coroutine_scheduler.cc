@@ -165,6 +165,10 @@ PHP_METHOD(swoole_coroutine_scheduler, set)
     {
         Coroutine::set_stack_size(zval_get_long(ztmp));
     }
+    if (php_swoole_array_get_value(vht, "coroutine_pool_size", ztmp))
+    {
+        Coroutine::set_pool_size((size_t) SW_MAX(0, zval_get_long(ztmp)));
+    }
     if (php_swoole_array_get_value(vht, "socket_connect_timeout", ztmp))
     {
         double t = zval_get_double(ztmp);
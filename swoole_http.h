@@ -22,6 +22,8 @@
 #include "thirdparty/multipart_parser.h"
 
 #include <unordered_map>
+#include <string>
+#include <vector>
 
 #ifdef SW_HAVE_ZLIB
 #include <zlib.h>
@@ -54,6 +56,11 @@ enum http_compress_method
     HTTP_COMPRESS_BR,
 };
 
+#ifdef SW_HAVE_COMPRESSION
+struct http_compress_stream;
+#endif
+struct http_batch;
+
 struct http_request
 {
     int version;
@@ -68,6 +75,11 @@ struct http_request
 #ifdef SW_USE_HTTP2
     swString *h2_data_buffer;
 #endif
+    /**
+     * the streamed body which has been received but not read yet
+     */
+    swString *stream_buffer;
+    size_t stream_length;
 
     // Notice: Do not change the order
     zval *zobject;
@@ -94,6 +106,10 @@ struct http_response
     int version;
     int status;
     char* reason;
+    /**
+     * id of the header template registered by Response::createHeaderTemplate(), 0 means none
+     */
+    uint32_t header_template;
 
     // Notice: Do not change the order
     zval *zobject;
@@ -128,15 +144,35 @@ struct http_context
     uint32_t parse_body :1;
     uint32_t parse_files :1;
     uint32_t co_socket :1;
+    /**
+     * the body arrives after the header in the following messages (see http_body_stream)
+     */
+    uint32_t stream_body :1;
+    uint32_t stream_aborted :1;
+    /**
+     * the reactor has stopped reading the connection until Request::read() drains the buffered body
+     */
+    uint32_t stream_paused :1;
 
 #ifdef SW_HAVE_COMPRESSION
     int8_t compression_level;
     int8_t compression_method;
+    http_compress_stream *compress_stream;
 #endif
 
 #ifdef SW_USE_HTTP2
     void* stream;
 #endif
+    /**
+     * the pipelined requests dispatched together, their responses are sent in order
+     */
+    http_batch *batch;
+    uint32_t batch_index;
+    /**
+     * the coroutine waiting in Request::read()
+     */
+    swoole::Coroutine *stream_reader;
+
     http_request request;
     http_response response;
 
@@ -235,9 +271,29 @@ static sw_inline zval* swoole_http_init_and_read_property(zend_class_entry *ce,
     }
     return *zproperty_store_pp;
 }
+/**
+ * pre-formatted header lines registered by Response::createHeaderTemplate()
+ */
+struct http_header_template
+{
+    /**
+     * the HTTP/1.1 header lines, appended at once when none of them is overridden by the response
+     */
+    std::string data;
+    uint32_t header_flag;
+    /**
+     * the keys (in lower case) and values, for HTTP/2 and the responses overriding some of them
+     */
+    std::vector<std::pair<std::string, std::string>> headers;
+};
+
+http_header_template* swoole_http_get_header_template(uint32_t id);
+bool swoole_http_has_header(zval *zheader, const char *key, size_t keylen);
+
 int swoole_http_parse_form_data(http_context *ctx, const char *boundary_str, int boundary_len);
 void swoole_http_parse_cookie(zval *array, const char *at, size_t length);
 void swoole_http_server_init_context(swServer *serv, http_context *ctx);
+void swoole_http_batch_complete(http_context *ctx);
 
 http_context * php_swoole_http_request_get_context(zval *zobject);
 void php_swoole_http_request_set_context(zval *zobject, http_context *context);
@@ -246,10 +302,14 @@ void php_swoole_http_response_set_context(zval *zobject, http_context *context);
 size_t swoole_http_requset_parse(http_context *ctx, const char *data, size_t length);
 
 bool swoole_http_response_set_header(http_context *ctx, const char *k, size_t klen, const char *v, size_t vlen, bool ucwords);
+const char* swoole_http_get_date(size_t *length);
 void swoole_http_response_end(http_context *ctx, zval *zdata, zval *return_value);
 
 #ifdef SW_HAVE_COMPRESSION
 int swoole_http_response_compress(swString *body, int method, int level);
+http_compress_stream* swoole_http_compress_stream_new(int method, int level);
+int swoole_http_compress_stream_write(http_compress_stream *stream, const char *data, size_t length, bool finish);
+void swoole_http_compress_stream_free(http_compress_stream *stream);
 void swoole_http_get_compression_method(http_context *ctx, const char *accept_encoding, size_t length);
 const char* swoole_http_get_content_encoding(http_context *ctx);
 #endif
@@ -24,7 +24,11 @@
 
 #define HTTP2_CLIENT_HOST_HEADER_INDEX   3
 
+#include <algorithm>
 #include <vector>
+#include <deque>
+#include <string>
+#include <unordered_map>
 
 using namespace swoole;
 using swoole::coroutine::Socket;
@@ -59,6 +63,21 @@ struct http2_client_stream
     uint32_t local_window_size;
 };
 
+/**
+ * a coroutine waiting for the response of its stream in request()
+ */
+struct http2_client_waiter
+{
+    Coroutine *co;
+    zval zresponse;
+    swTimer_node *timer;
+    bool done;
+    bool timedout;
+};
+
+class http2_session_pool;
+static void http2_session_pool_wakeup(http2_session_pool *pool);
+
 class http2_client
 {
 public:
@@ -75,11 +94,49 @@ public:
     uint32_t stream_id = 0; // the next send stream id
     uint32_t last_stream_id = 0; // the last received stream id
 
+    /**
+     * the settings sent on the current connection
+     */
     swHttp2_settings local_settings = {0};
     swHttp2_settings remote_settings = {0};
+    /**
+     * the settings for the next connection, set() does not change the live one
+     */
+    swHttp2_settings next_settings = {0};
 
     swHashMap *streams = nullptr;
 
+    /**
+     * connection-level receive window
+     */
+    uint32_t local_window_size = SW_HTTP2_DEFAULT_WINDOW_SIZE;
+
+    /**
+     * the requests of the concurrent coroutines share the connection,
+     * the frames are read by one of them and dispatched to the others by stream id
+     */
+    std::unordered_map<uint32_t, http2_client_waiter *> waiters;
+    bool reading = false;
+
+    /**
+     * the frames of one request (and the HPACK state) must not interleave with the others
+     */
+    Coroutine *write_owner = nullptr;
+    std::deque<Coroutine *> write_waiters;
+
+    /**
+     * max number of the shared connections to the origin, 0 means disabled
+     */
+    uint32_t shared_sessions = 0;
+    /**
+     * the requests in flight when it works as a shared session
+     */
+    uint32_t pending_requests = 0;
+    /**
+     * the pool which owns it when it works as a shared session
+     */
+    http2_session_pool *pool = nullptr;
+
     /* safety zval */
     zval _zobject;
     zval *zobject;
@@ -91,7 +148,12 @@ public:
         ssl = _ssl;
         _zobject = *__zobject;
         zobject = &_zobject;
-        swHttp2_init_settings(&local_settings);
+        swHttp2_init_settings(&next_settings);
+        next_settings.header_table_size = SW_HTTP2_CLIENT_HEADER_TABLE_SIZE;
+        next_settings.window_size = SW_HTTP2_CLIENT_WINDOW_SIZE;
+        local_settings = next_settings;
+        // the server is assumed to take the defaults until its SETTINGS arrive
+        swHttp2_init_settings(&remote_settings);
     }
 
     inline http2_client_stream* get_stream(uint32_t stream_id)
@@ -135,6 +197,31 @@ public:
         }
     }
 
+    /**
+     * the options of the session, they take effect on the next connection
+     */
+    inline void apply_http2_setting(zval *zset)
+    {
+        HashTable *vht = Z_ARRVAL_P(zset);
+        zval *ztmp;
+
+        if (php_swoole_array_get_value(vht, "header_table_size", ztmp))
+        {
+            zend_long v = zval_get_long(ztmp);
+            next_settings.header_table_size = SW_MAX(SW_MIN(v, (zend_long) UINT32_MAX), 0);
+        }
+        if (php_swoole_array_get_value(vht, "window_size", ztmp))
+        {
+            zend_long v = zval_get_long(ztmp);
+            next_settings.window_size = SW_MAX(SW_MIN(v, (zend_long) SW_HTTP2_MAX_WINDOW_SIZE), SW_HTTP2_DEFAULT_WINDOW_SIZE);
+        }
+        if (php_swoole_array_get_value(vht, "shared_sessions", ztmp))
+        {
+            zend_long v = zval_get_long(ztmp);
+            shared_sessions = SW_MAX(SW_MIN(v, (zend_long) UINT16_MAX), 0);
+        }
+    }
+
     inline bool recv_packet(double timeout)
     {
         if (sw_unlikely(client->recv_packet(timeout) <= 0))
@@ -152,9 +239,14 @@ public:
     bool send_data(uint32_t stream_id, zval *data, bool end);
     uint32_t send_request(zval *req);
     bool send_goaway_frame(zend_long error_code, const char *debug_data, size_t debug_data_len);
+    bool send_rst_stream(uint32_t stream_id, uint32_t error_code);
     enum swReturn_code parse_frame(zval *return_value);
+    bool request(zval *req, zval *return_value, double deadline);
     bool close();
 
+    bool lock_write();
+    void unlock_write();
+
     ~http2_client()
     {
         close();
@@ -162,18 +254,56 @@ public:
 private:
     bool send_setting();
     int parse_header(http2_client_stream *stream , int flags, char *in, size_t inlen);
+    bool drop_frame(uint8_t type, int flags, char *in, size_t inlen);
+    bool consume_window(http2_client_stream *stream, uint32_t stream_id, size_t length);
+
+    void wakeup(uint32_t stream_id, zval *zresponse);
+    void wakeup_reader();
+    void wakeup_all();
 
     inline bool send(const char *buf, size_t len)
     {
-        if (sw_unlikely(client->send_all(buf, len) != (ssize_t )len))
+        bool locked = lock_write();
+        bool retval = true;
+        if (sw_unlikely(!client))
+        {
+            is_available();
+            retval = false;
+        }
+        else if (sw_unlikely(client->send_all(buf, len) != (ssize_t )len))
         {
             io_error();
-            return false;
+            retval = false;
         }
-        return true;
+        if (locked)
+        {
+            unlock_write();
+        }
+        return retval;
     }
 };
 
+class http2_client_write_guard
+{
+public:
+    http2_client_write_guard(http2_client *_h2c) : h2c(_h2c)
+    {
+        locked = h2c->lock_write();
+    }
+
+    ~http2_client_write_guard()
+    {
+        if (locked)
+        {
+            h2c->unlock_write();
+        }
+    }
+
+private:
+    http2_client *h2c;
+    bool locked;
+};
+
 typedef struct
 {
     http2_client *h2c;
@@ -241,6 +371,11 @@ ZEND_BEGIN_ARG_INFO_EX(arginfo_swoole_http2_client_coro_send, 0, 0, 1)
     ZEND_ARG_INFO(0, request)
 ZEND_END_ARG_INFO()
 
+ZEND_BEGIN_ARG_INFO_EX(arginfo_swoole_http2_client_coro_request, 0, 0, 1)
+    ZEND_ARG_INFO(0, request)
+    ZEND_ARG_INFO(0, timeout)
+ZEND_END_ARG_INFO()
+
 ZEND_BEGIN_ARG_INFO_EX(arginfo_swoole_http2_client_coro_write, 0, 0, 2)
     ZEND_ARG_INFO(0, stream_id)
     ZEND_ARG_INFO(0, data)
@@ -263,6 +398,7 @@ static PHP_METHOD(swoole_http2_client_coro, connect);
 static PHP_METHOD(swoole_http2_client_coro, stats);
 static PHP_METHOD(swoole_http2_client_coro, isStreamExist);
 static PHP_METHOD(swoole_http2_client_coro, send);
+static PHP_METHOD(swoole_http2_client_coro, request);
 static PHP_METHOD(swoole_http2_client_coro, write);
 static PHP_METHOD(swoole_http2_client_coro, recv);
 static PHP_METHOD(swoole_http2_client_coro, ping);
@@ -280,6 +416,7 @@ static const zend_function_entry swoole_http2_client_methods[] =
     PHP_ME(swoole_http2_client_coro, stats,         arginfo_swoole_http2_client_coro_stats, ZEND_ACC_PUBLIC)
     PHP_ME(swoole_http2_client_coro, isStreamExist, arginfo_swoole_http2_client_coro_isStreamExist, ZEND_ACC_PUBLIC)
     PHP_ME(swoole_http2_client_coro, send,          arginfo_swoole_http2_client_coro_send, ZEND_ACC_PUBLIC)
+    PHP_ME(swoole_http2_client_coro, request,       arginfo_swoole_http2_client_coro_request, ZEND_ACC_PUBLIC)
     PHP_ME(swoole_http2_client_coro, write,         arginfo_swoole_http2_client_coro_write, ZEND_ACC_PUBLIC)
     PHP_ME(swoole_http2_client_coro, recv,          arginfo_swoole_http2_client_coro_recv, ZEND_ACC_PUBLIC)
     PHP_ME(swoole_http2_client_coro, goaway,        arginfo_swoole_http2_client_coro_goaway, ZEND_ACC_PUBLIC)
@@ -364,6 +501,9 @@ void php_swoole_http2_client_coro_minit(int module_number)
 
 bool http2_client::connect()
 {
+    // nothing else can be sent before the preface
+    http2_client_write_guard guard(this);
+
     if (sw_unlikely(client != nullptr))
     {
         return false;
@@ -393,6 +533,8 @@ bool http2_client::connect()
     streams = swHashMap_new(8, http2_client_stream_free);
     // [init]: we must set default value, server is not always send all the settings
     swHttp2_init_settings(&remote_settings);
+    local_settings = next_settings;
+    local_window_size = SW_HTTP2_DEFAULT_WINDOW_SIZE;
 
     int ret = nghttp2_hd_inflate_new(&inflater);
     if (ret != 0)
@@ -401,6 +543,14 @@ bool http2_client::connect()
         close();
         return false;
     }
+    // the server may use the larger dynamic table we advertise
+    ret = nghttp2_hd_inflate_change_table_size(inflater, local_settings.header_table_size);
+    if (ret != 0)
+    {
+        nghttp2_error(ret, "nghttp2_hd_inflate_change_table_size() failed");
+        close();
+        return false;
+    }
     ret = nghttp2_hd_deflate_new(&deflater, local_settings.header_table_size);
     if (ret != 0)
     {
@@ -421,6 +571,17 @@ bool http2_client::connect()
         return false;
     }
 
+    // the connection window is not covered by SETTINGS, open it once instead of replenishing it on the first DATA frames
+    if (local_settings.window_size > local_window_size)
+    {
+        if (!send_window_update(0, local_settings.window_size - local_window_size))
+        {
+            close();
+            return false;
+        }
+        local_window_size = local_settings.window_size;
+    }
+
     zend_update_property_bool(swoole_http2_client_coro_ce, zobject, ZEND_STRL("connected"), 1);
 
     return true;
@@ -550,6 +711,11 @@ enum swReturn_code http2_client::parse_frame(zval *return_value)
         {
             return SW_ERROR;
         }
+        if (pool)
+        {
+            // SETTINGS_MAX_CONCURRENT_STREAMS may admit more of the requests waiting for a session
+            http2_session_pool_wakeup(pool);
+        }
         return SW_CONTINUE;
     }
     case SW_HTTP2_TYPE_WINDOW_UPDATE:
@@ -606,6 +772,11 @@ enum swReturn_code http2_client::parse_frame(zval *return_value)
 
         // delete and free quietly
         swHashMap_del_int(streams, stream_id);
+        if (waiters.find(stream_id) != waiters.end())
+        {
+            update_error_properties(value, cpp_string::format("stream#%u has been reset by the server", stream_id).c_str());
+            wakeup(stream_id, nullptr);
+        }
         return SW_CONTINUE;
     }
     /**
@@ -632,6 +803,11 @@ enum swReturn_code http2_client::parse_frame(zval *return_value)
     // The stream is not found or has closed
     if (stream == NULL)
     {
+        if ((stream_id & 1) && stream_id < this->stream_id)
+        {
+            // the frames in flight of a stream we have cancelled
+            return drop_frame(type, flags, buf, length) ? SW_CONTINUE : SW_ERROR;
+        }
         swNotice("http2 stream#%d belongs to an unknown type or it never registered", stream_id);
         return SW_CONTINUE;
     }
@@ -667,25 +843,9 @@ enum swReturn_code http2_client::parse_frame(zval *return_value)
                 swString_append_ptr(stream->buffer, buf, length);
             }
 
-            // now we control the connection flow only (not stream)
-            // our window size is unlimited, so we don't worry about subtraction overflow
-            local_settings.window_size -= length;
-            stream->local_window_size -= length;
-            if (local_settings.window_size < (SW_HTTP2_MAX_WINDOW_SIZE / 4))
+            if (!consume_window(stream, stream_id, length))
             {
-                if (!send_window_update(0, SW_HTTP2_MAX_WINDOW_SIZE - local_settings.window_size))
-                {
-                    return SW_ERROR;
-                }
-                local_settings.window_size = SW_HTTP2_MAX_WINDOW_SIZE;
-            }
-            if (stream->local_window_size < (SW_HTTP2_MAX_WINDOW_SIZE / 4))
-            {
-                if (!send_window_update(stream_id, SW_HTTP2_MAX_WINDOW_SIZE - stream->local_window_size))
-                {
-                    return SW_ERROR;
-                }
-                stream->local_window_size = SW_HTTP2_MAX_WINDOW_SIZE;
+                return SW_ERROR;
             }
         }
     }
@@ -828,6 +988,7 @@ static PHP_METHOD(swoole_http2_client_coro, set)
     php_array_merge(Z_ARRVAL_P(zsetting), Z_ARRVAL_P(zset));
 
     h2c->apply_setting(zset);
+    h2c->apply_http2_setting(zset);
 
     RETURN_TRUE;
 }
@@ -841,6 +1002,36 @@ bool http2_client::send_window_update(int stream_id, uint32_t size)
     return send(frame, SW_HTTP2_FRAME_HEADER_SIZE + SW_HTTP2_WINDOW_UPDATE_SIZE);
 }
 
+/**
+ * the windows are replenished when half of them are consumed,
+ * the server never stalls on a large response as the data is buffered by us anyway
+ */
+bool http2_client::consume_window(http2_client_stream *stream, uint32_t stream_id, size_t length)
+{
+    local_window_size -= length;
+    if (local_window_size < (local_settings.window_size / 2))
+    {
+        if (!send_window_update(0, local_settings.window_size - local_window_size))
+        {
+            return false;
+        }
+        local_window_size = local_settings.window_size;
+    }
+    if (stream)
+    {
+        stream->local_window_size -= length;
+        if (stream->local_window_size < (local_settings.window_size / 2))
+        {
+            if (!send_window_update(stream_id, local_settings.window_size - stream->local_window_size))
+            {
+                return false;
+            }
+            stream->local_window_size = local_settings.window_size;
+        }
+    }
+    return true;
+}
+
 bool http2_client::send_setting()
 {
     swHttp2_settings *settings = &local_settings;
@@ -884,6 +1075,50 @@ bool http2_client::send_setting()
     return send(frame, SW_HTTP2_FRAME_HEADER_SIZE + 18);
 }
 
+/**
+ * the frames of a cancelled stream are discarded,
+ * but its header block still updates the HPACK table and its data still counts against the connection window
+ */
+bool http2_client::drop_frame(uint8_t type, int flags, char *in, size_t inlen)
+{
+    swTraceLog(SW_TRACE_HTTP2, "drop the frame of the cancelled stream, type=%s, length=%zu", swHttp2_get_type(type), inlen);
+    if (type == SW_HTTP2_TYPE_DATA)
+    {
+        return consume_window(nullptr, 0, inlen);
+    }
+    if (type != SW_HTTP2_TYPE_HEADERS)
+    {
+        return true;
+    }
+    if (flags & SW_HTTP2_FLAG_PRIORITY)
+    {
+        in += 5;
+        inlen -= 5;
+    }
+    while (true)
+    {
+        nghttp2_nv nv;
+        int inflate_flags = 0;
+        ssize_t rv = nghttp2_hd_inflate_hd(inflater, &nv, &inflate_flags, (uchar *) in, inlen, 1);
+        if (rv < 0)
+        {
+            nghttp2_error(rv, "nghttp2_hd_inflate_hd failed");
+            return false;
+        }
+        in += rv;
+        inlen -= rv;
+        if (inflate_flags & NGHTTP2_HD_INFLATE_FINAL)
+        {
+            nghttp2_hd_inflate_end_headers(inflater);
+            return true;
+        }
+        if ((inflate_flags & NGHTTP2_HD_INFLATE_EMIT) == 0 && inlen == 0)
+        {
+            return true;
+        }
+    }
+}
+
 int http2_client::parse_header(http2_client_stream *stream, int flags, char *in, size_t inlen)
 {
     zval *zresponse = stream->zresponse;
@@ -1123,7 +1358,7 @@ http2_client_stream* http2_client::create_stream(uint32_t stream_id, bool pipeli
     stream->stream_id = stream_id;
     stream->type = pipeline ? SW_HTTP2_STREAM_PIPELINE : SW_HTTP2_STREAM_NORMAL;
     stream->remote_window_size = SW_HTTP2_DEFAULT_WINDOW_SIZE;
-    stream->local_window_size = SW_HTTP2_DEFAULT_WINDOW_SIZE;
+    stream->local_window_size = local_settings.window_size;
     // add to map
     swHashMap_add_int(streams, stream_id, stream);
     // set property
@@ -1141,8 +1376,15 @@ bool http2_client::send_ping_frame()
 
 uint32_t http2_client::send_request(zval *req)
 {
+    http2_client_write_guard guard(this);
     ssize_t length;
 
+    // it may have been closed while we were waiting for the other writers
+    if (!is_available())
+    {
+        return 0;
+    }
+
     zval *zheaders = sw_zend_read_and_convert_property_array(swoole_http2_request_ce, req, ZEND_STRL("headers"), 0);
     zval *zdata = sw_zend_read_property(swoole_http2_request_ce, req, ZEND_STRL("data"), 0);
     zval *zpipeline = sw_zend_read_property(swoole_http2_request_ce, req, ZEND_STRL("pipeline"), 0);
@@ -1257,9 +1499,15 @@ uint32_t http2_client::send_request(zval *req)
 
 bool http2_client::send_data(uint32_t stream_id, zval *data, bool end)
 {
+    http2_client_write_guard guard(this);
     char buffer[SW_HTTP2_FRAME_HEADER_SIZE];
-    http2_client_stream *stream = get_stream(stream_id);
 
+    if (!is_available())
+    {
+        return false;
+    }
+
+    http2_client_stream *stream = get_stream(stream_id);
     if (stream == NULL || stream->type != SW_HTTP2_STREAM_PIPELINE)
     {
         update_error_properties(EINVAL, cpp_string::format("can not found stream#%u", stream_id).c_str());
@@ -1322,6 +1570,461 @@ bool http2_client::send_goaway_frame(zend_long error_code, const char *debug_dat
     return ret;
 }
 
+bool http2_client::send_rst_stream(uint32_t stream_id, uint32_t error_code)
+{
+    char frame[SW_HTTP2_FRAME_HEADER_SIZE + SW_HTTP2_RST_STREAM_SIZE];
+    swTraceLog(SW_TRACE_HTTP2, "[" SW_ECHO_GREEN "] Send: stream_id=%u, error-code=%u", swHttp2_get_type(SW_HTTP2_TYPE_RST_STREAM), stream_id, error_code);
+    *(uint32_t*) (frame + SW_HTTP2_FRAME_HEADER_SIZE) = htonl(error_code);
+    swHttp2_set_frame_header(frame, SW_HTTP2_TYPE_RST_STREAM, SW_HTTP2_RST_STREAM_SIZE, 0, stream_id);
+    return send(frame, SW_HTTP2_FRAME_HEADER_SIZE + SW_HTTP2_RST_STREAM_SIZE);
+}
+
+bool http2_client::lock_write()
+{
+    Coroutine *co = Coroutine::get_current();
+    if (write_owner == co)
+    {
+        return false;
+    }
+    while (write_owner)
+    {
+        write_waiters.push_back(co);
+        co->yield();
+    }
+    write_owner = co;
+    return true;
+}
+
+void http2_client::unlock_write()
+{
+    write_owner = nullptr;
+    if (!write_waiters.empty())
+    {
+        Coroutine *co = write_waiters.front();
+        write_waiters.pop_front();
+        co->resume();
+    }
+}
+
+void http2_client::wakeup(uint32_t stream_id, zval *zresponse)
+{
+    auto i = waiters.find(stream_id);
+    if (i == waiters.end())
+    {
+        // the waiter has timed out
+        if (zresponse)
+        {
+            zval_ptr_dtor(zresponse);
+        }
+        return;
+    }
+    http2_client_waiter *waiter = i->second;
+    waiters.erase(i);
+    if (zresponse)
+    {
+        ZVAL_COPY_VALUE(&waiter->zresponse, zresponse);
+    }
+    waiter->done = true;
+    if (waiter->co)
+    {
+        waiter->co->resume();
+    }
+}
+
+/**
+ * hand the reading over to one of the waiters
+ */
+void http2_client::wakeup_reader()
+{
+    for (auto &i : waiters)
+    {
+        if (i.second->co)
+        {
+            i.second->co->resume();
+            return;
+        }
+    }
+}
+
+void http2_client::wakeup_all()
+{
+    std::vector<http2_client_waiter *> list;
+    for (auto &i : waiters)
+    {
+        list.push_back(i.second);
+    }
+    waiters.clear();
+    for (auto waiter : list)
+    {
+        waiter->done = true;
+        if (waiter->co)
+        {
+            waiter->co->resume();
+        }
+    }
+}
+
+static void http2_client_waiter_timeout(swTimer *timer, swTimer_node *tnode)
+{
+    http2_client_waiter *waiter = (http2_client_waiter *) tnode->data;
+    waiter->timer = nullptr;
+    // the reader is limited by the remaining time it passes to the socket
+    if (waiter->co)
+    {
+        waiter->timedout = true;
+        waiter->co->resume();
+    }
+}
+
+/**
+ * deadline is the absolute time the response must arrive by, 0 means it waits as long as the socket read timeout allows
+ */
+bool http2_client::request(zval *req, zval *return_value, double deadline)
+{
+    Coroutine *co = Coroutine::get_current_safe();
+    uint32_t stream_id;
+    {
+        http2_client_write_guard guard(this);
+        if (!client && !connect())
+        {
+            return false;
+        }
+        stream_id = send_request(req);
+    }
+    if (stream_id == 0)
+    {
+        return false;
+    }
+
+    http2_client_waiter waiter = {};
+    waiters[stream_id] = &waiter;
+    if (deadline > 0)
+    {
+        long msec = (long) ((deadline - swoole_microtime()) * 1000);
+        waiter.timer = swoole_timer_add(SW_MAX(msec, 1), SW_FALSE, http2_client_waiter_timeout, &waiter);
+    }
+
+    while (!waiter.done && !waiter.timedout)
+    {
+        if (reading)
+        {
+            waiter.co = co;
+            co->yield();
+            waiter.co = nullptr;
+            continue;
+        }
+
+        reading = true;
+        while (!waiter.done)
+        {
+            double timeout = 0;
+            if (deadline > 0)
+            {
+                timeout = deadline - swoole_microtime();
+                if (timeout <= 0)
+                {
+                    waiter.timedout = true;
+                    break;
+                }
+            }
+            if (!is_available() || !recv_packet(timeout))
+            {
+                if (client && client->errCode == ETIMEDOUT)
+                {
+                    // only this request fails, the others keep waiting
+                    waiter.timedout = true;
+                }
+                else
+                {
+                    close();
+                    wakeup_all();
+                }
+                break;
+            }
+            zval zresponse;
+            enum swReturn_code ret = parse_frame(&zresponse);
+            if (ret == SW_READY)
+            {
+                zval *zstream_id = sw_zend_read_property(swoole_http2_response_ce, &zresponse, ZEND_STRL("streamId"), 0);
+                wakeup(zval_get_long(zstream_id), &zresponse);
+            }
+            else if (ret != SW_CONTINUE)
+            {
+                // GOAWAY or a broken connection, all of the requests in flight fail
+                close();
+                wakeup_all();
+                break;
+            }
+        }
+        reading = false;
+        wakeup_reader();
+    }
+
+    if (waiter.timer)
+    {
+        swoole_timer_del(waiter.timer);
+    }
+    if (waiter.timedout && !waiter.done)
+    {
+        // the stream is abandoned, tell the server to stop sending it
+        waiters.erase(stream_id);
+        if (client)
+        {
+            swHashMap_del_int(streams, stream_id);
+            send_rst_stream(stream_id, SW_HTTP2_ERROR_CANCEL);
+        }
+        update_error_properties(ETIMEDOUT, strerror(ETIMEDOUT));
+        return false;
+    }
+    if (Z_TYPE(waiter.zresponse) == IS_UNDEF)
+    {
+        return false;
+    }
+    RETVAL_ZVAL(&waiter.zresponse, 0, 0);
+    return true;
+}
+
+/**
+ * a coroutine waiting for a free stream slot in the session pool
+ */
+struct http2_session_pool_waiter
+{
+    http2_session_pool *pool;
+    Coroutine *co;
+    bool timedout;
+};
+
+/**
+ * the connections to an origin shared by all of the clients with the shared_sessions option,
+ * a request goes to the least busy one which is below SETTINGS_MAX_CONCURRENT_STREAMS of the server
+ */
+class http2_session_pool
+{
+public:
+    uint32_t max_sessions;
+    std::vector<zval> sessions;
+    std::deque<http2_session_pool_waiter *> waiters;
+
+    http2_session_pool(uint32_t _max_sessions) : max_sessions(_max_sessions) { }
+
+    /**
+     * a session which has not connected yet counts with the default SETTINGS_MAX_CONCURRENT_STREAMS
+     */
+    static inline bool is_free(http2_client *h2c)
+    {
+        return h2c->pending_requests < SW_MAX(h2c->remote_settings.max_concurrent_streams, 1);
+    }
+
+    inline bool has_free_slot()
+    {
+        if (sessions.size() < max_sessions)
+        {
+            return true;
+        }
+        for (auto &zsession : sessions)
+        {
+            if (is_free(php_swoole_get_h2c(&zsession)))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * returns nullptr if no slot is free before the deadline (0 means no deadline)
+     */
+    http2_client* acquire(http2_client *owner, double deadline)
+    {
+        while (true)
+        {
+            http2_client *session = nullptr;
+            for (auto &zsession : sessions)
+            {
+                http2_client *h2c = php_swoole_get_h2c(&zsession);
+                if (is_free(h2c) && (!session || h2c->pending_requests < session->pending_requests))
+                {
+                    session = h2c;
+                }
+            }
+            if (!session && sessions.size() < max_sessions)
+            {
+                session = create(owner);
+            }
+            if (session)
+            {
+                session->pending_requests++;
+                return session;
+            }
+
+            http2_session_pool_waiter waiter = { this, Coroutine::get_current_safe(), false };
+            swTimer_node *timer = nullptr;
+            if (deadline > 0)
+            {
+                long msec = (long) ((deadline - swoole_microtime()) * 1000);
+                if (msec <= 0)
+                {
+                    return nullptr;
+                }
+                timer = swoole_timer_add(msec, SW_FALSE, timeout_callback, &waiter);
+            }
+            waiters.push_back(&waiter);
+            waiter.co->yield();
+            if (waiter.timedout)
+            {
+                return nullptr;
+            }
+            if (timer)
+            {
+                swoole_timer_del(timer);
+            }
+        }
+    }
+
+    void release(http2_client *session)
+    {
+        session->pending_requests--;
+        wakeup();
+    }
+
+    /**
+     * resume as many waiters as there are free slots, each of them takes one before it yields again
+     */
+    void wakeup()
+    {
+        while (!waiters.empty() && has_free_slot())
+        {
+            http2_session_pool_waiter *waiter = waiters.front();
+            waiters.pop_front();
+            waiter->co->resume();
+        }
+    }
+
+    ~http2_session_pool()
+    {
+        for (auto &zsession : sessions)
+        {
+            zval_ptr_dtor(&zsession);
+        }
+    }
+
+private:
+    static void timeout_callback(swTimer *timer, swTimer_node *tnode)
+    {
+        http2_session_pool_waiter *waiter = (http2_session_pool_waiter *) tnode->data;
+        auto &waiters = waiter->pool->waiters;
+        auto i = std::find(waiters.begin(), waiters.end(), waiter);
+        if (i == waiters.end())
+        {
+            // it has been woken up and not run yet
+            return;
+        }
+        waiters.erase(i);
+        waiter->timedout = true;
+        waiter->co->resume();
+    }
+
+    http2_client* create(http2_client *owner)
+    {
+        zval zsession;
+        object_init_ex(&zsession, swoole_http2_client_coro_ce);
+        http2_client *h2c = new http2_client(owner->host.c_str(), owner->host.length(), owner->port, owner->ssl, &zsession);
+        php_swoole_set_h2c(&zsession, h2c);
+        h2c->pool = this;
+        zend_update_property_stringl(swoole_http2_client_coro_ce, &zsession, ZEND_STRL("host"), owner->host.c_str(), owner->host.length());
+        zend_update_property_long(swoole_http2_client_coro_ce, &zsession, ZEND_STRL("port"), owner->port);
+        zend_update_property_bool(swoole_http2_client_coro_ce, &zsession, ZEND_STRL("ssl"), owner->ssl);
+        // the session is connected with the settings of the client which creates it
+        zval *zsetting = sw_zend_read_property(swoole_http2_client_coro_ce, owner->zobject, ZEND_STRL("setting"), 0);
+        if (ZVAL_IS_ARRAY(zsetting))
+        {
+            zend_update_property(swoole_http2_client_coro_ce, &zsession, ZEND_STRL("setting"), zsetting);
+            h2c->apply_http2_setting(zsetting);
+        }
+        sessions.push_back(zsession);
+        return h2c;
+    }
+};
+
+static void http2_session_pool_wakeup(http2_session_pool *pool)
+{
+    pool->wakeup();
+}
+
+static std::unordered_map<std::string, http2_session_pool *> http2_session_pools;
+
+static void http2_session_pools_free(void *data)
+{
+    for (auto &i : http2_session_pools)
+    {
+        delete i.second;
+    }
+    http2_session_pools.clear();
+}
+
+static http2_session_pool* http2_session_pool_get(http2_client *h2c)
+{
+    std::string key = h2c->host + ":" + std::to_string(h2c->port) + (h2c->ssl ? ":ssl" : "");
+    auto i = http2_session_pools.find(key);
+    if (i != http2_session_pools.end())
+    {
+        return i->second;
+    }
+    if (http2_session_pools.empty())
+    {
+        php_swoole_register_rshutdown_callback(http2_session_pools_free, nullptr);
+    }
+    http2_session_pool *pool = new http2_session_pool(h2c->shared_sessions);
+    http2_session_pools[key] = pool;
+    return pool;
+}
+
+static PHP_METHOD(swoole_http2_client_coro, request)
+{
+    zval *request;
+    double timeout = 0;
+    http2_client *h2c = php_swoole_get_h2c(ZEND_THIS);
+
+    if (zend_parse_parameters(ZEND_NUM_ARGS(), "z|d", &request, &timeout) == FAILURE)
+    {
+        RETURN_FALSE;
+    }
+    if (Z_TYPE_P(request) != IS_OBJECT || !instanceof_function(Z_OBJCE_P(request), swoole_http2_request_ce))
+    {
+        zend_throw_exception_ex(swoole_http2_client_coro_exception_ce, SW_ERROR_INVALID_PARAMS, "Object is not a instanceof %s", ZSTR_VAL(swoole_http2_request_ce->name));
+        RETURN_FALSE;
+    }
+
+    // the timeout covers the wait for a shared session and the whole response, 0 leaves it to the socket read timeout
+    double deadline = timeout > 0 ? swoole_microtime() + timeout : 0;
+
+    if (h2c->shared_sessions == 0)
+    {
+        if (!h2c->request(request, return_value, deadline))
+        {
+            RETURN_FALSE;
+        }
+        return;
+    }
+
+    http2_session_pool *pool = http2_session_pool_get(h2c);
+    http2_client *session = pool->acquire(h2c, deadline);
+    if (!session)
+    {
+        h2c->update_error_properties(ETIMEDOUT, strerror(ETIMEDOUT));
+        RETURN_FALSE;
+    }
+    if (!session->request(request, return_value, deadline))
+    {
+        zend_update_property(swoole_http2_client_coro_ce, ZEND_THIS, ZEND_STRL("errCode"),
+            sw_zend_read_property(swoole_http2_client_coro_ce, session->zobject, ZEND_STRL("errCode"), 0));
+        zend_update_property(swoole_http2_client_coro_ce, ZEND_THIS, ZEND_STRL("errMsg"),
+            sw_zend_read_property(swoole_http2_client_coro_ce, session->zobject, ZEND_STRL("errMsg"), 0));
+        RETVAL_FALSE;
+    }
+    pool->release(session);
+}
+
 static PHP_METHOD(swoole_http2_client_coro, send)
 {
     zval *request;
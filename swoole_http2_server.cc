@@ -236,10 +236,10 @@ static void swoole_http2_onRequest(http2_session *client, http2_stream *stream)
     add_assoc_double(zserver, "request_time_float", swoole_microtime());
     if (serv_sock)
     {
-        add_assoc_long(zserver, "server_port", swConnection_get_port(serv_sock->socket_type, &serv_sock->info));
+        add_assoc_long(zserver, "server_port", swConnection_get_port(serv_sock->socket_type, &serv_sock->cold->info));
     }
-    add_assoc_long(zserver, "remote_port", swConnection_get_port(conn->socket_type, &conn->info));
-    add_assoc_string(zserver, "remote_addr", (char * ) swConnection_get_ip(conn->socket_type, &conn->info));
+    add_assoc_long(zserver, "remote_port", swConnection_get_port(conn->socket_type, &conn->cold->info));
+    add_assoc_string(zserver, "remote_addr", (char * ) swConnection_get_ip(conn->socket_type, &conn->cold->info));
     add_assoc_long(zserver, "master_time", conn->last_time);
     add_assoc_string(zserver, "server_protocol", (char * ) "HTTP/2");
 
@@ -259,8 +259,12 @@ static int http2_build_header(http_context *ctx, uchar *buffer, size_t body_leng
 {
     zval *zheader = sw_zend_read_property(swoole_http_response_ce, ctx->response.zobject, ZEND_STRL("header"), 0);
     zval *zcookie = sw_zend_read_property(swoole_http_response_ce, ctx->response.zobject, ZEND_STRL("cookie"), 0);
-    http2::headers headers(8 + php_swoole_array_length_safe(zheader) + php_swoole_array_length_safe(zcookie));
-    char *date_str = NULL;
+    http_header_template *tpl = swoole_http_get_header_template(ctx->response.header_template);
+    http2::headers headers(
+        8 + php_swoole_array_length_safe(zheader) + php_swoole_array_length_safe(zcookie) + (tpl ? tpl->headers.size() : 0)
+    );
+    const char *date_str;
+    size_t date_len;
     char intbuf[2][16];
     int ret;
 
@@ -275,9 +279,9 @@ static int http2_build_header(http_context *ctx, uchar *buffer, size_t body_leng
     headers.add(ZEND_STRL(":status"), intbuf[0], ret);
 
     // headers
+    uint32_t header_flag = 0x0;
     if (ZVAL_IS_ARRAY(zheader))
     {
-        uint32_t header_flag = 0x0;
         zend_string *key;
         zval *zvalue;
 
@@ -309,31 +313,51 @@ static int http2_build_header(http_context *ctx, uchar *buffer, size_t body_leng
             headers.add(c_key, c_keylen, str_value.val(), str_value.len());
         }
         ZEND_HASH_FOREACH_END();
+    }
 
-        if (!(header_flag & HTTP_HEADER_SERVER))
-        {
-            headers.add(ZEND_STRL("server"), ZEND_STRL(SW_HTTP_SERVER_SOFTWARE));
-        }
-        if (!(header_flag & HTTP_HEADER_DATE))
-        {
-            date_str = php_swoole_format_date((char *)ZEND_STRL(SW_HTTP_DATE_FORMAT), time(NULL), 0);
-            headers.add(ZEND_STRL("date"), date_str, strlen(date_str));
-        }
-        if (!(header_flag & HTTP_HEADER_CONTENT_TYPE))
+    // header template, the headers set by the response take precedence
+    if (tpl)
+    {
+        for (auto &header : tpl->headers)
         {
-            headers.add(ZEND_STRL("content-type"), ZEND_STRL("text/html"));
+            const std::string &key = header.first;
+            // the connection-specific headers are not allowed in HTTP/2
+            if (key == "connection" || key == "transfer-encoding" || key == "keep-alive")
+            {
+                continue;
+            }
+            if (ZVAL_IS_ARRAY(zheader) && swoole_http_has_header(zheader, key.c_str(), key.length()))
+            {
+                continue;
+            }
+            if (key == "server")
+            {
+                header_flag |= HTTP_HEADER_SERVER;
+            }
+            else if (key == "date")
+            {
+                header_flag |= HTTP_HEADER_DATE;
+            }
+            else if (key == "content-type")
+            {
+                header_flag |= HTTP_HEADER_CONTENT_TYPE;
+            }
+            headers.add(key.c_str(), key.length(), header.second.c_str(), header.second.length());
         }
     }
-    else
+
+    if (!(header_flag & HTTP_HEADER_SERVER))
     {
         headers.add(ZEND_STRL("server"), ZEND_STRL(SW_HTTP_SERVER_SOFTWARE));
-        headers.add(ZEND_STRL("content-type"), ZEND_STRL("text/html"));
-        date_str = php_swoole_format_date((char *) ZEND_STRL(SW_HTTP_DATE_FORMAT), time(NULL), 0);
-        headers.add(ZEND_STRL("date"), date_str, strlen(date_str));
     }
-    if (date_str)
+    if (!(header_flag & HTTP_HEADER_DATE))
     {
-        efree(date_str);
+        date_str = swoole_http_get_date(&date_len);
+        headers.add(ZEND_STRL("date"), date_str, date_len);
+    }
+    if (!(header_flag & HTTP_HEADER_CONTENT_TYPE))
+    {
+        headers.add(ZEND_STRL("content-type"), ZEND_STRL("text/html"));
     }
 
     // cookies
@@ -90,6 +90,8 @@ public:
 #endif
     int  download_file_fd = 0;          // save http response to file
     bool has_upload_files = false;
+    zend_fcall_info_cache *write_func = nullptr; // receive the body chunks instead of buffering them
+    bool write_error = false;           // the body chunk could not be written out
 
     /* safety zval */
     zval _zobject;
@@ -123,6 +125,7 @@ public:
     bool upgrade(std::string path);
     bool push(zval *zdata, zend_long opcode = WEBSOCKET_OPCODE_TEXT, uint8_t flags = SW_WEBSOCKET_FLAG_FIN);
     bool close(const bool should_be_reset = true);
+    bool write_body(const char *data, size_t length);
 
     void get_header_out(zval *return_value)
     {
@@ -147,6 +150,8 @@ private:
     swSocket_type socket_type = SW_SOCK_TCP;
     swoole_http_parser parser = {0};
     bool wait = false;
+
+    bool can_recvfile();
 };
 
 static zend_class_entry *swoole_http_client_coro_ce;
@@ -400,33 +405,35 @@ static int http_parser_on_headers_complete(swoole_http_parser *parser)
 static int http_parser_on_body(swoole_http_parser *parser, const char *at, size_t length)
 {
     http_client* http = (http_client*) parser->data;
+    bool streaming = http->write_func || http->download_file_fd > 0;
+    if (http->write_error)
+    {
+        return -1;
+    }
 #ifdef SW_HAVE_COMPRESSION
     if (!http->compression_error && http->compress_method != HTTP_COMPRESS_NONE)
     {
-        if (!http->decompress_response(at, length))
+        if (http->decompress_response(at, length))
         {
-            http->compression_error = true;
-            goto _append_raw;
+            if (streaming && http->body->length > 0)
+            {
+                bool success = http->write_body(SW_STRINGL(http->body));
+                swString_clear(http->body);
+                return success ? 0 : -1;
+            }
+            return 0;
         }
+        http->compression_error = true;
     }
-    else
 #endif
+    // the chunk is handed over directly without being copied into the body
+    if (streaming)
     {
-#ifdef SW_HAVE_COMPRESSION
-        _append_raw:
-#endif
-        if (swString_append_ptr(http->body, at, length) < 0)
-        {
-            return -1;
-        }
+        return http->write_body(at, length) ? 0 : -1;
     }
-    if (http->download_file_fd > 0 && http->body->length > 0)
+    if (swString_append_ptr(http->body, at, length) < 0)
     {
-        if (swoole_coroutine_write(http->download_file_fd, SW_STRINGL(http->body)) != (ssize_t) http->body->length)
-        {
-            return -1;
-        }
-        swString_clear(http->body);
+        return -1;
     }
     return 0;
 }
@@ -652,6 +659,28 @@ void http_client::apply_setting(zval *zset, const bool check_all)
             websocket_compression = zval_is_true(ztmp);
         }
 #endif
+        if (php_swoole_array_get_value(vht, "write_func", ztmp))
+        {
+            if (write_func)
+            {
+                sw_zend_fci_cache_free(write_func);
+                write_func = nullptr;
+            }
+            if (!ZVAL_IS_NULL(ztmp))
+            {
+                char *func_name;
+                zend_fcall_info_cache *fci_cache = (zend_fcall_info_cache *) ecalloc(1, sizeof(zend_fcall_info_cache));
+                if (!sw_zend_is_callable_ex(ztmp, NULL, 0, &func_name, NULL, fci_cache, NULL))
+                {
+                    php_swoole_fatal_error(E_ERROR, "write_func '%s' is not callable", func_name);
+                    efree(fci_cache);
+                    return;
+                }
+                efree(func_name);
+                sw_zend_fci_cache_persist(fci_cache);
+                write_func = fci_cache;
+            }
+        }
     }
     if (socket)
     {
@@ -1409,6 +1438,7 @@ bool http_client::recv_http_response(double timeout)
     // re-init http response parser
     swoole_http_parser_init(&parser, PHP_HTTP_RESPONSE);
     parser.data = this;
+    write_error = false;
 
     if (timeout == 0)
     {
@@ -1438,6 +1468,20 @@ bool http_client::recv_http_response(double timeout)
         total_bytes += retval;
         parsed_n = swoole_http_parser_execute(&parser, &http_parser_settings, buffer->str, retval);
         swTraceLog(SW_TRACE_HTTP_CLIENT, "parsed_n=%ld, retval=%ld, total_bytes=%ld, completed=%d", parsed_n, retval, total_bytes, parser.state == s_start_res);
+        if (sw_unlikely(write_error))
+        {
+            return false;
+        }
+        if (can_recvfile())
+        {
+            if (!socket->recvfile(download_file_fd, parser.content_length))
+            {
+                return false;
+            }
+            parser.content_length = 0;
+            http_parser_on_message_complete(&parser);
+            return true;
+        }
         if (parser.state == s_start_res)
         {
             // websocket stick package
@@ -1587,6 +1631,55 @@ bool http_client::close(const bool should_be_reset)
     return false;
 }
 
+bool http_client::write_body(const char *data, size_t length)
+{
+    if (write_func)
+    {
+        zval args[2], retval;
+        args[0] = *zobject;
+        ZVAL_STRINGL(&args[1], data, length);
+        bool success = sw_zend_call_function_ex2(NULL, write_func, 2, args, &retval) == SUCCESS;
+        zval_ptr_dtor(&args[1]);
+        // return false to abort the transfer
+        if (!success || Z_TYPE(retval) == IS_FALSE)
+        {
+            socket->set_err(ECANCELED);
+            write_error = true;
+        }
+        zval_ptr_dtor(&retval);
+    }
+    else if (swoole_coroutine_write(download_file_fd, data, length) != (ssize_t) length)
+    {
+        socket->set_err(errno);
+        write_error = true;
+    }
+    return !write_error;
+}
+
+/**
+ * the rest of the download can be moved from the socket into the file without passing through the parser
+ */
+bool http_client::can_recvfile()
+{
+    if (download_file_fd <= 0 || write_func || parser.state != s_body_identity || parser.content_length <= 0)
+    {
+        return false;
+    }
+#ifdef SW_HAVE_COMPRESSION
+    if (compress_method != HTTP_COMPRESS_NONE)
+    {
+        return false;
+    }
+#endif
+#ifdef SW_USE_OPENSSL
+    if (socket->is_ssl_enable())
+    {
+        return false;
+    }
+#endif
+    return true;
+}
+
 http_client::~http_client()
 {
     close();
@@ -1594,6 +1687,10 @@ http_client::~http_client()
     {
         swString_free(body);
     }
+    if (write_func)
+    {
+        sw_zend_fci_cache_free(write_func);
+    }
 }
 
 static sw_inline http_client_coro* php_swoole_http_client_coro_fetch_object(zend_object *obj)
@@ -280,6 +280,7 @@ static zend_object *php_swoole_http_request_create_object(zend_class_entry *ce)
 
 static PHP_METHOD(swoole_http_request, getData);
 static PHP_METHOD(swoole_http_request, rawContent);
+static PHP_METHOD(swoole_http_request, read);
 static PHP_METHOD(swoole_http_request, __destruct);
 
 ZEND_BEGIN_ARG_INFO_EX(arginfo_swoole_http_void, 0, 0, 0)
@@ -289,6 +290,7 @@ const zend_function_entry swoole_http_request_methods[] =
 {
     PHP_ME(swoole_http_request, rawContent, arginfo_swoole_http_void, ZEND_ACC_PUBLIC)
     PHP_ME(swoole_http_request, getData, arginfo_swoole_http_void, ZEND_ACC_PUBLIC)
+    PHP_ME(swoole_http_request, read, arginfo_swoole_http_void, ZEND_ACC_PUBLIC)
     PHP_ME(swoole_http_request, __destruct, arginfo_swoole_http_void, ZEND_ACC_PUBLIC)
     PHP_FE_END
 };
@@ -861,10 +863,67 @@ static int http_request_on_body(swoole_http_parser *parser, const char *at, size
 {
     http_context *ctx = (http_context *) parser->data;
 
-    ctx->request.body_length = length;
-
     swTraceLog(SW_TRACE_HTTP, "length=%ld", length);
 
+    /**
+     * streamed body, the form data is parsed as it arrives and the rest is read by Request::read()
+     */
+    if (ctx->stream_body)
+    {
+        http_request *req = &ctx->request;
+        if (ctx->mt_parser != NULL)
+        {
+            char *c = (char *) at;
+            while (req->stream_length == 0 && length >= 2 && *c == '\r' && *(c + 1) == '\n')
+            {
+                c += 2;
+                length -= 2;
+            }
+            req->stream_length += length;
+            size_t n = multipart_parser_execute(ctx->mt_parser, c, length);
+            if (n != length)
+            {
+                swoole_error_log(SW_LOG_WARNING, SW_ERROR_SERVER_INVALID_REQUEST, "parse multipart body failed, n=%zu", n);
+            }
+            return 0;
+        }
+        if (!req->stream_buffer)
+        {
+            req->stream_buffer = swString_new(SW_MAX(length, (size_t) SW_BUFFER_SIZE_STD));
+            if (!req->stream_buffer)
+            {
+                return -1;
+            }
+        }
+        if (swString_append_ptr(req->stream_buffer, at, length) < 0)
+        {
+            return -1;
+        }
+        req->stream_length += length;
+        /**
+         * the unread body is kept below package_max_length, which is also the high-water mark of the back-pressure
+         */
+        swServer *serv = (swServer *) ctx->private_data;
+        if (!ctx->stream_paused && req->stream_buffer->length > swServer_get_port(serv, ctx->fd)->protocol.package_max_length)
+        {
+            // without coroutine the handler is called after the whole body, nothing can drain the buffer
+            if (!SwooleG.enable_coroutine)
+            {
+                swoole_error_log(
+                    SW_LOG_WARNING, SW_ERROR_PACKAGE_LENGTH_TOO_LARGE,
+                    "the body of request#%d exceeds package_max_length, only the form data can be streamed without coroutine", ctx->fd
+                );
+                ctx->send(ctx, SW_STRL(SW_HTTP_BAD_REQUEST_TOO_LARGE));
+                return -1;
+            }
+            serv->feedback(serv, ctx->fd, SW_SERVER_EVENT_PAUSE_RECV);
+            ctx->stream_paused = 1;
+        }
+        return 0;
+    }
+
+    ctx->request.body_length = length;
+
     if (ctx->parse_body && ctx->request.post_form_urlencoded)
     {
         sapi_module.treat_data(
@@ -979,6 +1038,51 @@ static PHP_METHOD(swoole_http_request, rawContent)
     RETURN_EMPTY_STRING();
 }
 
+/**
+ * the next part of the streamed body, an empty string after the whole body has been read
+ */
+static PHP_METHOD(swoole_http_request, read)
+{
+    http_context *ctx = php_swoole_http_request_get_and_check_context(ZEND_THIS);
+    if (UNEXPECTED(!ctx))
+    {
+        RETURN_FALSE;
+    }
+    if (!ctx->stream_body)
+    {
+        RETURN_EMPTY_STRING();
+    }
+
+    http_request *req = &ctx->request;
+    while ((!req->stream_buffer || req->stream_buffer->length == 0) && !ctx->completed && !ctx->stream_aborted)
+    {
+        if (ctx->stream_reader)
+        {
+            php_swoole_fatal_error(E_WARNING, "the body of request#%d is being read by another coroutine", ctx->fd);
+            RETURN_FALSE;
+        }
+        ctx->stream_reader = swoole::Coroutine::get_current_safe();
+        ctx->stream_reader->yield();
+    }
+    if (req->stream_buffer && req->stream_buffer->length > 0)
+    {
+        RETVAL_STRINGL(req->stream_buffer->str, req->stream_buffer->length);
+        swString_clear(req->stream_buffer);
+        if (ctx->stream_paused)
+        {
+            swServer *serv = (swServer *) ctx->private_data;
+            serv->feedback(serv, ctx->fd, SW_SERVER_EVENT_RESUME_RECV);
+            ctx->stream_paused = 0;
+        }
+        return;
+    }
+    if (ctx->stream_aborted)
+    {
+        RETURN_FALSE;
+    }
+    RETURN_EMPTY_STRING();
+}
+
 static PHP_METHOD(swoole_http_request, getData)
 {
     http_context *ctx = php_swoole_http_request_get_and_check_context(ZEND_THIS);
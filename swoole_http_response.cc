@@ -46,13 +46,22 @@ extern "C"
 #include "http2.h"
 #endif
 
+#include <string>
+#include <vector>
+
 using namespace swoole;
 using swoole::coroutine::Socket;
 
 zend_class_entry *swoole_http_response_ce;
 static zend_object_handlers swoole_http_response_handlers;
 
+static std::vector<http_header_template *> header_templates;
+
+#define HTTP_DEFAULT_HEADERS(connection) \
+    "Server: " SW_HTTP_SERVER_SOFTWARE "\r\nConnection: " connection "\r\nContent-Type: text/html\r\n"
+
 static void http_build_header(http_context *, swString *response, int body_length);
+static bool http_send_chunk(http_context *ctx, swString *http_buffer, const char *data, size_t length);
 
 static inline void http_header_key_format(char *key, int length)
 {
@@ -81,6 +90,35 @@ static inline void http_header_key_format(char *key, int length)
     }
 }
 
+static inline uint32_t http_header_get_flag(const char *key, size_t keylen)
+{
+    if (SW_STRCASEEQ(key, keylen, "Server"))
+    {
+        return HTTP_HEADER_SERVER;
+    }
+    else if (SW_STRCASEEQ(key, keylen, "Connection"))
+    {
+        return HTTP_HEADER_CONNECTION;
+    }
+    else if (SW_STRCASEEQ(key, keylen, "Date"))
+    {
+        return HTTP_HEADER_DATE;
+    }
+    else if (SW_STRCASEEQ(key, keylen, "Content-Length"))
+    {
+        return HTTP_HEADER_CONTENT_LENGTH;
+    }
+    else if (SW_STRCASEEQ(key, keylen, "Content-Type"))
+    {
+        return HTTP_HEADER_CONTENT_TYPE;
+    }
+    else if (SW_STRCASEEQ(key, keylen, "Transfer-Encoding"))
+    {
+        return HTTP_HEADER_TRANSFER_ENCODING;
+    }
+    return 0;
+}
+
 static inline swString* http_get_write_buffer(http_context *ctx)
 {
     if (ctx->co_socket)
@@ -179,6 +217,8 @@ static PHP_METHOD(swoole_http_response, redirect);
 static PHP_METHOD(swoole_http_response, cookie);
 static PHP_METHOD(swoole_http_response, rawcookie);
 static PHP_METHOD(swoole_http_response, header);
+static PHP_METHOD(swoole_http_response, createHeaderTemplate);
+static PHP_METHOD(swoole_http_response, headerTemplate);
 static PHP_METHOD(swoole_http_response, initHeader);
 static PHP_METHOD(swoole_http_response, detach);
 static PHP_METHOD(swoole_http_response, create);
@@ -210,6 +250,14 @@ ZEND_BEGIN_ARG_INFO_EX(arginfo_swoole_http_response_header, 0, 0, 2)
     ZEND_ARG_INFO(0, ucwords)
 ZEND_END_ARG_INFO()
 
+ZEND_BEGIN_ARG_INFO_EX(arginfo_swoole_http_response_createHeaderTemplate, 0, 0, 1)
+    ZEND_ARG_ARRAY_INFO(0, headers, 0)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_swoole_http_response_headerTemplate, 0, 0, 1)
+    ZEND_ARG_INFO(0, id)
+ZEND_END_ARG_INFO()
+
 #ifdef SW_USE_HTTP2
 ZEND_BEGIN_ARG_INFO_EX(arginfo_swoole_http_response_trailer, 0, 0, 2)
     ZEND_ARG_INFO(0, key)
@@ -267,6 +315,8 @@ const zend_function_entry swoole_http_response_methods[] =
     PHP_MALIAS(swoole_http_response, setStatusCode, status, arginfo_swoole_http_response_status, ZEND_ACC_PUBLIC)
     PHP_ME(swoole_http_response, header, arginfo_swoole_http_response_header, ZEND_ACC_PUBLIC)
     PHP_MALIAS(swoole_http_response, setHeader, header, arginfo_swoole_http_response_header, ZEND_ACC_PUBLIC)
+    PHP_ME(swoole_http_response, createHeaderTemplate, arginfo_swoole_http_response_createHeaderTemplate, ZEND_ACC_PUBLIC | ZEND_ACC_STATIC)
+    PHP_ME(swoole_http_response, headerTemplate, arginfo_swoole_http_response_headerTemplate, ZEND_ACC_PUBLIC)
 #ifdef SW_USE_HTTP2
     PHP_ME(swoole_http_response, trailer, arginfo_swoole_http_response_trailer, ZEND_ACC_PUBLIC)
     PHP_ME(swoole_http_response, ping, arginfo_swoole_http_void, ZEND_ACC_PUBLIC)
@@ -327,16 +377,26 @@ static PHP_METHOD(swoole_http_response, write)
     }
 #endif
 
-#ifdef SW_HAVE_COMPRESSION
-    ctx->accept_compression = 0;
-#endif
-
     ctx->private_data_2 = return_value;
 
     swString *http_buffer = http_get_write_buffer(ctx);
 
     if (!ctx->send_header)
     {
+#ifdef SW_HAVE_COMPRESSION
+        /**
+         * each chunk is compressed by the streaming encoder and flushed at the chunk boundary,
+         * so the client can decode the data as soon as a chunk is received
+         */
+        if (ctx->accept_compression)
+        {
+            ctx->compress_stream = swoole_http_compress_stream_new(ctx->compression_method, ctx->compression_level);
+            if (!ctx->compress_stream)
+            {
+                ctx->accept_compression = 0;
+            }
+        }
+#endif
         ctx->chunk = 1;
         swString_clear(http_buffer);
         http_build_header(ctx, http_buffer, -1);
@@ -361,23 +421,89 @@ static PHP_METHOD(swoole_http_response, write)
         http_body.length = length;
     }
 
-    // Why not enable compression?
-    // If both compression and chunked encoding are enabled,
-    // then the content stream is first compressed, then chunked;
-    // so the chunk encoding itself is not compressed,
-    // **and the data in each chunk is not compressed individually.**
-    // The remote endpoint then decodes the stream by concatenating the chunks and decompressing the result.
+#ifdef SW_HAVE_COMPRESSION
+    if (ctx->compress_stream)
+    {
+        if (swoole_http_compress_stream_write(ctx->compress_stream, http_body.str, http_body.length, false) != SW_OK)
+        {
+            RETURN_FALSE;
+        }
+        // the encoder is still buffering input, nothing to flush in this chunk
+        if (swoole_zlib_buffer->length == 0)
+        {
+            RETURN_TRUE;
+        }
+        http_body.str = swoole_zlib_buffer->str;
+        http_body.length = swoole_zlib_buffer->length;
+    }
+#endif
+
+    RETURN_BOOL(http_send_chunk(ctx, http_buffer, http_body.str, http_body.length));
+}
+
+static bool http_send_chunk(http_context *ctx, swString *http_buffer, const char *data, size_t length)
+{
     swString_clear(http_buffer);
-    char *hex_string = swoole_dec2hex(http_body.length, 16);
+    char *hex_string = swoole_dec2hex(length, 16);
     int hex_len = strlen(hex_string);
     //"%.*s\r\n%.*s\r\n", hex_len, hex_string, body.length, body.str
     swString_append_ptr(http_buffer, hex_string, hex_len);
     swString_append_ptr(http_buffer, ZEND_STRL("\r\n"));
-    swString_append_ptr(http_buffer, http_body.str, http_body.length);
+    swString_append_ptr(http_buffer, data, length);
     swString_append_ptr(http_buffer, ZEND_STRL("\r\n"));
     sw_free(hex_string);
 
-    RETURN_BOOL(ctx->send(ctx, http_buffer->str, http_buffer->length));
+    return ctx->send(ctx, http_buffer->str, http_buffer->length);
+}
+
+const char* swoole_http_get_date(size_t *length)
+{
+    static time_t cache_time = 0;
+    static char cache_date[64];
+    static size_t cache_length = 0;
+
+    time_t now = time(NULL);
+    if (now != cache_time)
+    {
+        char *date_str = php_swoole_format_date((char *) ZEND_STRL(SW_HTTP_DATE_FORMAT), now, 0);
+        cache_length = sw_snprintf(cache_date, sizeof(cache_date), "%s", date_str);
+        efree(date_str);
+        cache_time = now;
+    }
+    *length = cache_length;
+    return cache_date;
+}
+
+http_header_template* swoole_http_get_header_template(uint32_t id)
+{
+    return id > 0 && id <= header_templates.size() ? header_templates[id - 1] : nullptr;
+}
+
+/**
+ * whether the response has set the header, the keys are compared case-insensitively
+ */
+bool swoole_http_has_header(zval *zheader, const char *key, size_t keylen)
+{
+    zend_string *zkey;
+    zval *zvalue;
+    ZEND_HASH_FOREACH_STR_KEY_VAL(Z_ARRVAL_P(zheader), zkey, zvalue)
+    {
+        if (zkey && !ZVAL_IS_NULL(zvalue) && swoole_strcaseeq(ZSTR_VAL(zkey), ZSTR_LEN(zkey), key, keylen))
+        {
+            return true;
+        }
+    }
+    ZEND_HASH_FOREACH_END();
+    return false;
+}
+
+static void http_header_templates_free(void *data)
+{
+    for (auto tpl : header_templates)
+    {
+        delete tpl;
+    }
+    header_templates.clear();
 }
 
 static void http_build_header(http_context *ctx, swString *response, int body_length)
@@ -385,28 +511,65 @@ static void http_build_header(http_context *ctx, swString *response, int body_le
     char *buf = SwooleTG.buffer_stack->str;
     size_t l_buf = SwooleTG.buffer_stack->size;
     int n;
-    char *date_str;
 
     assert(ctx->send_header == 0);
 
     /**
      * http status line
      */
-    if (!ctx->response.reason)
+    if (ctx->response.status == SW_HTTP_OK && !ctx->response.reason)
+    {
+        swString_append_ptr(response, ZEND_STRL("HTTP/1.1 200 OK\r\n"));
+    }
+    else if (!ctx->response.reason)
     {
         n = sw_snprintf(buf, l_buf, "HTTP/1.1 %s\r\n", swHttp_get_status_message(ctx->response.status));
+        swString_append_ptr(response, buf, n);
     }
     else
     {
         n = sw_snprintf(buf, l_buf, "HTTP/1.1 %d %s\r\n", ctx->response.status, ctx->response.reason);
+        swString_append_ptr(response, buf, n);
+    }
+
+    uint32_t header_flag = 0x0;
+    zval *zheader = sw_zend_read_property(swoole_http_response_ce, ctx->response.zobject, ZEND_STRL("header"), 0);
+
+    /**
+     * header template, already formatted unless the response overrides some of its headers
+     */
+    if (ctx->response.header_template)
+    {
+        http_header_template *tpl = header_templates[ctx->response.header_template - 1];
+        if (!ZVAL_IS_ARRAY(zheader) || zend_hash_num_elements(Z_ARRVAL_P(zheader)) == 0)
+        {
+            swString_append_ptr(response, tpl->data.c_str(), tpl->data.length());
+            header_flag |= tpl->header_flag;
+        }
+        else
+        {
+            char key_buf[SW_HTTP_HEADER_KEY_SIZE];
+            for (auto &header : tpl->headers)
+            {
+                const std::string &key = header.first;
+                if (swoole_http_has_header(zheader, key.c_str(), key.length()))
+                {
+                    continue;
+                }
+                memcpy(key_buf, key.c_str(), key.length() + 1);
+                http_header_key_format(key_buf, key.length());
+                header_flag |= http_header_get_flag(key_buf, key.length());
+                swString_append_ptr(response, key_buf, key.length());
+                swString_append_ptr(response, ZEND_STRL(": "));
+                swString_append_ptr(response, header.second.c_str(), header.second.length());
+                swString_append_ptr(response, ZEND_STRL("\r\n"));
+            }
+        }
     }
-    swString_append_ptr(response, buf, n);
 
     /**
      * http header
      */
-    zval *zheader = sw_zend_read_property(swoole_http_response_ce, ctx->response.zobject, ZEND_STRL("header"), 0);
-    uint32_t header_flag = 0x0;
     if (ZVAL_IS_ARRAY(zheader))
     {
         const char *key;
@@ -421,41 +584,37 @@ static void http_build_header(http_context *ctx, swString *response, int body_le
             {
                 continue;
             }
-            if (SW_STRCASEEQ(key, keylen, "Server"))
-            {
-                header_flag |= HTTP_HEADER_SERVER;
-            }
-            else if (SW_STRCASEEQ(key, keylen, "Connection"))
-            {
-                header_flag |= HTTP_HEADER_CONNECTION;
-            }
-            else if (SW_STRCASEEQ(key, keylen, "Date"))
-            {
-                header_flag |= HTTP_HEADER_DATE;
-            }
-            else if (SW_STRCASEEQ(key, keylen, "Content-Length") && ctx->parser.method != PHP_HTTP_HEAD)
+            uint32_t flag = http_header_get_flag(key, keylen);
+            if (flag == HTTP_HEADER_CONTENT_LENGTH && ctx->parser.method != PHP_HTTP_HEAD)
             {
                 continue; // ignore
             }
-            else if (SW_STRCASEEQ(key, keylen, "Content-Type"))
-            {
-                header_flag |= HTTP_HEADER_CONTENT_TYPE;
-            }
-            else if (SW_STRCASEEQ(key, keylen, "Transfer-Encoding"))
-            {
-                header_flag |= HTTP_HEADER_TRANSFER_ENCODING;
-            }
-            if (!ZVAL_IS_NULL(zvalue))
-            {
-                zend::string str_value(zvalue);
-                n = sw_snprintf(buf, l_buf, "%.*s: %.*s\r\n", (int) keylen, key, (int) str_value.len(), str_value.val());
-                swString_append_ptr(response, buf, n);
-            }
+            header_flag |= flag;
+            zend::string str_value(zvalue);
+            swString_append_ptr(response, key, keylen);
+            swString_append_ptr(response, ZEND_STRL(": "));
+            swString_append_ptr(response, str_value.val(), str_value.len());
+            swString_append_ptr(response, ZEND_STRL("\r\n"));
         }
         SW_HASHTABLE_FOREACH_END();
         (void)type;
     }
 
+    /**
+     * the common case, all of the default headers are appended at once
+     */
+    if (!ctx->upgrade && !(header_flag & (HTTP_HEADER_SERVER | HTTP_HEADER_CONNECTION | HTTP_HEADER_CONTENT_TYPE)))
+    {
+        if (ctx->keepalive)
+        {
+            swString_append_ptr(response, ZEND_STRL(HTTP_DEFAULT_HEADERS("keep-alive")));
+        }
+        else
+        {
+            swString_append_ptr(response, ZEND_STRL(HTTP_DEFAULT_HEADERS("close")));
+        }
+        header_flag |= HTTP_HEADER_SERVER | HTTP_HEADER_CONNECTION | HTTP_HEADER_CONTENT_TYPE;
+    }
     if (!(header_flag & HTTP_HEADER_SERVER))
     {
         swString_append_ptr(response, ZEND_STRL("Server: " SW_HTTP_SERVER_SOFTWARE "\r\n"));
@@ -484,10 +643,11 @@ static void http_build_header(http_context *ctx, swString *response, int body_le
     }
     if (!(header_flag & HTTP_HEADER_DATE))
     {
-        date_str = php_swoole_format_date((char *) ZEND_STRL(SW_HTTP_DATE_FORMAT), time(NULL), 0);
-        n = sw_snprintf(buf, l_buf, "Date: %s\r\n", date_str);
-        swString_append_ptr(response, buf, n);
-        efree(date_str);
+        size_t date_len;
+        const char *date_str = swoole_http_get_date(&date_len);
+        swString_append_ptr(response, ZEND_STRL("Date: "));
+        swString_append_ptr(response, date_str, date_len);
+        swString_append_ptr(response, ZEND_STRL("\r\n"));
     }
 
     if (ctx->chunk)
@@ -506,8 +666,10 @@ static void http_build_header(http_context *ctx, swString *response, int body_le
             body_length = swoole_zlib_buffer->length;
         }
 #endif
-        n = sw_snprintf(buf, l_buf, "Content-Length: %d\r\n", body_length);
+        swString_append_ptr(response, ZEND_STRL("Content-Length: "));
+        n = swoole_itoa(buf, body_length);
         swString_append_ptr(response, buf, n);
+        swString_append_ptr(response, ZEND_STRL("\r\n"));
     }
 
     //http cookies
@@ -656,6 +818,161 @@ int swoole_http_response_compress(swString *body, int method, int level)
     return SW_OK;
 #endif
 }
+
+struct http_compress_stream
+{
+    int method;
+#ifdef SW_HAVE_ZLIB
+    z_stream zstream;
+#endif
+#ifdef SW_HAVE_BROTLI
+    BrotliEncoderState *brotli_state;
+#endif
+};
+
+http_compress_stream* swoole_http_compress_stream_new(int method, int level)
+{
+    http_compress_stream *stream = (http_compress_stream *) ecalloc(1, sizeof(http_compress_stream));
+    stream->method = method;
+
+    if (0) { }
+#ifdef SW_HAVE_ZLIB
+    else if (method == HTTP_COMPRESS_GZIP || method == HTTP_COMPRESS_DEFLATE)
+    {
+        if (level == Z_NO_COMPRESSION)
+        {
+            level = Z_DEFAULT_COMPRESSION;
+        }
+        else if (level > Z_BEST_COMPRESSION)
+        {
+            level = Z_BEST_COMPRESSION;
+        }
+        stream->zstream.zalloc = php_zlib_alloc;
+        stream->zstream.zfree = php_zlib_free;
+        int encoding = method == HTTP_COMPRESS_GZIP ? SW_ZLIB_ENCODING_GZIP : SW_ZLIB_ENCODING_RAW;
+        int status = deflateInit2(&stream->zstream, level, Z_DEFLATED, encoding, MAX_MEM_LEVEL, Z_DEFAULT_STRATEGY);
+        if (status != Z_OK)
+        {
+            swWarn("deflateInit2() failed, Error: [%d]", status);
+            efree(stream);
+            return NULL;
+        }
+    }
+#endif
+#ifdef SW_HAVE_BROTLI
+    else if (method == HTTP_COMPRESS_BR)
+    {
+        if (level < BROTLI_MIN_QUALITY || level > BROTLI_MAX_QUALITY)
+        {
+            level = BROTLI_MAX_QUALITY;
+        }
+        stream->brotli_state = BrotliEncoderCreateInstance(php_brotli_alloc, php_brotli_free, NULL);
+        if (!stream->brotli_state)
+        {
+            swWarn("BrotliEncoderCreateInstance() failed");
+            efree(stream);
+            return NULL;
+        }
+        BrotliEncoderSetParameter(stream->brotli_state, BROTLI_PARAM_QUALITY, level);
+    }
+#endif
+    else
+    {
+        swWarn("Unknown compression method");
+        efree(stream);
+        return NULL;
+    }
+
+    return stream;
+}
+
+/**
+ * compress the data and flush the encoder, the output is written to swoole_zlib_buffer
+ */
+int swoole_http_compress_stream_write(http_compress_stream *stream, const char *data, size_t length, bool finish)
+{
+    swString_clear(swoole_zlib_buffer);
+
+#ifdef SW_HAVE_ZLIB
+    if (stream->method == HTTP_COMPRESS_GZIP || stream->method == HTTP_COMPRESS_DEFLATE)
+    {
+        int flush = finish ? Z_FINISH : Z_SYNC_FLUSH;
+        int status;
+
+        stream->zstream.next_in = (Bytef *) data;
+        stream->zstream.avail_in = length;
+        do
+        {
+            size_t memory_size = deflateBound(&stream->zstream, stream->zstream.avail_in) + 16;
+            if (swoole_zlib_buffer->size - swoole_zlib_buffer->length < memory_size)
+            {
+                if (swString_extend(swoole_zlib_buffer, swoole_zlib_buffer->length + memory_size) < 0)
+                {
+                    return SW_ERR;
+                }
+            }
+            stream->zstream.next_out = (Bytef *) (swoole_zlib_buffer->str + swoole_zlib_buffer->length);
+            stream->zstream.avail_out = swoole_zlib_buffer->size - swoole_zlib_buffer->length;
+            status = deflate(&stream->zstream, flush);
+            if (status != Z_OK && status != Z_STREAM_END && status != Z_BUF_ERROR)
+            {
+                swWarn("deflate() failed, Error: [%d]", status);
+                return SW_ERR;
+            }
+            swoole_zlib_buffer->length = (char *) stream->zstream.next_out - swoole_zlib_buffer->str;
+        } while (stream->zstream.avail_out == 0 || (finish && status != Z_STREAM_END));
+        return SW_OK;
+    }
+#endif
+#ifdef SW_HAVE_BROTLI
+    if (stream->method == HTTP_COMPRESS_BR)
+    {
+        BrotliEncoderOperation op = finish ? BROTLI_OPERATION_FINISH : BROTLI_OPERATION_FLUSH;
+        size_t available_in = length;
+        const uint8_t *next_in = (const uint8_t *) data;
+
+        do
+        {
+            size_t memory_size = BrotliEncoderMaxCompressedSize(available_in) + 16;
+            if (swoole_zlib_buffer->size - swoole_zlib_buffer->length < memory_size)
+            {
+                if (swString_extend(swoole_zlib_buffer, swoole_zlib_buffer->length + memory_size) < 0)
+                {
+                    return SW_ERR;
+                }
+            }
+            size_t available_out = swoole_zlib_buffer->size - swoole_zlib_buffer->length;
+            uint8_t *next_out = (uint8_t *) (swoole_zlib_buffer->str + swoole_zlib_buffer->length);
+            if (!BrotliEncoderCompressStream(stream->brotli_state, op, &available_in, &next_in, &available_out, &next_out, NULL))
+            {
+                swWarn("BrotliEncoderCompressStream() failed");
+                return SW_ERR;
+            }
+            swoole_zlib_buffer->length = (char *) next_out - swoole_zlib_buffer->str;
+        } while (available_in > 0 || BrotliEncoderHasMoreOutput(stream->brotli_state)
+                || (finish && !BrotliEncoderIsFinished(stream->brotli_state)));
+        return SW_OK;
+    }
+#endif
+    return SW_ERR;
+}
+
+void swoole_http_compress_stream_free(http_compress_stream *stream)
+{
+#ifdef SW_HAVE_ZLIB
+    if (stream->method == HTTP_COMPRESS_GZIP || stream->method == HTTP_COMPRESS_DEFLATE)
+    {
+        deflateEnd(&stream->zstream);
+    }
+#endif
+#ifdef SW_HAVE_BROTLI
+    if (stream->method == HTTP_COMPRESS_BR)
+    {
+        BrotliEncoderDestroyInstance(stream->brotli_state);
+    }
+#endif
+    efree(stream);
+}
 #endif
 
 static PHP_METHOD(swoole_http_response, initHeader)
@@ -718,6 +1035,24 @@ void swoole_http_response_end(http_context *ctx, zval *zdata, zval *return_value
 
     if (ctx->chunk)
     {
+#ifdef SW_HAVE_COMPRESSION
+        if (ctx->compress_stream)
+        {
+            int ret = swoole_http_compress_stream_write(ctx->compress_stream, NULL, 0, true);
+            swoole_http_compress_stream_free(ctx->compress_stream);
+            ctx->compress_stream = NULL;
+            if (ret != SW_OK)
+            {
+                ctx->end = 1;
+                ctx->close(ctx);
+                RETURN_FALSE;
+            }
+            if (swoole_zlib_buffer->length > 0 && !http_send_chunk(ctx, http_get_write_buffer(ctx), swoole_zlib_buffer->str, swoole_zlib_buffer->length))
+            {
+                RETURN_FALSE;
+            }
+        }
+#endif
         if (!ctx->send(ctx, ZEND_STRL("0\r\n\r\n")))
         {
             RETURN_FALSE;
@@ -824,6 +1159,7 @@ void swoole_http_response_end(http_context *ctx, zval *zdata, zval *return_value
         ctx->close(ctx);
     }
     ctx->end = 1;
+    swoole_http_batch_complete(ctx);
     RETURN_TRUE;
 }
 
@@ -977,6 +1313,7 @@ static PHP_METHOD(swoole_http_response, sendfile)
     }
 
     ctx->end = 1;
+    swoole_http_batch_complete(ctx);
     RETURN_TRUE;
 }
 
@@ -1140,6 +1477,83 @@ static PHP_METHOD(swoole_http_response, header)
     RETURN_BOOL(swoole_http_response_set_header(ctx, k, klen, v, vlen, ucwords));
 }
 
+static PHP_METHOD(swoole_http_response, createHeaderTemplate)
+{
+    zval *zheaders;
+
+    ZEND_PARSE_PARAMETERS_START(1, 1)
+        Z_PARAM_ARRAY(zheaders)
+    ZEND_PARSE_PARAMETERS_END_EX(RETURN_FALSE);
+
+    http_header_template *tpl = new http_header_template;
+    tpl->header_flag = 0;
+
+    zend_string *key;
+    zval *zvalue;
+    ZEND_HASH_FOREACH_STR_KEY_VAL(Z_ARRVAL_P(zheaders), key, zvalue)
+    {
+        if (UNEXPECTED(!key || ZVAL_IS_NULL(zvalue)))
+        {
+            continue;
+        }
+        size_t klen = ZSTR_LEN(key);
+        zend::string str_value(zvalue);
+        if (UNEXPECTED(klen > SW_HTTP_HEADER_KEY_SIZE - 1 || str_value.len() > SW_HTTP_HEADER_VALUE_SIZE - 1))
+        {
+            php_swoole_error(E_WARNING, "header '%s' is too long", ZSTR_VAL(key));
+            delete tpl;
+            RETURN_FALSE;
+        }
+        uint32_t flag = http_header_get_flag(ZSTR_VAL(key), klen);
+        if (flag == HTTP_HEADER_CONTENT_LENGTH)
+        {
+            php_swoole_error(E_WARNING, "Content-Length can not be a part of the header template");
+            continue;
+        }
+        tpl->header_flag |= flag;
+
+        char key_buf[SW_HTTP_HEADER_KEY_SIZE];
+        strncpy(key_buf, ZSTR_VAL(key), klen)[klen] = '\0';
+        zend_str_tolower(key_buf, klen);
+        tpl->headers.emplace_back(std::string(key_buf, klen), std::string(str_value.val(), str_value.len()));
+        http_header_key_format(key_buf, klen);
+        tpl->data.append(key_buf, klen);
+        tpl->data.append(": ");
+        tpl->data.append(str_value.val(), str_value.len());
+        tpl->data.append("\r\n");
+    }
+    ZEND_HASH_FOREACH_END();
+
+    if (header_templates.empty())
+    {
+        php_swoole_register_rshutdown_callback(http_header_templates_free, nullptr);
+    }
+    header_templates.push_back(tpl);
+    RETURN_LONG(header_templates.size());
+}
+
+static PHP_METHOD(swoole_http_response, headerTemplate)
+{
+    zend_long id;
+
+    ZEND_PARSE_PARAMETERS_START(1, 1)
+        Z_PARAM_LONG(id)
+    ZEND_PARSE_PARAMETERS_END_EX(RETURN_FALSE);
+
+    http_context *ctx = php_swoole_http_response_get_and_check_context(ZEND_THIS);
+    if (UNEXPECTED(!ctx))
+    {
+        RETURN_FALSE;
+    }
+    if (UNEXPECTED(id < 0 || (size_t) id > header_templates.size()))
+    {
+        php_swoole_error(E_WARNING, "header template#" ZEND_LONG_FMT " does not exist", id);
+        RETURN_FALSE;
+    }
+    ctx->response.header_template = id;
+    RETURN_TRUE;
+}
+
 #ifdef SW_USE_HTTP2
 static PHP_METHOD(swoole_http_response, trailer)
 {
@@ -37,9 +37,54 @@ swString *swoole_http_form_data_buffer;
 zend_class_entry *swoole_http_server_ce;
 zend_object_handlers swoole_http_server_handlers;
 
+struct http_batch_slot
+{
+    swString *output;
+    /**
+     * the file queued behind the output, and the output which follows it
+     */
+    char *file;
+    off_t file_offset;
+    size_t file_length;
+    swString *tail;
+    bool ready;
+    bool close;
+};
+
+struct http_batch
+{
+    swServer *serv;
+    int fd;
+    uint32_t num;
+    /**
+     * the output of the requests before it has been moved into the buffer
+     */
+    uint32_t next;
+    uint32_t ref_count;
+    bool dispatching;
+    bool closed;
+    bool close_sent;
+    swString *buffer;
+    http_batch_slot *slots;
+};
+
 static bool http_context_send_data(http_context* ctx, const char *data, size_t length);
 static bool http_context_send_file(http_context* ctx, const char *file, uint32_t l_file, off_t offset, size_t length);
 static bool http_context_disconnect(http_context* ctx);
+static bool http_context_batch_send_data(http_context* ctx, const char *data, size_t length);
+static bool http_context_batch_send_file(http_context* ctx, const char *file, uint32_t l_file, off_t offset, size_t length);
+static bool http_context_batch_disconnect(http_context* ctx);
+
+static void http_server_dispatch(swServer *serv, swConnection *conn, int from_fd, http_context *ctx);
+static void http_server_call(swServer *serv, swConnection *conn, int from_fd, http_context *ctx);
+static int http_server_dispatch_batch(swServer *serv, swConnection *conn, int from_fd, swEventData *req);
+static int http_server_stream_body(swServer *serv, swEventData *req);
+static void http_server_release(http_context *ctx);
+
+/**
+ * the requests whose body is still arriving, session_id => context
+ */
+static std::unordered_map<int, http_context *> http_body_streams;
 
 int php_swoole_http_onReceive(swServer *serv, swEventData *req)
 {
@@ -71,17 +116,34 @@ int php_swoole_http_onReceive(swServer *serv, swEventData *req)
     }
 #endif
 
+    if (req->info.flags & SW_EVENT_DATA_BATCH)
+    {
+        return http_server_dispatch_batch(serv, conn, from_fd, req);
+    }
+    if (req->info.flags & SW_EVENT_DATA_STREAM_BODY)
+    {
+        return http_server_stream_body(serv, req);
+    }
+
     http_context *ctx = swoole_http_context_new(fd);
     swoole_http_server_init_context(serv, ctx);
+    if (req->info.flags & SW_EVENT_DATA_STREAM_BEGIN)
+    {
+        ctx->stream_body = 1;
+    }
 
     zval *zdata = &ctx->request.zdata;
     php_swoole_get_recv_data(serv, zdata, req, NULL, 0);
 
     swTraceLog(SW_TRACE_SERVER, "http request from %d with %d bytes: <<EOF\n%.*s\nEOF", fd, (int) Z_STRLEN_P(zdata), (int) Z_STRLEN_P(zdata), Z_STRVAL_P(zdata));
 
-    zval args[2], *zrequest_object = &args[0], *zresponse_object = &args[1];
-    args[0] = *ctx->request.zobject;
-    args[1] = *ctx->response.zobject;
+    http_server_dispatch(serv, conn, from_fd, ctx);
+    return SW_OK;
+}
+
+static void http_server_dispatch(swServer *serv, swConnection *conn, int from_fd, http_context *ctx)
+{
+    zval *zdata = &ctx->request.zdata;
 
     swoole_http_parser *parser = &ctx->parser;
     parser->data = ctx;
@@ -95,7 +157,8 @@ int php_swoole_http_onReceive(swServer *serv, swEventData *req)
 #endif
         ctx->close(ctx);
         swNotice("request is illegal and it has been discarded, %ld bytes unprocessed", Z_STRLEN_P(zdata) - parsed_n);
-        goto _dtor_and_return;
+        http_server_release(ctx);
+        return;
     }
 
     do {
@@ -103,13 +166,33 @@ int php_swoole_http_onReceive(swServer *serv, swEventData *req)
         swConnection *serv_sock = swServer_connection_get(serv, conn->server_fd);
         if (serv_sock)
         {
-            add_assoc_long(zserver, "server_port", swConnection_get_port(serv_sock->socket_type, &serv_sock->info));
+            add_assoc_long(zserver, "server_port", swConnection_get_port(serv_sock->socket_type, &serv_sock->cold->info));
         }
-        add_assoc_long(zserver, "remote_port", swConnection_get_port(conn->socket_type, &conn->info));
-        add_assoc_string(zserver, "remote_addr", (char *) swConnection_get_ip(conn->socket_type, &conn->info));
+        add_assoc_long(zserver, "remote_port", swConnection_get_port(conn->socket_type, &conn->cold->info));
+        add_assoc_string(zserver, "remote_addr", (char *) swConnection_get_ip(conn->socket_type, &conn->cold->info));
         add_assoc_long(zserver, "master_time", conn->last_time);
     } while (0);
 
+    if (ctx->stream_body && !ctx->completed)
+    {
+        http_body_streams[ctx->fd] = ctx;
+        // without coroutine the handler can not wait for the body, it is called after the last chunk
+        if (!SwooleG.enable_coroutine)
+        {
+            return;
+        }
+    }
+
+    http_server_call(serv, conn, from_fd, ctx);
+}
+
+static void http_server_call(swServer *serv, swConnection *conn, int from_fd, http_context *ctx)
+{
+    swListenPort *port = (swListenPort *) serv->connection_list[from_fd].object;
+    zval args[2], *zrequest_object = &args[0], *zresponse_object = &args[1];
+    args[0] = *ctx->request.zobject;
+    args[1] = *ctx->response.zobject;
+
     // begin to check and call registerd callback
     do {
         zend_fcall_info_cache *fci_cache = NULL;
@@ -151,6 +234,277 @@ int php_swoole_http_onReceive(swServer *serv, swEventData *req)
     _dtor_and_return:
     zval_ptr_dtor(zrequest_object);
     zval_ptr_dtor(zresponse_object);
+}
+
+static void http_server_release(http_context *ctx)
+{
+    zval zrequest_object = *ctx->request.zobject, zresponse_object = *ctx->response.zobject;
+    zval_ptr_dtor(&zrequest_object);
+    zval_ptr_dtor(&zresponse_object);
+}
+
+static void http_server_stream_wakeup(http_context *ctx)
+{
+    if (ctx->stream_reader)
+    {
+        Coroutine *co = ctx->stream_reader;
+        ctx->stream_reader = nullptr;
+        co->resume();
+    }
+}
+
+/**
+ * the rest of the body will never arrive, the handler has not been called without coroutine
+ */
+static void http_server_stream_abort(http_context *ctx)
+{
+    ctx->stream_aborted = 1;
+    if (!SwooleG.enable_coroutine)
+    {
+        http_server_release(ctx);
+    }
+    else
+    {
+        http_server_stream_wakeup(ctx);
+    }
+}
+
+static int http_server_stream_body(swServer *serv, swEventData *req)
+{
+    auto i = http_body_streams.find(req->info.fd);
+    // the request has been finished or discarded, drop the rest of its body
+    if (i == http_body_streams.end())
+    {
+        return SW_OK;
+    }
+    http_context *ctx = i->second;
+
+    zval zdata;
+    php_swoole_get_recv_data(serv, &zdata, req, NULL, 0);
+    size_t parsed_n = swoole_http_requset_parse(ctx, Z_STRVAL(zdata), Z_STRLEN(zdata));
+    bool failed = parsed_n < Z_STRLEN(zdata);
+    zval_ptr_dtor(&zdata);
+
+    if (failed)
+    {
+        http_body_streams.erase(i);
+        swNotice("the body of request#%d is illegal and it has been discarded", ctx->fd);
+        ctx->close(ctx);
+        http_server_stream_abort(ctx);
+        return SW_ERR;
+    }
+    if (ctx->completed)
+    {
+        http_body_streams.erase(i);
+        if (!SwooleG.enable_coroutine)
+        {
+            swConnection *conn = swServer_connection_verify(serv, req->info.fd);
+            if (conn)
+            {
+                http_server_call(serv, conn, req->info.server_fd, ctx);
+            }
+            else
+            {
+                http_server_release(ctx);
+            }
+            return SW_OK;
+        }
+    }
+    http_server_stream_wakeup(ctx);
+    return SW_OK;
+}
+
+static http_batch* http_batch_new(swServer *serv, int fd, uint32_t num)
+{
+    http_batch *batch = (http_batch *) ecalloc(1, sizeof(http_batch));
+    batch->serv = serv;
+    batch->fd = fd;
+    batch->num = num;
+    batch->ref_count = 1;
+    batch->dispatching = true;
+    batch->buffer = swString_new(SW_BUFFER_SIZE_STD);
+    batch->slots = (http_batch_slot *) ecalloc(num, sizeof(http_batch_slot));
+    return batch;
+}
+
+static void http_batch_release(http_batch *batch)
+{
+    if (--batch->ref_count > 0)
+    {
+        return;
+    }
+    for (uint32_t i = 0; i < batch->num; i++)
+    {
+        if (batch->slots[i].output)
+        {
+            swString_free(batch->slots[i].output);
+        }
+        if (batch->slots[i].file)
+        {
+            efree(batch->slots[i].file);
+        }
+        if (batch->slots[i].tail)
+        {
+            swString_free(batch->slots[i].tail);
+        }
+    }
+    swString_free(batch->buffer);
+    efree(batch->slots);
+    efree(batch);
+}
+
+static bool http_batch_write(http_batch *batch);
+
+/**
+ * the coalesced output is bounded by the output buffer size of the connection
+ */
+static bool http_batch_append(http_batch *batch, const char *data, size_t length)
+{
+    if (batch->buffer->length > 0 && batch->buffer->length + length > batch->serv->buffer_output_size)
+    {
+        if (!http_batch_write(batch))
+        {
+            return false;
+        }
+    }
+    return swString_append_ptr(batch->buffer, data, length) == SW_OK;
+}
+
+/**
+ * move the output of the completed requests into the buffer in order,
+ * the partial output of the first pending one follows them
+ */
+static void http_batch_advance(http_batch *batch)
+{
+    while (batch->next < batch->num && !batch->closed)
+    {
+        http_batch_slot *slot = &batch->slots[batch->next];
+        if (slot->output)
+        {
+            http_batch_append(batch, slot->output->str, slot->output->length);
+            swString_free(slot->output);
+            slot->output = nullptr;
+        }
+        if (slot->file)
+        {
+            if (!http_batch_write(batch)
+                    || batch->serv->sendfile(batch->serv, batch->fd, slot->file, strlen(slot->file), slot->file_offset, slot->file_length) < 0)
+            {
+                batch->closed = true;
+            }
+            efree(slot->file);
+            slot->file = nullptr;
+            if (slot->tail)
+            {
+                slot->output = slot->tail;
+                slot->tail = nullptr;
+                continue;
+            }
+        }
+        if (!slot->ready)
+        {
+            break;
+        }
+        if (slot->close)
+        {
+            batch->closed = true;
+        }
+        batch->next++;
+    }
+}
+
+/**
+ * the responses behind a failed send are not sent, the client would take them for the ones of the earlier requests,
+ * the connection is closed and the end() of the pending requests returns false
+ */
+static bool http_batch_write(http_batch *batch)
+{
+    swServer *serv = batch->serv;
+    bool ret = true;
+    if (batch->buffer->length > 0)
+    {
+        if (serv->send(serv, batch->fd, batch->buffer->str, batch->buffer->length) < 0)
+        {
+            batch->closed = true;
+            ret = false;
+        }
+        swString_clear(batch->buffer);
+    }
+    if (batch->closed && !batch->close_sent)
+    {
+        serv->close(serv, batch->fd, 0);
+        batch->close_sent = true;
+    }
+    return ret;
+}
+
+/**
+ * the output is only coalesced while the connection can take it
+ */
+static bool http_batch_writable(http_batch *batch)
+{
+    swConnection *conn = swServer_connection_verify(batch->serv, batch->fd);
+    return conn && !conn->overflow;
+}
+
+void swoole_http_batch_complete(http_context *ctx)
+{
+    http_batch *batch = ctx->batch;
+    if (!batch)
+    {
+        return;
+    }
+    ctx->batch = nullptr;
+    batch->slots[ctx->batch_index].ready = true;
+    http_batch_advance(batch);
+    if (!batch->dispatching)
+    {
+        http_batch_write(batch);
+    }
+    http_batch_release(batch);
+}
+
+/**
+ * the requests of a pipeline have no body, they are split at the end of the header,
+ * the responses of the synchronous handlers are sent by one write after the last one returns
+ */
+static int http_server_dispatch_batch(swServer *serv, swConnection *conn, int from_fd, swEventData *req)
+{
+    zval zdata;
+    php_swoole_get_recv_data(serv, &zdata, req, NULL, 0);
+
+    const char *p = Z_STRVAL(zdata), *pe = p + Z_STRLEN(zdata);
+    uint32_t num = 0;
+    int n;
+    for (const char *q = p; (n = swoole_strnpos(q, pe - q, ZEND_STRL("\r\n\r\n"))) >= 0; q += n + 4)
+    {
+        num++;
+    }
+
+    http_batch *batch = http_batch_new(serv, req->info.fd, num);
+    for (uint32_t i = 0; i < num && !batch->closed; i++)
+    {
+        size_t length = swoole_strnpos(p, pe - p, ZEND_STRL("\r\n\r\n")) + 4;
+
+        http_context *ctx = swoole_http_context_new(req->info.fd);
+        swoole_http_server_init_context(serv, ctx);
+        ctx->send = http_context_batch_send_data;
+        ctx->sendfile = http_context_batch_send_file;
+        ctx->close = http_context_batch_disconnect;
+        ctx->batch = batch;
+        ctx->batch_index = i;
+        batch->ref_count++;
+
+        ZVAL_STRINGL(&ctx->request.zdata, p, length);
+        p += length;
+
+        http_server_dispatch(serv, conn, from_fd, ctx);
+    }
+    zval_ptr_dtor(&zdata);
+
+    batch->dispatching = false;
+    http_batch_write(batch);
+    http_batch_release(batch);
 
     return SW_OK;
 }
@@ -168,6 +522,13 @@ void php_swoole_http_onClose(swServer *serv, swDataHead *ev)
         swoole_http2_server_session_free(conn);
     }
 #endif
+    auto i = http_body_streams.find(ev->fd);
+    if (i != http_body_streams.end())
+    {
+        http_context *ctx = i->second;
+        http_body_streams.erase(i);
+        http_server_stream_abort(ctx);
+    }
     php_swoole_onClose(serv, ev);
 }
 
@@ -251,6 +612,21 @@ void swoole_http_context_free(http_context *ctx)
     {
         return;
     }
+    swoole_http_batch_complete(ctx);
+    if (ctx->stream_body)
+    {
+        auto i = http_body_streams.find(ctx->fd);
+        if (i != http_body_streams.end() && i->second == ctx)
+        {
+            http_body_streams.erase(i);
+        }
+        // the handler has finished without reading the whole body, the rest of it is received and dropped
+        if (ctx->stream_paused)
+        {
+            swServer *serv = (swServer *) ctx->private_data;
+            serv->feedback(serv, ctx->fd, SW_SERVER_EVENT_RESUME_RECV);
+        }
+    }
 #ifdef SW_USE_HTTP2
     if (ctx->stream)
     {
@@ -274,10 +650,20 @@ void swoole_http_context_free(http_context *ctx)
         swString_free(req->h2_data_buffer);
     }
 #endif
+    if (req->stream_buffer)
+    {
+        swString_free(req->stream_buffer);
+    }
     if (res->reason)
     {
         efree(res->reason);
     }
+#ifdef SW_HAVE_COMPRESSION
+    if (ctx->compress_stream)
+    {
+        swoole_http_compress_stream_free(ctx->compress_stream);
+    }
+#endif
     efree(ctx);
 }
 
@@ -356,3 +742,94 @@ static bool http_context_disconnect(http_context* ctx)
     swServer *serv = (swServer *) ctx->private_data;
     return serv->close(serv, ctx->fd, 0) == SW_OK;
 }
+
+static bool http_context_batch_send_data(http_context* ctx, const char *data, size_t length)
+{
+    http_batch *batch = ctx->batch;
+    if (!batch)
+    {
+        return http_context_send_data(ctx, data, length);
+    }
+    if (batch->closed)
+    {
+        return false;
+    }
+    if (ctx->batch_index == batch->next)
+    {
+        /**
+         * the output of the previous requests is in the buffer, append to it directly while dispatching,
+         * otherwise flush it and send this one by itself, so end() reports the send and send_yield works
+         */
+        if (batch->dispatching && http_batch_writable(batch))
+        {
+            return http_batch_append(batch, data, length);
+        }
+        if (!http_batch_write(batch))
+        {
+            return false;
+        }
+        return http_context_send_data(ctx, data, length);
+    }
+    http_batch_slot *slot = &batch->slots[ctx->batch_index];
+    swString **output = slot->file ? &slot->tail : &slot->output;
+    if (!*output)
+    {
+        *output = swString_new(SW_MAX(length, SW_BUFFER_SIZE_STD));
+        if (!*output)
+        {
+            return false;
+        }
+    }
+    return swString_append_ptr(*output, data, length) == SW_OK;
+}
+
+/**
+ * the file of the first pending request is sent after the buffered output,
+ * the ones of the requests behind it are queued in their slots until their turn
+ */
+static bool http_context_batch_send_file(http_context* ctx, const char *file, uint32_t l_file, off_t offset, size_t length)
+{
+    http_batch *batch = ctx->batch;
+    if (!batch)
+    {
+        return http_context_send_file(ctx, file, l_file, offset, length);
+    }
+    if (batch->closed)
+    {
+        return false;
+    }
+    if (ctx->batch_index == batch->next)
+    {
+        if (!http_batch_write(batch))
+        {
+            return false;
+        }
+        return http_context_send_file(ctx, file, l_file, offset, length);
+    }
+    http_batch_slot *slot = &batch->slots[ctx->batch_index];
+    if (slot->file)
+    {
+        swWarn("only one file can be queued by a pipelined request");
+        return false;
+    }
+    slot->file = estrndup(file, l_file);
+    slot->file_offset = offset;
+    slot->file_length = length;
+    return true;
+}
+
+/**
+ * the connection is closed after the responses of the previous requests are sent
+ */
+static bool http_context_batch_disconnect(http_context* ctx)
+{
+    http_batch *batch = ctx->batch;
+    if (!batch)
+    {
+        return http_context_disconnect(ctx);
+    }
+    batch->slots[ctx->batch_index].close = true;
+    ctx->end = 1;
+    swoole_http_batch_complete(ctx);
+    return true;
+}
@@ -116,6 +116,9 @@ void php_swoole_lock_minit(int module_number)
 #endif
 #ifdef HAVE_SPINLOCK
     zend_declare_class_constant_long(swoole_lock_ce, ZEND_STRL("SPINLOCK"), SW_SPINLOCK);
+#endif
+#ifdef HAVE_EVENTFD
+    zend_declare_class_constant_long(swoole_lock_ce, ZEND_STRL("COROLOCK"), SW_COROLOCK);
 #endif
     zend_declare_property_long(swoole_lock_ce, ZEND_STRL("errCode"), 0, ZEND_ACC_PUBLIC);
 
@@ -128,6 +131,9 @@ void php_swoole_lock_minit(int module_number)
 #ifdef HAVE_SPINLOCK
     SW_REGISTER_LONG_CONSTANT("SWOOLE_SPINLOCK", SW_SPINLOCK);
 #endif
+#ifdef HAVE_EVENTFD
+    SW_REGISTER_LONG_CONSTANT("SWOOLE_COROLOCK", SW_COROLOCK);
+#endif
 }
 
 static PHP_METHOD(swoole_lock, __construct)
@@ -186,6 +192,11 @@ static PHP_METHOD(swoole_lock, __construct)
     case SW_SPINLOCK:
         ret = swSpinLock_create(lock, 1);
         break;
+#endif
+#ifdef HAVE_EVENTFD
+    case SW_COROLOCK:
+        ret = swCoroLock_create(lock);
+        break;
 #endif
     case SW_MUTEX:
     default:
@@ -219,9 +230,15 @@ static PHP_METHOD(swoole_lock, lockwait)
         RETURN_FALSE;
     }
     swLock *lock = php_swoole_lock_get_and_check_ptr(ZEND_THIS);
+#ifdef HAVE_EVENTFD
+    if (lock->type == SW_COROLOCK)
+    {
+        SW_LOCK_CHECK_RETURN(swCoroLock_lockwait(lock, timeout));
+    }
+#endif
     if (lock->type != SW_MUTEX)
     {
-        zend_throw_exception(swoole_exception_ce, "only mutex supports lockwait", -2);
+        zend_throw_exception(swoole_exception_ce, "only mutex and corolock support lockwait", -2);
         RETURN_FALSE;
     }
     SW_LOCK_CHECK_RETURN(swMutex_lockwait(lock, (int)timeout * 1000));
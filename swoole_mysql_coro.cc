@@ -20,6 +20,7 @@
 #include "php_swoole_cxx.h"
 
 #include "swoole_mysql_proto.h"
+#include "lru_cache.h"
 
 // see mysqlnd 'L64' macro redefined
 #undef L64
@@ -35,6 +36,7 @@ extern "C" {
 }
 
 #include <unordered_map>
+#include <vector>
 
 using namespace swoole;
 using swoole::coroutine::Socket;
@@ -72,6 +74,11 @@ public:
 
     std::unordered_map<uint32_t, mysql_statement*> statements;
     mysql_statement* statement = nullptr;
+    /* prepared statements keyed by the sql text, only if statement_cache_size is set */
+    LRUCache *statement_cache = nullptr;
+    size_t statement_cache_size = 0;
+    /* ids of the evicted statements, their COM_STMT_CLOSE goes out with the next command */
+    std::vector<uint32_t> closing_statements;
     /* }}} */
 
     std::string host = SW_MYSQL_DEFAULT_HOST;
@@ -326,6 +333,11 @@ public:
                 io_error();
                 return false;
             }
+            if (sw_unlikely(!closing_statements.empty() && !send_closing_statements()))
+            {
+                io_error();
+                return false;
+            }
             if (sw_unlikely(socket->send_all(data, length) != (ssize_t ) length))
             {
                 io_error();
@@ -352,14 +364,21 @@ public:
     void next_result(zval *return_value);
     bool recv();
 
+    // [statement, params] for COM_STMT_EXECUTE, [nullptr, sql] for COM_QUERY
+    void pipeline(zval *return_value, const std::vector<std::pair<mysql_statement*, zval*>> &requests);
+
     bool send_prepare_request(const char *statement, size_t statement_length);
     mysql_statement* recv_prepare_response();
 
+    void set_statement_cache_size(size_t size);
+    mysql_statement* get_cached_statement(const char *statement, size_t statement_length);
+
     void close();
 
 
     ~mysql_client()
     {
+        set_statement_cache_size(0);
         SW_ASSERT(statements.empty());
         close();
     }
@@ -375,6 +394,8 @@ private:
 
     // recv data of specified length
     const char* recv_length(size_t need_length, const bool try_to_recycle = false);
+    // send COM_STMT_CLOSE of the evicted statements in one write
+    bool send_closing_statements();
     // usually mysql->connect = connect(TCP) + handshake
     bool handshake();
 };
@@ -385,6 +406,10 @@ public:
     std::string statement;
     mysql::statement info;
     mysql::result_info result;
+    /* held by the statement cache of the client */
+    bool cached = false;
+    /* the number of statement objects which share it */
+    uint32_t ref_count = 0;
 
     mysql_statement(mysql_client *client, const char *statement, size_t statement_length) :
             client(client)
@@ -455,6 +480,11 @@ public:
             // if client point exists, socket is always available
             if (notify)
             {
+                if (cached)
+                {
+                    // the other statement objects which share it are closed too
+                    client->statement_cache->del(statement);
+                }
                 if (sw_likely(client->is_writable()))
                 {
                     char id[4];
@@ -472,6 +502,40 @@ public:
         }
     }
 
+    // the statement is not used by anyone, it will be closed by the next command of the client
+    inline void close_later()
+    {
+        if (client)
+        {
+            if (client->is_connect())
+            {
+                client->closing_statements.push_back(info.id);
+            }
+            client->statements.erase(info.id);
+            client = nullptr;
+        }
+    }
+
+    // removed from the statement cache
+    inline void uncache()
+    {
+        cached = false;
+        if (ref_count == 0)
+        {
+            close_later();
+            delete this;
+        }
+    }
+
+    // the statement object is released
+    inline void release()
+    {
+        if (--ref_count == 0 && !cached)
+        {
+            delete this;
+        }
+    }
+
     ~mysql_statement()
     {
         close();
@@ -481,6 +545,7 @@ public:
     bool recv_prepare_response();
 
     void execute(zval *return_value, zval *params);
+    bool append_execute_request(swString *buffer, zval *params);
     void send_execute_request(zval *return_value, zval *params);
     void recv_execute_response(zval *return_value);
 
@@ -525,6 +590,7 @@ static PHP_METHOD(swoole_mysql_coro, fetch);
 static PHP_METHOD(swoole_mysql_coro, fetchAll);
 static PHP_METHOD(swoole_mysql_coro, nextResult);
 static PHP_METHOD(swoole_mysql_coro, prepare);
+static PHP_METHOD(swoole_mysql_coro, pipeline);
 static PHP_METHOD(swoole_mysql_coro, recv);
 static PHP_METHOD(swoole_mysql_coro, begin);
 static PHP_METHOD(swoole_mysql_coro, commit);
@@ -562,6 +628,11 @@ ZEND_BEGIN_ARG_INFO_EX(arginfo_swoole_mysql_coro_prepare, 0, 0, 1)
     ZEND_ARG_INFO(0, timeout)
 ZEND_END_ARG_INFO()
 
+ZEND_BEGIN_ARG_INFO_EX(arginfo_swoole_mysql_coro_pipeline, 0, 0, 1)
+    ZEND_ARG_ARRAY_INFO(0, requests, 0)
+    ZEND_ARG_INFO(0, timeout)
+ZEND_END_ARG_INFO()
+
 ZEND_BEGIN_ARG_INFO_EX(arginfo_swoole_mysql_coro_setDefer, 0, 0, 0)
     ZEND_ARG_INFO(0, defer)
 ZEND_END_ARG_INFO()
@@ -590,6 +661,7 @@ static const zend_function_entry swoole_mysql_coro_methods[] =
     PHP_ME(swoole_mysql_coro, fetchAll, arginfo_swoole_void, ZEND_ACC_PUBLIC)
     PHP_ME(swoole_mysql_coro, nextResult, arginfo_swoole_void, ZEND_ACC_PUBLIC)
     PHP_ME(swoole_mysql_coro, prepare, arginfo_swoole_mysql_coro_prepare, ZEND_ACC_PUBLIC)
+    PHP_ME(swoole_mysql_coro, pipeline, arginfo_swoole_mysql_coro_pipeline, ZEND_ACC_PUBLIC)
     PHP_ME(swoole_mysql_coro, recv, arginfo_swoole_void, ZEND_ACC_PUBLIC)
     PHP_ME(swoole_mysql_coro, begin, arginfo_swoole_optional_timeout, ZEND_ACC_PUBLIC)
     PHP_ME(swoole_mysql_coro, commit, arginfo_swoole_optional_timeout, ZEND_ACC_PUBLIC)
@@ -803,6 +875,20 @@ void mysql_client::send_command_without_check(enum sw_mysql_command command, con
     (void) (socket && socket->send(command_packet.get_data(), command_packet.get_data_length()));
 }
 
+bool mysql_client::send_closing_statements()
+{
+    std::string data;
+    char id[4];
+    for (auto statement_id : closing_statements)
+    {
+        sw_mysql_int4store(id, statement_id);
+        mysql::command_packet command_packet(SW_MYSQL_COM_STMT_CLOSE, id, sizeof(id));
+        data.append(command_packet.get_data(), command_packet.get_data_length());
+    }
+    closing_statements.clear();
+    return socket->send_all(data.c_str(), data.length()) == (ssize_t) data.length();
+}
+
 bool mysql_client::handshake()
 {
     const char *data;
@@ -1260,6 +1346,115 @@ void mysql_client::next_result(zval *return_value)
     }
 }
 
+void mysql_client::pipeline(zval *return_value, const std::vector<std::pair<mysql_statement*, zval*>> &requests)
+{
+    if (sw_unlikely(defer || fetch_mode))
+    {
+        non_sql_error(ENOTSUP, "Can not use pipeline when defer or fetch mode is on");
+        RETURN_FALSE;
+    }
+    if (sw_unlikely(!is_available_for_new_reuqest()))
+    {
+        RETURN_FALSE;
+    }
+    if (requests.empty())
+    {
+        array_init(return_value);
+        return;
+    }
+
+    /* all of the requests are sent in one write */
+    swString *buffer = swString_new(SwooleG.pagesize);
+    if (sw_unlikely(!buffer))
+    {
+        non_sql_error(MYSQLND_CR_OUT_OF_MEMORY, strerror(ENOMEM));
+        RETURN_FALSE;
+    }
+    for (size_t i = 0; i < requests.size(); i++)
+    {
+        mysql_statement *statement = requests[i].first;
+        size_t offset = buffer->length;
+        if (statement)
+        {
+            if (sw_unlikely(!statement->append_execute_request(buffer, requests[i].second)))
+            {
+                swString_free(buffer);
+                RETURN_FALSE;
+            }
+        }
+        else
+        {
+            zend::string sql(requests[i].second);
+            mysql::command_packet command_packet(SW_MYSQL_COM_QUERY);
+            if (sw_unlikely(
+                swString_append_ptr(buffer, command_packet.get_data(), SW_MYSQL_PACKET_HEADER_SIZE + 1) < 0 ||
+                swString_append_ptr(buffer, sql.val(), sql.len()) < 0
+            ))
+            {
+                non_sql_error(MYSQLND_CR_OUT_OF_MEMORY, strerror(ENOMEM));
+                swString_free(buffer);
+                RETURN_FALSE;
+            }
+        }
+        size_t length = buffer->length - offset - SW_MYSQL_PACKET_HEADER_SIZE;
+        if (sw_unlikely(length > SW_MYSQL_MAX_PACKET_BODY_SIZE))
+        {
+            non_sql_error(EMSGSIZE, "Request#%zu is too large for the pipeline", i);
+            swString_free(buffer);
+            RETURN_FALSE;
+        }
+        mysql::packet::set_header(buffer->str + offset, length, 0);
+    }
+    bool ret = send_raw(buffer->str, buffer->length);
+    swString_free(buffer);
+    if (sw_unlikely(!ret))
+    {
+        RETURN_FALSE;
+    }
+
+    /* the server answers the requests in order */
+    array_init(return_value);
+    for (auto &request : requests)
+    {
+        mysql_statement *statement = request.first;
+        zval zresult, zmore;
+        if (statement)
+        {
+            state = SW_MYSQL_STATE_EXECUTE;
+            statement->recv_execute_response(&zresult);
+        }
+        else
+        {
+            state = SW_MYSQL_STATE_QUERY;
+            recv_query_response(&zresult);
+        }
+        // only the first result of a procedure is kept
+        while (state != SW_MYSQL_STATE_IDLE && is_connect())
+        {
+            if (statement)
+            {
+                statement->next_result(&zmore);
+            }
+            else
+            {
+                next_result(&zmore);
+            }
+            if (Z_TYPE(zmore) == IS_FALSE)
+            {
+                break;
+            }
+            zval_ptr_dtor(&zmore);
+        }
+        if (sw_unlikely(!is_connect()))
+        {
+            zval_ptr_dtor(&zresult);
+            zval_ptr_dtor(return_value);
+            RETURN_FALSE;
+        }
+        (void) add_next_index_zval(return_value, &zresult);
+    }
+}
+
 bool mysql_client::send_prepare_request(const char *statement, size_t statement_length)
 {
     this->statement = new mysql_statement(this, statement, statement_length);
@@ -1285,11 +1480,47 @@ mysql_statement* mysql_client::recv_prepare_response()
             return nullptr;
         }
         statements[statement->info.id] = statement;
+        if (statement_cache)
+        {
+            statement->cached = true;
+            // replaced or evicted statements are closed once nobody uses them
+            statement_cache->set(statement->statement, std::shared_ptr<mysql_statement>(statement, [](mysql_statement *statement) {
+                statement->uncache();
+            }));
+        }
         return statement;
     }
     return nullptr;
 }
 
+void mysql_client::set_statement_cache_size(size_t size)
+{
+    if (size == statement_cache_size)
+    {
+        return;
+    }
+    statement_cache_size = size;
+    if (statement_cache)
+    {
+        delete statement_cache;
+        statement_cache = nullptr;
+    }
+    if (size > 0)
+    {
+        statement_cache = new LRUCache(size);
+    }
+}
+
+mysql_statement* mysql_client::get_cached_statement(const char *statement, size_t statement_length)
+{
+    if (!statement_cache)
+    {
+        return nullptr;
+    }
+    std::shared_ptr<void> cached_statement = statement_cache->get(std::string(statement, statement_length));
+    return (mysql_statement *) cached_statement.get();
+}
+
 void mysql_client::close()
 {
     state = SW_MYSQL_STATE_CLOSED;
@@ -1309,6 +1540,12 @@ void mysql_client::close()
             i->second->close(false);
             statements.erase(i);
         }
+        // the statements will be prepared again after reconnecting
+        if (statement_cache)
+        {
+            statement_cache->clear();
+        }
+        closing_statements.clear();
         if (sw_likely(!socket->has_bound()))
         {
             this->socket = nullptr;
@@ -1396,13 +1633,8 @@ void mysql_statement::execute(zval *return_value, zval *params)
     }
 }
 
-void mysql_statement::send_execute_request(zval *return_value, zval *params)
+bool mysql_statement::append_execute_request(swString *buffer, zval *params)
 {
-    if (sw_unlikely(!is_available_for_new_reuqest()))
-    {
-        RETURN_FALSE;
-    }
-
     uint32_t param_count = params ? php_swoole_array_length(params) : 0;
 
     if (sw_unlikely(param_count != info.param_count))
@@ -1412,16 +1644,21 @@ void mysql_statement::send_execute_request(zval *return_value, zval *params)
             "Statement#%u expects %u parameter, %u given.",
             info.id, info.param_count, param_count
         );
-        RETURN_FALSE;
+        return false;
     }
 
-    swString *buffer = SwooleTG.buffer_stack;
-    char *p = buffer->str;
+    size_t offset = buffer->length;
+    if (sw_unlikely(swString_extend_align(buffer, offset + 5 + 9 + ((param_count + 7) / 8) + 1 + param_count * 2) != SW_OK))
+    {
+        client->non_sql_error(MYSQLND_CR_OUT_OF_MEMORY, strerror(ENOMEM));
+        return false;
+    }
+    char *p = buffer->str + offset;
 
     memset(p, 0, 5);
     // command
-    buffer->str[4] = SW_MYSQL_COM_STMT_EXECUTE;
-    buffer->length = 5;
+    p[4] = SW_MYSQL_COM_STMT_EXECUTE;
+    buffer->length += 5;
     p += 5;
 
     // stmt.id
@@ -1471,17 +1708,35 @@ void mysql_statement::send_execute_request(zval *return_value, zval *params)
                 sw_mysql_int2store((buffer->str + type_start_offset) + (index * 2), SW_MYSQL_TYPE_VAR_STRING);
                 if (swString_append_ptr(buffer, stack_buffer, lcb_size) < 0)
                 {
-                    RETURN_FALSE;
+                    client->non_sql_error(MYSQLND_CR_OUT_OF_MEMORY, strerror(ENOMEM));
+                    return false;
                 }
                 if (swString_append_ptr(buffer, str_value.val(), str_value.len()) < 0)
                 {
-                    RETURN_FALSE;
+                    client->non_sql_error(MYSQLND_CR_OUT_OF_MEMORY, strerror(ENOMEM));
+                    return false;
                 }
             }
             index++;
         }
         ZEND_HASH_FOREACH_END();
     }
+    return true;
+}
+
+void mysql_statement::send_execute_request(zval *return_value, zval *params)
+{
+    if (sw_unlikely(!is_available_for_new_reuqest()))
+    {
+        RETURN_FALSE;
+    }
+
+    swString *buffer = SwooleTG.buffer_stack;
+    swString_clear(buffer);
+    if (sw_unlikely(!append_execute_request(buffer, params)))
+    {
+        RETURN_FALSE;
+    }
     do {
         size_t length = buffer->length - SW_MYSQL_PACKET_HEADER_SIZE;
         size_t send_s =  SW_MIN(length, SW_MYSQL_MAX_PACKET_BODY_SIZE);
@@ -1845,7 +2100,7 @@ static sw_inline mysql_statement* php_swoole_get_mysql_statement(zval *zobject)
 static void php_swoole_mysql_coro_statement_free_object(zend_object *object)
 {
     mysql_coro_statement_t *zms = php_swoole_mysql_coro_statement_fetch_object(object);
-    delete zms->statement;
+    zms->statement->release();
     OBJ_RELEASE(zms->zclient);
     zend_object_std_dtor(&zms->std);
 }
@@ -1860,6 +2115,7 @@ static sw_inline zend_object* php_swoole_mysql_coro_statement_create_object(zend
     ZVAL_OBJ(&zobject, &zms->std);
     zend_update_property_long(ce, &zobject, ZEND_STRL("id"), statement->info.id);
     zms->statement = statement;
+    statement->ref_count++;
     zms->zclient = client;
     GC_ADDREF(client);
     return &zms->std;
@@ -2090,6 +2346,11 @@ static PHP_METHOD(swoole_mysql_coro, connect)
         {
             mc->strict_type = zval_is_true(ztmp);
         }
+        if (php_swoole_array_get_value(ht, "statement_cache_size", ztmp))
+        {
+            zend_long size = zval_get_long(ztmp);
+            mc->set_statement_cache_size(size > 0 ? size : 0);
+        }
         if (php_swoole_array_get_value(ht, "fetch_mode", ztmp))
         {
             if (UNEXPECTED(!mc->set_fetch_mode(zval_is_true(ztmp))))
@@ -2235,6 +2496,14 @@ static PHP_METHOD(swoole_mysql_coro, prepare)
         Z_PARAM_DOUBLE(timeout)
     ZEND_PARSE_PARAMETERS_END_EX(RETURN_FALSE);
 
+    if (!mc->get_defer())
+    {
+        mysql_statement *cached_statement = mc->get_cached_statement(statement, statement_length);
+        if (cached_statement && mc->is_available_for_new_reuqest())
+        {
+            RETURN_OBJ(php_swoole_mysql_coro_statement_create_object(cached_statement, Z_OBJ_P(ZEND_THIS)));
+        }
+    }
     mc->add_timeout_controller(timeout, SW_TIMEOUT_RDWR);
     if (UNEXPECTED(!mc->send_prepare_request(statement, statement_length)))
     {
@@ -2258,6 +2527,78 @@ static PHP_METHOD(swoole_mysql_coro, prepare)
     mc->del_timeout_controller();
 }
 
+static PHP_METHOD(swoole_mysql_coro, pipeline)
+{
+    mysql_client *mc = php_swoole_get_mysql_client(ZEND_THIS);
+    zval *zrequests;
+    double timeout = 0;
+
+    ZEND_PARSE_PARAMETERS_START(1, 2)
+        Z_PARAM_ARRAY(zrequests)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_DOUBLE(timeout)
+    ZEND_PARSE_PARAMETERS_END_EX(RETURN_FALSE);
+
+    /* sql, statement or [statement, params] */
+    std::vector<std::pair<mysql_statement*, zval*>> requests;
+    zval *zrequest;
+    ZEND_HASH_FOREACH_VAL(Z_ARRVAL_P(zrequests), zrequest)
+    {
+        ZVAL_DEREF(zrequest);
+        zval *zstatement = zrequest, *zparams = nullptr;
+        if (Z_TYPE_P(zrequest) == IS_STRING)
+        {
+            requests.emplace_back(nullptr, zrequest);
+            continue;
+        }
+        if (Z_TYPE_P(zrequest) == IS_ARRAY)
+        {
+            zstatement = zend_hash_index_find(Z_ARRVAL_P(zrequest), 0);
+            zparams = zend_hash_index_find(Z_ARRVAL_P(zrequest), 1);
+            if (zparams && Z_TYPE_P(zparams) != IS_ARRAY)
+            {
+                zparams = nullptr;
+            }
+        }
+        if (
+            !zstatement || Z_TYPE_P(zstatement) != IS_OBJECT ||
+            !instanceof_function(Z_OBJCE_P(zstatement), swoole_mysql_coro_statement_ce)
+        )
+        {
+            php_swoole_fatal_error(E_WARNING, "request#%zu must be a sql string, a statement or an array of the statement and params", requests.size());
+            RETURN_FALSE;
+        }
+        mysql_statement *statement = php_swoole_get_mysql_statement(zstatement);
+        if (UNEXPECTED(statement->get_client() != mc))
+        {
+            php_swoole_fatal_error(E_WARNING, "statement of request#%zu is closed or belongs to another client", requests.size());
+            RETURN_FALSE;
+        }
+        requests.emplace_back(statement, zparams);
+    }
+    ZEND_HASH_FOREACH_END();
+
+    mc->add_timeout_controller(timeout, SW_TIMEOUT_RDWR);
+    mc->pipeline(return_value, requests);
+    mc->del_timeout_controller();
+    if (UNEXPECTED(Z_TYPE_P(return_value) == IS_FALSE))
+    {
+        swoole_mysql_coro_sync_error_properties(ZEND_THIS, mc->get_error_code(), mc->get_error_msg(), mc->is_connect());
+        return;
+    }
+    // the error of the last failed request
+    zval *zresult;
+    ZEND_HASH_FOREACH_VAL(Z_ARRVAL_P(return_value), zresult)
+    {
+        if (Z_TYPE_P(zresult) == IS_FALSE)
+        {
+            swoole_mysql_coro_sync_error_properties(ZEND_THIS, mc->get_error_code(), mc->get_error_msg());
+            break;
+        }
+    }
+    ZEND_HASH_FOREACH_END();
+}
+
 static PHP_METHOD(swoole_mysql_coro, recv)
 {
     mysql_client *mc = php_swoole_get_mysql_client(ZEND_THIS);
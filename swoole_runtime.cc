@@ -16,6 +16,10 @@
 #include "php_swoole_cxx.h"
 
 #include "thirdparty/php/standard/proc_open.h"
+#ifdef SW_USE_CURL
+#include "coroutine_curl.h"
+#include "ext/curl/php_curl.h"
+#endif
 #include <unordered_map>
 #include <initializer_list>
 
@@ -62,6 +66,9 @@ static PHP_FUNCTION(swoole_time_sleep_until);
 static PHP_FUNCTION(swoole_stream_select);
 static PHP_FUNCTION(swoole_stream_socket_pair);
 static PHP_FUNCTION(swoole_user_func_handler);
+#ifdef SW_USE_CURL
+static PHP_FUNCTION(swoole_native_curl_exec);
+#endif
 }
 
 static int socket_set_option(php_stream *stream, int option, int value, void *ptrparam);
@@ -171,6 +178,9 @@ void php_swoole_runtime_minit(int module_number)
     SW_REGISTER_LONG_CONSTANT("SWOOLE_HOOK_SLEEP", SW_HOOK_SLEEP);
     SW_REGISTER_LONG_CONSTANT("SWOOLE_HOOK_PROC", SW_HOOK_PROC);
     SW_REGISTER_LONG_CONSTANT("SWOOLE_HOOK_CURL", SW_HOOK_CURL);
+#ifdef SW_USE_CURL
+    SW_REGISTER_LONG_CONSTANT("SWOOLE_HOOK_NATIVE_CURL", SW_HOOK_NATIVE_CURL);
+#endif
     SW_REGISTER_LONG_CONSTANT("SWOOLE_HOOK_BLOCKING_FUNCTION", SW_HOOK_BLOCKING_FUNCTION);
     SW_REGISTER_LONG_CONSTANT("SWOOLE_HOOK_ALL", SW_HOOK_ALL);
 
@@ -1268,9 +1278,20 @@ bool PHPCoroutine::enable_hook(int flags)
         }
     }
 
-    if (flags & SW_HOOK_CURL)
+    /**
+     * with the native hook the handles of ext/curl are kept, only the transfer is driven by the reactor
+     */
+#ifdef SW_USE_CURL
+    uint32_t curl_library_mask = SW_HOOK_CURL | SW_HOOK_NATIVE_CURL;
+#else
+    uint32_t curl_library_mask = SW_HOOK_CURL;
+#endif
+    bool curl_library = (flags & curl_library_mask) == SW_HOOK_CURL;
+    bool curl_library_hooked = (hook_flags & curl_library_mask) == SW_HOOK_CURL;
+
+    if (curl_library)
     {
-        if (!(hook_flags & SW_HOOK_CURL))
+        if (!curl_library_hooked)
         {
             hook_func(ZEND_STRL("curl_init"));
             hook_func(ZEND_STRL("curl_setopt"));
@@ -1286,7 +1307,7 @@ bool PHPCoroutine::enable_hook(int flags)
     }
     else
     {
-        if (hook_flags & SW_HOOK_CURL)
+        if (curl_library_hooked)
         {
             unhook_func(ZEND_STRL("curl_init"));
             unhook_func(ZEND_STRL("curl_setopt"));
@@ -1300,6 +1321,24 @@ bool PHPCoroutine::enable_hook(int flags)
         }
     }
 
+#ifdef SW_USE_CURL
+    if (flags & SW_HOOK_NATIVE_CURL)
+    {
+        if (!(hook_flags & SW_HOOK_NATIVE_CURL))
+        {
+            hook_func(ZEND_STRL("curl_exec"), PHP_FN(swoole_native_curl_exec));
+        }
+    }
+    else
+    {
+        // curl_exec may have been taken by the php library
+        if ((hook_flags & SW_HOOK_NATIVE_CURL) && !curl_library)
+        {
+            unhook_func(ZEND_STRL("curl_exec"));
+        }
+    }
+#endif
+
     hook_flags = flags;
     return true;
 }
@@ -1355,6 +1394,87 @@ static PHP_METHOD(swoole_runtime, getHookFlags)
     RETURN_LONG(hook_flags);
 }
 
+#ifdef SW_USE_CURL
+/**
+ * curl_exec() of ext/curl with the transfer run by the curl_multi of the reactor
+ */
+static PHP_FUNCTION(swoole_native_curl_exec)
+{
+    static int le_curl = 0;
+    zval *zid;
+    php_curl *ch;
+    CURLcode error;
+
+    if (!Coroutine::get_current())
+    {
+        real_func *rf = (real_func *) zend_hash_str_find_ptr(function_table, ZEND_STRL("curl_exec"));
+        rf->ori_handler(INTERNAL_FUNCTION_PARAM_PASSTHRU);
+        return;
+    }
+
+    ZEND_PARSE_PARAMETERS_START(1, 1)
+        Z_PARAM_RESOURCE(zid)
+    ZEND_PARSE_PARAMETERS_END();
+
+    if (le_curl == 0)
+    {
+        le_curl = zend_fetch_list_dtor_id(le_curl_name);
+    }
+    if ((ch = (php_curl *) zend_fetch_resource(Z_RES_P(zid), le_curl_name, le_curl)) == NULL)
+    {
+        RETURN_FALSE;
+    }
+
+    smart_str_free(&ch->handlers->write->buf);
+    if (ch->header.str)
+    {
+        zend_string_release(ch->header.str);
+        ch->header.str = NULL;
+    }
+    memset(ch->err.str, 0, CURL_ERROR_SIZE + 1);
+    ch->err.no = 0;
+
+    error = coroutine::CurlMulti::exec(ch->cp);
+    SAVE_CURL_ERROR(ch, error);
+
+    if (error != CURLE_OK)
+    {
+        smart_str_free(&ch->handlers->write->buf);
+        RETURN_FALSE;
+    }
+    if (!Z_ISUNDEF(ch->handlers->std_err))
+    {
+        php_stream *stream = (php_stream *) zend_fetch_resource2_ex(&ch->handlers->std_err, NULL, php_file_le_stream(), php_file_le_pstream());
+        if (stream)
+        {
+            php_stream_flush(stream);
+        }
+    }
+    if (ch->handlers->write->method == PHP_CURL_RETURN && ch->handlers->write->buf.s)
+    {
+        smart_str_0(&ch->handlers->write->buf);
+        RETURN_STR_COPY(ch->handlers->write->buf.s);
+    }
+    /* flush the file handle, so any remaining data is synched to disk */
+    if (ch->handlers->write->method == PHP_CURL_FILE && ch->handlers->write->fp)
+    {
+        fflush(ch->handlers->write->fp);
+    }
+    if (ch->handlers->write_header->method == PHP_CURL_FILE && ch->handlers->write_header->fp)
+    {
+        fflush(ch->handlers->write_header->fp);
+    }
+    if (ch->handlers->write->method == PHP_CURL_RETURN)
+    {
+        RETURN_EMPTY_STRING();
+    }
+    else
+    {
+        RETURN_TRUE;
+    }
+}
+#endif
+
 static PHP_FUNCTION(swoole_sleep)
 {
     zend_long num;
@@ -1724,23 +1844,32 @@ static void hook_func(const char *name, size_t l_name, zif_handler handler)
         handler = PHP_FN(swoole_user_func_handler);
         use_php_func = true;
     }
+    zend_function *zf;
     if (rf)
     {
         rf->function->internal_function.handler = handler;
-        return;
+        // the php library function is resolved once, a native handler has none
+        if (!use_php_func || rf->fci_cache)
+        {
+            return;
+        }
+        zf = rf->function;
     }
-
-    zend_function *zf = (zend_function *) zend_hash_str_find_ptr(EG(function_table), name, l_name);
-    if (zf == nullptr)
+    else
     {
-        return;
-    }
+        zf = (zend_function *) zend_hash_str_find_ptr(EG(function_table), name, l_name);
+        if (zf == nullptr)
+        {
+            return;
+        }
 
-    rf = (real_func *) emalloc(sizeof(real_func));
-    bzero(rf, sizeof(real_func));
-    rf->function = zf;
-    rf->ori_handler = zf->internal_function.handler;
-    zf->internal_function.handler = handler;
+        rf = (real_func *) emalloc(sizeof(real_func));
+        bzero(rf, sizeof(real_func));
+        rf->function = zf;
+        rf->ori_handler = zf->internal_function.handler;
+        zf->internal_function.handler = handler;
+        zend_hash_add_ptr(function_table, zf->common.function_name, rf);
+    }
 
     if (use_php_func)
     {
@@ -1760,8 +1889,6 @@ static void hook_func(const char *name, size_t l_name, zif_handler handler)
         efree(func_name);
         rf->fci_cache = func_cache;
     }
-
-    zend_hash_add_ptr(function_table, zf->common.function_name, rf);
 }
 
 static void unhook_func(const char *name, size_t l_name)
@@ -870,6 +870,43 @@ int php_swoole_task_pack(swEventData *task, zval *zdata)
     return task->info.fd;
 }
 
+/**
+ * BASE mode: a large package is received into the body of a zend_string,
+ * so that the callback gets the package as a string without copying it.
+ * The string is charged to memory_limit and emalloc() can not fail gracefully, so a package which does not fit
+ * is refused here and the connection is closed, instead of the worker dying on "Allowed memory size exhausted".
+ * The string can not be allocated persistently, the engine frees the strings of the zvals with efree().
+ */
+static swString* php_swoole_server_package_buffer_new(swProtocol *protocol, size_t size)
+{
+    if (PG(memory_limit) > 0 && zend_memory_usage(1) + _ZSTR_STRUCT_SIZE(size) > (size_t) PG(memory_limit))
+    {
+        swoole_error_log(
+            SW_LOG_WARNING, SW_ERROR_MALLOC_FAIL, "unable to receive the package of %zu bytes, memory_limit is exceeded", size
+        );
+        return NULL;
+    }
+    swString *buffer = (swString *) sw_malloc(sizeof(swString));
+    if (!buffer)
+    {
+        swWarn("malloc(%zu) failed", sizeof(swString));
+        return NULL;
+    }
+    zend_string *object = zend_string_alloc(size, 0);
+    ZSTR_VAL(object)[size] = '\0';
+    buffer->length = 0;
+    buffer->size = size;
+    buffer->offset = 0;
+    buffer->str = ZSTR_VAL(object);
+    return buffer;
+}
+
+static void php_swoole_server_package_buffer_free(swProtocol *protocol, swString *buffer)
+{
+    zend_string_release((zend_string *) (buffer->str - XtOffsetOf(zend_string, val)));
+    sw_free(buffer);
+}
+
 void php_swoole_get_recv_data(swServer *serv, zval *zdata, swEventData *req, char *header, uint32_t header_length)
 {
     char *data = NULL;
@@ -879,6 +916,10 @@ void php_swoole_get_recv_data(swServer *serv, zval *zdata, swEventData *req, cha
     {
         ZVAL_EMPTY_STRING(zdata);
     }
+    else if ((req->info.flags & SW_EVENT_DATA_OBJ_PTR) && header_length == 0)
+    {
+        ZVAL_STR_COPY(zdata, (zend_string *) (data - XtOffsetOf(zend_string, val)));
+    }
     else
     {
         ZVAL_STRINGL(zdata, data + header_length, length - header_length);
@@ -1122,6 +1163,11 @@ void php_swoole_server_before_start(swServer *serv, zval *zobject)
         }
     }
 
+    /**
+     * the manager removes the expired rows of the tables in the background
+     */
+    php_swoole_table_add_sweep_hook(serv);
+
     /**
      * Master Process ID
      */
@@ -1181,6 +1227,14 @@ void php_swoole_server_before_start(swServer *serv, zval *zobject)
             return;
         }
 #endif
+        /**
+         * the reactor runs in the worker process, receive large packages into zend_strings directly
+         */
+        if (serv->factory_mode == SW_MODE_BASE)
+        {
+            port->protocol.package_buffer_new = php_swoole_server_package_buffer_new;
+            port->protocol.package_buffer_free = php_swoole_server_package_buffer_free;
+        }
         if (port->open_http2_protocol && !swServer_dispatch_mode_is_mod(serv))
         {
             php_swoole_fatal_error(E_ERROR, "server dispatch mode should be FDMOD(%d) or IPMOD(%d) if open_http2_protocol is true", SW_DISPATCH_FDMOD, SW_DISPATCH_IPMOD);
@@ -1385,7 +1439,7 @@ int php_swoole_onPacket(swServer *serv, swEventData *req)
     swConnection *from_sock = swServer_connection_get(serv, req->info.server_fd);
     if (from_sock)
     {
-        add_assoc_long(&zaddr, "server_port", swConnection_get_port(from_sock->socket_type, &from_sock->info));
+        add_assoc_long(&zaddr, "server_port", swConnection_get_port(from_sock->socket_type, &from_sock->cold->info));
     }
 
     char address[INET6_ADDRSTRLEN];
@@ -2263,6 +2317,21 @@ static PHP_METHOD(swoole_server, set)
     {
         serv->single_thread = zval_is_true(ztmp);
     }
+#ifdef HAVE_REUSEPORT
+    //accept in the reactor threads
+    if (php_swoole_array_get_value(vht, "reactor_accept", ztmp))
+    {
+        serv->reactor_accept = zval_is_true(ztmp);
+    }
+    if (php_swoole_array_get_value(vht, "reactor_accept_cbpf", ztmp))
+    {
+#ifdef SO_ATTACH_REUSEPORT_CBPF
+        serv->reactor_accept_cbpf = zval_is_true(ztmp);
+#else
+        php_swoole_fatal_error(E_WARNING, "reactor_accept_cbpf is not supported");
+#endif
+    }
+#endif
     //worker_num
     if (php_swoole_array_get_value(vht, "worker_num", ztmp))
     {
@@ -2368,6 +2437,11 @@ static PHP_METHOD(swoole_server, set)
         level = zval_get_long(ztmp);
         SwooleG.log_level = (uint32_t) (level < 0 ? UINT32_MAX : level);
     }
+    //log_async
+    if (php_swoole_array_get_value(vht, "log_async", ztmp))
+    {
+        SwooleG.log_async = zval_is_true(ztmp);
+    }
     /**
      * for dispatch_mode = 1/3
      */
@@ -2557,6 +2631,16 @@ static PHP_METHOD(swoole_server, set)
     {
         serv->http_parse_files = zval_is_true(ztmp);
     }
+    //dispatch the pipelined requests together
+    if (php_swoole_array_get_value(vht, "http_pipeline_batch", ztmp))
+    {
+        serv->http_pipeline_batch = zval_is_true(ztmp);
+    }
+    //dispatch the large request body in chunks
+    if (php_swoole_array_get_value(vht, "http_body_stream", ztmp))
+    {
+        serv->http_body_stream = zval_is_true(ztmp);
+    }
 #ifdef SW_HAVE_COMPRESSION
     //http content compression
     if (php_swoole_array_get_value(vht, "http_compression", ztmp))
@@ -2635,6 +2719,20 @@ static PHP_METHOD(swoole_server, set)
         }
         serv->document_root_len = strlen(serv->document_root);
     }
+    if (php_swoole_array_get_value(vht, "static_handler_cache_ttl", ztmp))
+    {
+        zend_long v = zval_get_long(ztmp);
+        serv->static_handler_cache_ttl = SW_MAX(0, SW_MIN(v, UINT32_MAX));
+    }
+    if (php_swoole_array_get_value(vht, "static_handler_cache_max_file_size", ztmp))
+    {
+        zend_long v = zval_get_long(ztmp);
+        serv->static_handler_cache_max_file_size = SW_MAX(0, SW_MIN(v, UINT32_MAX));
+    }
+    if (php_swoole_array_get_value(vht, "static_handler_precompressed", ztmp))
+    {
+        serv->static_handler_precompressed = zval_is_true(ztmp);
+    }
     /**
      * [static_handler] locations
      */
@@ -3052,16 +3150,7 @@ static PHP_METHOD(swoole_server, sendto)
         server_socket = ipv6 ?  serv->udp_socket_ipv6 : serv->udp_socket_ipv4;
     }
 
-    int ret;
-    if (ipv6)
-    {
-        ret = swSocket_udp_sendto6(server_socket, ip, port, data, len);
-    }
-    else
-    {
-        ret = swSocket_udp_sendto(server_socket, ip, port, data, len);
-    }
-    SW_CHECK_RETURN(ret);
+    SW_CHECK_RETURN(swWorker_udp_sendto(serv, server_socket, ip, port, data, len, ipv6));
 }
 
 static PHP_METHOD(swoole_server, sendfile)
@@ -3183,6 +3272,26 @@ static PHP_METHOD(swoole_server, resume)
     SW_CHECK_RETURN(serv->feedback(serv, fd, SW_SERVER_EVENT_RESUME_RECV));
 }
 
+/**
+ * count, avg, max and the percentiles of a histogram, in the unit of the recorded values
+ */
+static void php_swoole_server_add_histogram(zval *zstats, const char *name, size_t name_len, swShardedHistogram *sharded)
+{
+    swHistogram _histogram, *histogram = &_histogram;
+    swShardedHistogram_get(sharded, histogram);
+
+    zval zhistogram;
+    array_init(&zhistogram);
+    add_assoc_long_ex(&zhistogram, ZEND_STRL("count"), histogram->count);
+    add_assoc_long_ex(&zhistogram, ZEND_STRL("avg"), histogram->count > 0 ? histogram->sum / histogram->count : 0);
+    add_assoc_long_ex(&zhistogram, ZEND_STRL("p50"), swHistogram_percentile(histogram, 50));
+    add_assoc_long_ex(&zhistogram, ZEND_STRL("p90"), swHistogram_percentile(histogram, 90));
+    add_assoc_long_ex(&zhistogram, ZEND_STRL("p99"), swHistogram_percentile(histogram, 99));
+    add_assoc_long_ex(&zhistogram, ZEND_STRL("p999"), swHistogram_percentile(histogram, 99.9));
+    add_assoc_long_ex(&zhistogram, ZEND_STRL("max"), histogram->max);
+    add_assoc_zval_ex(zstats, name, name_len, &zhistogram);
+}
+
 static PHP_METHOD(swoole_server, stats)
 {
     swServer *serv = php_swoole_server_get_and_check_server(ZEND_THIS);
@@ -3198,7 +3307,8 @@ static PHP_METHOD(swoole_server, stats)
     add_assoc_long_ex(return_value, ZEND_STRL("start_time"), serv->stats->start_time);
     add_assoc_long_ex(return_value, ZEND_STRL("connection_num"), serv->stats->connection_num);
     add_assoc_long_ex(return_value, ZEND_STRL("accept_count"), serv->stats->accept_count);
-    add_assoc_long_ex(return_value, ZEND_STRL("close_count"), serv->stats->close_count);
+    add_assoc_long_ex(return_value, ZEND_STRL("close_count"), swCounter_get(serv->stats->close_count));
+    add_assoc_long_ex(return_value, ZEND_STRL("dgram_send_fail_count"), serv->stats->dgram_send_fail_count);
     /**
      * reset
      */
@@ -3221,7 +3331,7 @@ static PHP_METHOD(swoole_server, stats)
     }
     add_assoc_long_ex(return_value, ZEND_STRL("idle_worker_num"), idle_worker_num);
     add_assoc_long_ex(return_value, ZEND_STRL("tasking_num"), tasking_num);
-    add_assoc_long_ex(return_value, ZEND_STRL("request_count"), serv->stats->request_count);
+    add_assoc_long_ex(return_value, ZEND_STRL("request_count"), swCounter_get(serv->stats->request_count));
     if (SwooleWG.worker)
     {
         add_assoc_long_ex(return_value, ZEND_STRL("worker_request_count"), SwooleWG.worker->request_count);
@@ -3254,6 +3364,30 @@ static PHP_METHOD(swoole_server, stats)
     }
 
     add_assoc_long_ex(return_value, ZEND_STRL("coroutine_num"), Coroutine::count());
+
+#ifdef SW_BUFFER_RECV_TIME
+    php_swoole_server_add_histogram(return_value, ZEND_STRL("queue_time"), serv->stats->queue_time);
+    php_swoole_server_add_histogram(return_value, ZEND_STRL("send_time"), serv->stats->send_time);
+#endif
+    php_swoole_server_add_histogram(return_value, ZEND_STRL("handler_time"), serv->stats->handler_time);
+    php_swoole_server_add_histogram(return_value, ZEND_STRL("reactor_loop_time"), serv->stats->reactor_loop_time);
+    php_swoole_server_add_histogram(return_value, ZEND_STRL("reactor_event_num"), serv->stats->reactor_event_num);
+
+    zval zworkers;
+    array_init(&zworkers);
+    for (i = 0; i < worker_num; i++)
+    {
+        swWorker *worker = swServer_get_worker(serv, i);
+        zval zworker;
+        array_init(&zworker);
+        add_assoc_long_ex(&zworker, ZEND_STRL("pid"), worker->pid);
+        add_assoc_long_ex(&zworker, ZEND_STRL("status"), worker->status);
+        add_assoc_long_ex(&zworker, ZEND_STRL("request_count"), worker->request_count);
+        add_assoc_long_ex(&zworker, ZEND_STRL("handler_time"), worker->handler_time);
+        add_assoc_long_ex(&zworker, ZEND_STRL("coroutine_num"), worker->coroutine_num);
+        add_index_zval(&zworkers, i, &zworker);
+    }
+    add_assoc_zval_ex(return_value, ZEND_STRL("workers"), &zworkers);
 }
 
 static PHP_METHOD(swoole_server, reload)
@@ -3302,8 +3436,7 @@ static PHP_METHOD(swoole_server, heartbeat)
         RETURN_FALSE;
     }
 
-    int serv_max_fd = swServer_get_maxfd(serv);
-    int serv_min_fd = swServer_get_minfd(serv);
+    swConnectionIndex *index = serv->connection_index;
 
     array_init(return_value);
 
@@ -3311,8 +3444,9 @@ static PHP_METHOD(swoole_server, heartbeat)
     int checktime = (int) serv->gs->now - serv->heartbeat_idle_time;
     swConnection *conn;
 
-    for (fd = serv_min_fd; fd <= serv_max_fd; fd++)
+    for (uint32_t i = index->count; i > 0; i--)
     {
+        fd = index->fds[i - 1];
         swTrace("heartbeat check fd=%d", fd);
         conn = &serv->connection_list[fd];
 
@@ -3966,22 +4100,22 @@ static PHP_METHOD(swoole_server, getClientInfo)
         }
 
 #ifdef SW_USE_OPENSSL
-        if (conn->ssl_client_cert && conn->ssl_client_cert_pid == SwooleG.pid)
+        if (conn->cold->ssl_client_cert && conn->cold->ssl_client_cert_pid == SwooleG.pid)
         {
-            add_assoc_stringl(return_value, "ssl_client_cert", conn->ssl_client_cert->str, conn->ssl_client_cert->length);
+            add_assoc_stringl(return_value, "ssl_client_cert", conn->cold->ssl_client_cert->str, conn->cold->ssl_client_cert->length);
         }
 #endif
         //server socket
         swConnection *from_sock = swServer_connection_get(serv, conn->server_fd);
         if (from_sock)
         {
-            add_assoc_long(return_value, "server_port", swConnection_get_port(from_sock->socket_type, &from_sock->info));
+            add_assoc_long(return_value, "server_port", swConnection_get_port(from_sock->socket_type, &from_sock->cold->info));
         }
         add_assoc_long(return_value, "server_fd", conn->server_fd);
         add_assoc_long(return_value, "socket_fd", conn->fd);
         add_assoc_long(return_value, "socket_type", conn->socket_type);
-        add_assoc_long(return_value, "remote_port", swConnection_get_port(conn->socket_type, &conn->info));
-        add_assoc_string(return_value, "remote_ip", (char *) swConnection_get_ip(conn->socket_type, &conn->info));
+        add_assoc_long(return_value, "remote_port", swConnection_get_port(conn->socket_type, &conn->cold->info));
+        add_assoc_string(return_value, "remote_ip", (char *) swConnection_get_ip(conn->socket_type, &conn->cold->info));
         add_assoc_long(return_value, "reactor_id", conn->reactor_id);
         add_assoc_long(return_value, "connect_time", conn->connect_time);
         add_assoc_long(return_value, "last_time", conn->last_time);
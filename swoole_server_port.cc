@@ -16,6 +16,10 @@
 
 #include "php_swoole_cxx.h"
 
+#ifdef __linux__
+#include <netinet/udp.h>
+#endif
+
 using namespace std;
 using namespace swoole;
 
@@ -309,6 +313,35 @@ static PHP_METHOD(swoole_server_port, set)
         zend_long v = zval_get_long(ztmp);
         port->buffer_low_watermark = SW_MAX(0, SW_MIN(v, UINT32_MAX));
     }
+    //udp: receive datagrams in batches with recvmmsg
+    if (php_swoole_array_get_value(vht, "dgram_recv_batch", ztmp))
+    {
+        zend_long v = zval_get_long(ztmp);
+        port->dgram_recv_batch = SW_MAX(0, SW_MIN(v, SW_DGRAM_BATCH_MAX));
+    }
+    //udp: bytes reserved for every datagram of a batch
+    if (php_swoole_array_get_value(vht, "dgram_max_size", ztmp))
+    {
+        zend_long v = zval_get_long(ztmp);
+        port->dgram_max_size = SW_MAX(1, SW_MIN(v, SW_BUFFER_SIZE_UDP));
+    }
+    //udp: generic receive offload
+    if (php_swoole_array_get_value(vht, "dgram_gro", ztmp) && zval_is_true(ztmp) && swSocket_is_dgram(port->type))
+    {
+#ifdef UDP_GRO
+        int sockopt = 1;
+        if (setsockopt(port->sock, SOL_UDP, UDP_GRO, &sockopt, sizeof(sockopt)) != 0)
+        {
+            swSysWarn("setsockopt(UDP_GRO) failed");
+        }
+        else
+        {
+            port->dgram_gro = 1;
+        }
+#else
+        php_swoole_error(E_WARNING, "UDP_GRO is not supported");
+#endif
+    }
     //server: tcp_nodelay
     if (php_swoole_array_get_value(vht, "open_tcp_nodelay", ztmp))
     {
@@ -578,6 +611,10 @@ static PHP_METHOD(swoole_server_port, set)
         {
             port->ssl_option.allow_self_signed = zval_is_true(ztmp);
         }
+        if (php_swoole_array_get_value(vht, "ssl_ktls", ztmp))
+        {
+            port->ssl_option.ktls = zval_is_true(ztmp);
+        }
         //verify client cert
         if (php_swoole_array_get_value(vht, "ssl_client_cert_file", ztmp))
         {
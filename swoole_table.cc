@@ -18,6 +18,13 @@
 
 #include "table.h"
 
+#include <unordered_set>
+
+/**
+ * the created tables, inherited by the manager process which sweeps them
+ */
+static std::unordered_set<swTable *> swoole_tables;
+
 static inline void php_swoole_table_row2array(swTable *table, swTableRow *row, zval *return_value)
 {
     array_init(return_value);
@@ -231,6 +238,10 @@ ZEND_BEGIN_ARG_INFO_EX(arginfo_swoole_table_construct, 0, 0, 1)
     ZEND_ARG_INFO(0, conflict_proportion)
 ZEND_END_ARG_INFO()
 
+ZEND_BEGIN_ARG_INFO_EX(arginfo_swoole_table_create, 0, 0, 0)
+    ZEND_ARG_INFO(0, file)
+ZEND_END_ARG_INFO()
+
 ZEND_BEGIN_ARG_INFO_EX(arginfo_swoole_table_column, 0, 0, 2)
     ZEND_ARG_INFO(0, name)
     ZEND_ARG_INFO(0, type)
@@ -240,6 +251,15 @@ ZEND_END_ARG_INFO()
 ZEND_BEGIN_ARG_INFO_EX(arginfo_swoole_table_set, 0, 0, 2)
     ZEND_ARG_INFO(0, key)
     ZEND_ARG_ARRAY_INFO(0, value, 0)
+    ZEND_ARG_INFO(0, ttl)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_swoole_table_setEvictPolicy, 0, 0, 1)
+    ZEND_ARG_INFO(0, policy)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_swoole_table_sweep, 0, 0, 0)
+    ZEND_ARG_INFO(0, bucket_num)
 ZEND_END_ARG_INFO()
 
 ZEND_BEGIN_ARG_INFO_EX(arginfo_swoole_table_get, 0, 0, 1)
@@ -296,6 +316,8 @@ static PHP_METHOD(swoole_table, decr);
 static PHP_METHOD(swoole_table, count);
 static PHP_METHOD(swoole_table, destroy);
 static PHP_METHOD(swoole_table, getMemorySize);
+static PHP_METHOD(swoole_table, setEvictPolicy);
+static PHP_METHOD(swoole_table, sweep);
 static PHP_METHOD(swoole_table, offsetExists);
 static PHP_METHOD(swoole_table, offsetGet);
 static PHP_METHOD(swoole_table, offsetSet);
@@ -317,7 +339,7 @@ static const zend_function_entry swoole_table_methods[] =
 {
     PHP_ME(swoole_table, __construct, arginfo_swoole_table_construct, ZEND_ACC_PUBLIC)
     PHP_ME(swoole_table, column,      arginfo_swoole_table_column, ZEND_ACC_PUBLIC)
-    PHP_ME(swoole_table, create,      arginfo_swoole_table_void, ZEND_ACC_PUBLIC)
+    PHP_ME(swoole_table, create,      arginfo_swoole_table_create, ZEND_ACC_PUBLIC)
     PHP_ME(swoole_table, destroy,     arginfo_swoole_table_void, ZEND_ACC_PUBLIC)
     PHP_ME(swoole_table, set,         arginfo_swoole_table_set, ZEND_ACC_PUBLIC)
     PHP_ME(swoole_table, get,         arginfo_swoole_table_get, ZEND_ACC_PUBLIC)
@@ -328,6 +350,8 @@ static const zend_function_entry swoole_table_methods[] =
     PHP_ME(swoole_table, incr,        arginfo_swoole_table_incr, ZEND_ACC_PUBLIC)
     PHP_ME(swoole_table, decr,        arginfo_swoole_table_decr, ZEND_ACC_PUBLIC)
     PHP_ME(swoole_table, getMemorySize,    arginfo_swoole_table_void, ZEND_ACC_PUBLIC)
+    PHP_ME(swoole_table, setEvictPolicy,   arginfo_swoole_table_setEvictPolicy, ZEND_ACC_PUBLIC)
+    PHP_ME(swoole_table, sweep,            arginfo_swoole_table_sweep, ZEND_ACC_PUBLIC)
     PHP_ME(swoole_table, offsetExists,     arginfo_swoole_table_offsetExists, ZEND_ACC_PUBLIC)
     PHP_ME(swoole_table, offsetGet,        arginfo_swoole_table_offsetGet, ZEND_ACC_PUBLIC)
     PHP_ME(swoole_table, offsetSet,        arginfo_swoole_table_offsetSet, ZEND_ACC_PUBLIC)
@@ -366,6 +390,8 @@ void php_swoole_table_minit(int module_number)
     zend_declare_class_constant_long(swoole_table_ce, ZEND_STRL("TYPE_INT"), SW_TABLE_INT);
     zend_declare_class_constant_long(swoole_table_ce, ZEND_STRL("TYPE_STRING"), SW_TABLE_STRING);
     zend_declare_class_constant_long(swoole_table_ce, ZEND_STRL("TYPE_FLOAT"), SW_TABLE_FLOAT);
+    zend_declare_class_constant_long(swoole_table_ce, ZEND_STRL("EVICT_NONE"), SW_TABLE_EVICT_NONE);
+    zend_declare_class_constant_long(swoole_table_ce, ZEND_STRL("EVICT_LRU"), SW_TABLE_EVICT_LRU);
 
     SW_INIT_CLASS_ENTRY(swoole_table_row, "Swoole\\Table\\Row", "swoole_table_row", NULL, swoole_table_row_methods);
     SW_SET_CLASS_SERIALIZABLE(swoole_table_row, zend_class_serialize_deny, zend_class_unserialize_deny);
@@ -378,6 +404,27 @@ void php_swoole_table_minit(int module_number)
     zend_declare_property_null(swoole_table_row_ce, ZEND_STRL("value"), ZEND_ACC_PUBLIC);
 }
 
+static void php_swoole_table_sweep(void *data)
+{
+    for (auto table : swoole_tables)
+    {
+        swTable_sweep(table, SW_TABLE_SWEEP_BUCKETS);
+    }
+}
+
+void php_swoole_table_add_sweep_hook(swServer *serv)
+{
+    if (swoole_tables.empty())
+    {
+        return;
+    }
+    swServer_add_hook(serv, SW_SERVER_HOOK_MANAGER_TIMER, php_swoole_table_sweep, 1);
+    if (serv->manager_alarm == 0)
+    {
+        serv->manager_alarm = 1;
+    }
+}
+
 void swoole_table_column_free(swTableColumn *col)
 {
     swString_free(col->name);
@@ -447,12 +494,29 @@ PHP_METHOD(swoole_table, column)
 static PHP_METHOD(swoole_table, create)
 {
     swTable *table = php_swoole_table_get_and_check_ptr(ZEND_THIS);
+    zend_string *file = nullptr;
 
+    ZEND_PARSE_PARAMETERS_START(0, 1)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_STR_EX(file, 1, 0)
+    ZEND_PARSE_PARAMETERS_END_EX(RETURN_FALSE);
+
+    // the rows are kept in the file and restored by the next table with the same columns
+    if (file && ZSTR_LEN(file) > 0 && swTable_set_file(table, ZSTR_VAL(file)) < 0)
+    {
+        RETURN_FALSE;
+    }
     if (swTable_create(table) < 0)
     {
+        if (table->file)
+        {
+            php_swoole_fatal_error(E_WARNING, "unable to map the table file %s", table->file);
+            RETURN_FALSE;
+        }
         php_swoole_fatal_error(E_ERROR, "unable to allocate memory");
         RETURN_FALSE;
     }
+    swoole_tables.insert(table);
     zend_update_property_long(swoole_buffer_ce, ZEND_THIS, ZEND_STRL("size"), table->size);
     zend_update_property_long(swoole_buffer_ce, ZEND_THIS, ZEND_STRL("memorySize"), table->memory_size);
     RETURN_TRUE;
@@ -462,6 +526,7 @@ static PHP_METHOD(swoole_table, destroy)
 {
     swTable *table = php_swoole_table_get_and_check_ptr2(ZEND_THIS);
 
+    swoole_tables.erase(table);
     swTable_free(table);
     php_swoole_table_set_ptr(ZEND_THIS, nullptr);
     RETURN_TRUE;
@@ -473,8 +538,9 @@ static PHP_METHOD(swoole_table, set)
     zval *array;
     char *key;
     size_t keylen;
+    zend_long ttl = 0;
 
-    if (zend_parse_parameters(ZEND_NUM_ARGS(), "sa", &key, &keylen, &array) == FAILURE)
+    if (zend_parse_parameters(ZEND_NUM_ARGS(), "sa|l", &key, &keylen, &array, &ttl) == FAILURE)
     {
         RETURN_FALSE;
     }
@@ -490,6 +556,12 @@ static PHP_METHOD(swoole_table, set)
         php_swoole_fatal_error(E_WARNING, "key[%s] is too long", key);
     }
 
+    if (ttl < 0 || (zend_ulong) ttl > UINT32_MAX)
+    {
+        php_swoole_fatal_error(E_WARNING, "ttl " ZEND_LONG_FMT " is out of range [0, %u]", ttl, UINT32_MAX);
+        RETURN_FALSE;
+    }
+
     swTableRow *_rowlock = NULL;
     swTableRow *row = swTableRow_set(table, key, keylen, &_rowlock);
     if (!row)
@@ -498,6 +570,8 @@ static PHP_METHOD(swoole_table, set)
         php_swoole_error(E_WARNING, "failed to set('%*s'), unable to allocate memory", (int )keylen, key);
         RETURN_FALSE;
     }
+    // a row set without ttl never expires
+    swTableRow_set_expire(table, row, ttl);
 
     HashTable *ht = Z_ARRVAL_P(array);
     char *k;
@@ -839,6 +913,41 @@ static PHP_METHOD(swoole_table, getMemorySize)
     }
 }
 
+static PHP_METHOD(swoole_table, setEvictPolicy)
+{
+    swTable *table = php_swoole_table_get_and_check_ptr(ZEND_THIS);
+    zend_long policy;
+
+    ZEND_PARSE_PARAMETERS_START(1, 1)
+        Z_PARAM_LONG(policy)
+    ZEND_PARSE_PARAMETERS_END_EX(RETURN_FALSE);
+
+    if (policy != SW_TABLE_EVICT_NONE && policy != SW_TABLE_EVICT_LRU)
+    {
+        php_swoole_fatal_error(E_WARNING, "unknown evict policy " ZEND_LONG_FMT, policy);
+        RETURN_FALSE;
+    }
+    table->evict_policy = policy;
+    RETURN_TRUE;
+}
+
+static PHP_METHOD(swoole_table, sweep)
+{
+    swTable *table = php_swoole_table_get_and_check_ptr2(ZEND_THIS);
+    zend_long bucket_num = 0;
+
+    ZEND_PARSE_PARAMETERS_START(0, 1)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_LONG(bucket_num)
+    ZEND_PARSE_PARAMETERS_END_EX(RETURN_FALSE);
+
+    if (bucket_num <= 0 || (size_t) bucket_num > table->size)
+    {
+        bucket_num = table->size;
+    }
+    RETURN_LONG(swTable_sweep(table, bucket_num));
+}
+
 static PHP_METHOD(swoole_table, rewind)
 {
     swTable *table = php_swoole_table_get_and_check_ptr2(ZEND_THIS);
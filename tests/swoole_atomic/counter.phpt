@@ -0,0 +1,49 @@
+--TEST--
+swoole_atomic: sharded counter with the batches
+--SKIPIF--
+<?php require __DIR__ . '/../include/skipif.inc'; ?>
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+
+const N = 10000;
+const WORKER_NUM = 4;
+
+$counter = new Swoole\Atomic\Counter(WORKER_NUM);
+$counter->add(10);
+$counter->sub(3);
+Assert::same($counter->get(), 7);
+$counter->set(0);
+
+// the pending increments of a process are flushed every 100 times
+$batched = new Swoole\Atomic\Counter(WORKER_NUM, 100);
+$batched->add(1);
+$batched->set(0);
+
+// the children are forked while the parent has a pending batch, they start their own ones
+$pending = new Swoole\Atomic\Counter(WORKER_NUM, 100);
+$pending->add(7);
+
+for ($n = WORKER_NUM; $n--;) {
+    (new Swoole\Process(function () use ($counter, $batched, $pending) {
+        for ($i = 0; $i < N; $i++) {
+            $counter->add();
+            $batched->add();
+            $pending->add();
+        }
+        $batched->add(5);
+        $batched->flush();
+        $pending->flush();
+    }))->start();
+}
+for ($n = WORKER_NUM; $n--;) {
+    Assert::assert(Swoole\Process::wait());
+}
+
+Assert::same($counter->get(), N * WORKER_NUM);
+Assert::same($batched->get(), (N + 5) * WORKER_NUM);
+Assert::same($pending->get(), N * WORKER_NUM + 7);
+echo "DONE\n";
+?>
+--EXPECT--
+DONE
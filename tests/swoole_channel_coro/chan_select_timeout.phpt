@@ -1,9 +1,7 @@
 --TEST--
 swoole_channel_coro: coro channel select timeout
 --SKIPIF--
-<?php require __DIR__ . '/../include/skipif.inc';
-exit("skip for select");
-?>
+<?php require __DIR__ . '/../include/skipif.inc'; ?>
 --FILE--
 <?php
 require __DIR__ . '/../include/bootstrap.php';
@@ -17,6 +15,7 @@ go(function () use ($chan) {
     $write_list = null;
     $result = chan::select($read_list, $write_list, 0.1);
     Assert::false($result);
+    Assert::same($chan->stats()['consumer_num'], 0);
 });
 
 swoole_event::wait();
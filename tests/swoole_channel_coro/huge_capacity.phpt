@@ -0,0 +1,24 @@
+--TEST--
+swoole_channel_coro: the ring grows with the elements instead of the capacity
+--SKIPIF--
+<?php require __DIR__ . '/../include/skipif.inc'; ?>
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+
+Co\run(function () {
+    $chan = new Chan(PHP_INT_MAX);
+    Assert::same($chan->capacity, PHP_INT_MAX);
+    for ($i = 0; $i < 1000; $i++) {
+        Assert::true($chan->push($i));
+    }
+    Assert::same($chan->length(), 1000);
+    for ($i = 0; $i < 1000; $i++) {
+        Assert::same($chan->pop(), $i);
+    }
+    Assert::true($chan->isEmpty());
+});
+echo "DONE\n";
+?>
+--EXPECT--
+DONE
@@ -0,0 +1,39 @@
+--TEST--
+swoole_channel_coro: pushMany and popMany
+--SKIPIF--
+<?php require __DIR__ . '/../include/skipif.inc'; ?>
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+
+use Swoole\Coroutine\Channel;
+
+$chan = new Channel(4);
+
+go(function () use ($chan) {
+    $items = range(1, 10);
+    while ($items) {
+        $n = $chan->pushMany($items);
+        Assert::assert($n > 0 && $n <= 4);
+        $items = array_slice($items, $n);
+    }
+});
+
+go(function () use ($chan) {
+    $all = [];
+    while (count($all) < 10) {
+        $items = $chan->popMany(16);
+        Assert::assert(count($items) > 0 && count($items) <= 4);
+        $all = array_merge($all, $items);
+    }
+    Assert::same($all, range(1, 10));
+    $chan->close();
+    Assert::same($chan->errCode, SWOOLE_CHANNEL_CLOSED);
+    Assert::false($chan->popMany(1, 0.001));
+    echo "DONE\n";
+});
+
+swoole_event_wait();
+?>
+--EXPECT--
+DONE
@@ -0,0 +1,59 @@
+--TEST--
+swoole_channel_coro: select
+--SKIPIF--
+<?php require __DIR__ . '/../include/skipif.inc'; ?>
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+
+use Swoole\Coroutine\Channel;
+
+$chan1 = new Channel(1);
+$chan2 = new Channel(1);
+$chan3 = new Channel(1);
+$chan3->push('full');
+
+go(function () use ($chan1, $chan2, $chan3) {
+    [$chan, $opcode, $data] = Channel::select([$chan1, $chan2], [[$chan3, 'data']]);
+    Assert::same($chan, $chan2);
+    Assert::same($opcode, Channel::POP);
+    Assert::same($data, 'hello');
+    Assert::same($chan1->stats()['consumer_num'], 0);
+    Assert::same($chan3->stats()['producer_num'], 0);
+    Assert::same($chan3->pop(), 'full');
+
+    [$chan, $opcode, $data] = Channel::select([$chan1], [[$chan3, 'world']]);
+    Assert::same($chan, $chan3);
+    Assert::same($opcode, Channel::PUSH);
+    Assert::true($data);
+    Assert::same($chan3->pop(), 'world');
+
+    [$chan, $opcode, $data] = Channel::select([$chan1, $chan2], null, 1);
+    Assert::same($chan, $chan1);
+    Assert::false($data);
+    Assert::same($chan1->errCode, SWOOLE_CHANNEL_CLOSED);
+
+    // the consumer owns the pushed data, even when it closes the channel before the select returns
+    $chan4 = new Channel(1);
+    go(function () use ($chan4) {
+        Assert::same($chan4->pop(), ['pushed']);
+        $chan4->close();
+    });
+    [$chan, $opcode, $data] = Channel::select([], [[$chan4, ['pushed']]]);
+    Assert::same($chan, $chan4);
+    Assert::true($data);
+    Assert::same($chan4->errCode, SWOOLE_CHANNEL_OK);
+    echo "DONE\n";
+});
+
+go(function () use ($chan1, $chan2) {
+    co::sleep(0.01);
+    $chan2->push('hello');
+    co::sleep(0.01);
+    $chan1->close();
+});
+
+swoole_event_wait();
+?>
+--EXPECT--
+DONE
@@ -0,0 +1,96 @@
+--TEST--
+swoole_http2_client_coro: multiplex the requests of the concurrent coroutines
+--SKIPIF--
+<?php require __DIR__ . '/../include/skipif.inc'; ?>
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+
+use Swoole\Coroutine;
+use Swoole\Coroutine\Http2\Client;
+use Swoole\Http\Server;
+use Swoole\Http2\Request;
+
+const CONCURRENCY = 300;
+
+$pm = new ProcessManager;
+$pm->parentFunc = function () use ($pm) {
+    Co\run(function () use ($pm) {
+        // the coroutines share one connection, the requests overlap
+        $client = new Client('127.0.0.1', $pm->getFreePort());
+        $fds = [];
+        $start = microtime(true);
+        for ($n = CONCURRENCY; $n--;) {
+            go(function () use ($client, $n, &$fds) {
+                $request = new Request;
+                $request->data = (string) $n;
+                $response = $client->request($request, 5);
+                Assert::isInstanceOf($response, Swoole\Http2\Response::class);
+                Assert::same($response->data, (string) $n);
+                $fds[$response->headers['x-fd']] = true;
+            });
+        }
+        while (count(Coroutine::listCoroutines()) > 1) {
+            Coroutine::sleep(0.01);
+        }
+        Assert::same(count($fds), 1);
+        Assert::lessThan(microtime(true) - $start, 2);
+
+        // the timed out stream is cancelled, the connection keeps working
+        $request = new Request;
+        $request->path = '/slow';
+        $start = microtime(true);
+        Assert::false($client->request($request, 0.1));
+        Assert::same($client->errCode, SOCKET_ETIMEDOUT);
+        Assert::lessThan(microtime(true) - $start, 0.5);
+        $request = new Request;
+        $request->data = 'foo';
+        $response = $client->request($request, 5);
+        Assert::isInstanceOf($response, Swoole\Http2\Response::class);
+        Assert::same($response->data, 'foo');
+
+        // the clients share a few connections, the others wait when the servers limit the concurrent streams
+        $fds = [];
+        $start = microtime(true);
+        for ($n = CONCURRENCY; $n--;) {
+            go(function () use ($pm, $n, &$fds) {
+                $client = new Client('127.0.0.1', $pm->getFreePort());
+                $client->set(['shared_sessions' => 2]);
+                $request = new Request;
+                $request->data = (string) $n;
+                $response = $client->request($request, 5);
+                Assert::isInstanceOf($response, Swoole\Http2\Response::class);
+                Assert::same($response->data, (string) $n);
+                $fds[$response->headers['x-fd']] = true;
+            });
+        }
+        while (count(Coroutine::listCoroutines()) > 1) {
+            Coroutine::sleep(0.01);
+        }
+        Assert::same(count($fds), 2);
+        Assert::lessThan(microtime(true) - $start, 2);
+    });
+    echo "DONE\n";
+    $pm->kill();
+};
+
+$pm->childFunc = function () use ($pm) {
+    $http = new Server('127.0.0.1', $pm->getFreePort(), SWOOLE_BASE);
+    $http->set([
+        'log_file' => '/dev/null',
+        'open_http2_protocol' => true
+    ]);
+    $http->on('request', function (\Swoole\Http\Request $request, \Swoole\Http\Response $response) {
+        Coroutine::sleep($request->server['request_uri'] === '/slow' ? 1 : mt_rand(1, 50) / 1000);
+        $response->header('x-fd', (string) $request->fd);
+        $response->end($request->rawContent());
+    });
+    $http->start();
+};
+
+$pm->childFirst();
+$pm->run();
+
+?>
+--EXPECT--
+DONE
@@ -0,0 +1,60 @@
+--TEST--
+swoole_http2_server: header template
+--SKIPIF--
+<?php require __DIR__ . '/../include/skipif.inc'; ?>
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+$pm = new ProcessManager;
+$pm->parentFunc = function ($pid) use ($pm) {
+    go(function () use ($pm) {
+        $cli = new Swoole\Coroutine\Http2\Client('127.0.0.1', $pm->getFreePort());
+        Assert::true($cli->connect());
+
+        $response = $cli->request(new Swoole\Http2\Request);
+        Assert::same($response->statusCode, 200);
+        Assert::same($response->headers['content-type'], 'application/json');
+        Assert::same($response->headers['x-powered-by'], 'swoole');
+        Assert::same($response->headers['server'], 'swoole-http-server');
+        Assert::false(isset($response->headers['connection']));
+        Assert::same($response->data, '{"ok":true}');
+
+        $request = new Swoole\Http2\Request;
+        $request->path = '/override';
+        $response = $cli->request($request);
+        Assert::same($response->headers['content-type'], 'text/plain');
+        Assert::same($response->headers['x-powered-by'], 'swoole');
+    });
+    Swoole\Event::wait();
+    $pm->kill();
+    echo "DONE\n";
+};
+$pm->childFunc = function () use ($pm) {
+    $json = Swoole\Http\Response::createHeaderTemplate([
+        'Content-Type' => 'application/json',
+        'X-Powered-By' => 'swoole',
+        'Connection' => 'keep-alive',
+    ]);
+    $http = new Swoole\Http\Server('127.0.0.1', $pm->getFreePort(), SWOOLE_BASE);
+    $http->set([
+        'worker_num' => 1,
+        'log_file' => '/dev/null',
+        'open_http2_protocol' => true
+    ]);
+    $http->on('workerStart', function () use ($pm) {
+        $pm->wakeup();
+    });
+    $http->on('request', function (Swoole\Http\Request $request, Swoole\Http\Response $response) use ($json) {
+        Assert::true($response->headerTemplate($json));
+        if ($request->server['request_uri'] == '/override') {
+            $response->header('content-type', 'text/plain');
+        }
+        $response->end('{"ok":true}');
+    });
+    $http->start();
+};
+$pm->childFirst();
+$pm->run();
+?>
+--EXPECT--
+DONE
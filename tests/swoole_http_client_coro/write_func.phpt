@@ -0,0 +1,71 @@
+--TEST--
+swoole_http_client_coro: receive the body chunks with write_func
+--SKIPIF--
+<?php require __DIR__ . '/../include/skipif.inc'; ?>
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+
+const SIZE = 8 * 1024 * 1024;
+
+$pm = new ProcessManager;
+$pm->parentFunc = function (int $pid) use ($pm) {
+    go(function () use ($pm) {
+        $cli = new Swoole\Coroutine\Http\Client('127.0.0.1', $pm->getFreePort());
+        $context = hash_init('md5');
+        $chunks = 0;
+        $cli->set([
+            'timeout' => 5,
+            'write_func' => function (Swoole\Coroutine\Http\Client $client, string $data) use ($context, &$chunks) {
+                hash_update($context, $data);
+                $chunks++;
+            }
+        ]);
+        Assert::assert($cli->get('/'));
+        Assert::same($cli->statusCode, 200);
+        Assert::same($cli->body, '');
+        Assert::greaterThan($chunks, 1);
+        Assert::same(hash_final($context), $cli->headers['content-md5']);
+
+        // return false to abort the transfer
+        $received = 0;
+        $cli->set([
+            'write_func' => function ($client, string $data) use (&$received) {
+                $received += strlen($data);
+                return false;
+            }
+        ]);
+        Assert::false($cli->get('/'));
+        Assert::same($cli->errCode, SOCKET_ECANCELED);
+        Assert::lessThan($received, SIZE);
+
+        // the download without decoding goes to the file directly
+        $cli->set(['write_func' => null]);
+        $filename = '/tmp/swoole_http_client_write_func.data';
+        Assert::assert($cli->download('/', $filename));
+        Assert::same(filesize($filename), SIZE);
+        Assert::same(md5_file($filename), $cli->headers['content-md5']);
+        unlink($filename);
+    });
+    swoole_event_wait();
+    $pm->kill();
+    echo "DONE\n";
+};
+$pm->childFunc = function () use ($pm) {
+    $data = random_bytes(SIZE);
+    $serv = new swoole_http_server('127.0.0.1', $pm->getFreePort(), SWOOLE_BASE);
+    $serv->set(['log_file' => '/dev/null', 'http_compression' => false]);
+    $serv->on('workerStart', function () use ($pm) {
+        $pm->wakeup();
+    });
+    $serv->on('request', function (swoole_http_request $request, swoole_http_response $response) use ($data) {
+        $response->header('Content-MD5', md5($data));
+        $response->end($data);
+    });
+    $serv->start();
+};
+$pm->childFirst();
+$pm->run();
+?>
+--EXPECT--
+DONE
@@ -0,0 +1,78 @@
+--TEST--
+swoole_http_server: read the body larger than package_max_length as it arrives
+--SKIPIF--
+<?php require __DIR__ . '/../include/skipif.inc'; ?>
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+
+const MAX_LENGTH = 1024 * 1024;
+
+$pm = new ProcessManager;
+
+$pm->parentFunc = function ($pid) use ($pm) {
+    $client = new swoole_client(SWOOLE_SOCK_TCP);
+    if (!$client->connect('127.0.0.1', $pm->getFreePort(), 5)) {
+        exit("connect failed. Error: {$client->errCode}\n");
+    }
+    // the small request is not streamed and the connection keeps working after the large one
+    $bodies = [str_repeat('A', 1024), random_bytes(4 * MAX_LENGTH), str_repeat('B', 1024)];
+    foreach ($bodies as $body) {
+        $length = strlen($body);
+        $client->send("POST /upload HTTP/1.1\r\nHost: localhost\r\nContent-Length: {$length}\r\n\r\n");
+        for ($offset = 0; $offset < $length; $offset += 65536) {
+            $client->send(substr($body, $offset, 65536));
+        }
+        $html = '';
+        while (strpos($html, md5($body)) === false) {
+            $data = $client->recv();
+            if (!$data) {
+                echo "ERROR\n";
+                break 2;
+            }
+            $html .= $data;
+        }
+    }
+    $pm->kill();
+    echo "DONE\n";
+};
+
+$pm->childFunc = function () use ($pm) {
+    $http = new swoole_http_server('127.0.0.1', $pm->getFreePort(), SWOOLE_PROCESS);
+    $http->set([
+        'worker_num' => 1,
+        'package_max_length' => MAX_LENGTH,
+        'http_body_stream' => true,
+        'log_file' => '/dev/null',
+    ]);
+    $http->on("WorkerStart", function ($serv, $wid) use ($pm) {
+        $pm->wakeup();
+    });
+    $http->on("request", function (swoole_http_request $request, swoole_http_response $response) {
+        $length = (int) $request->header['content-length'];
+        if ($length > MAX_LENGTH) {
+            // the reader is late, the reactor stops receiving once package_max_length is buffered
+            Co::sleep(0.2);
+            $context = hash_init('md5');
+            $n = 0;
+            while (($data = $request->read()) !== '') {
+                Assert::string($data);
+                hash_update($context, $data);
+                $n += strlen($data);
+            }
+            Assert::same($n, $length);
+            Assert::same($request->rawContent(), '');
+            $response->end(hash_final($context));
+        } else {
+            Assert::same($request->read(), '');
+            $response->end(md5($request->rawContent()));
+        }
+    });
+    $http->start();
+};
+
+$pm->childFirst();
+$pm->run();
+?>
+--EXPECT--
+DONE
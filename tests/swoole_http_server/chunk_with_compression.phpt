@@ -0,0 +1,55 @@
+--TEST--
+swoole_http_server: http chunk with compression
+--SKIPIF--
+<?php require __DIR__ . '/../include/skipif.inc'; ?>
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+
+$pm = new ProcessManager;
+
+$pm->parentFunc = function () use ($pm) {
+    go(function () use ($pm) {
+        $cli = new Swoole\Coroutine\Http\Client('127.0.0.1', $pm->getFreePort());
+        $cli->setHeaders(['Accept-Encoding' => 'gzip']);
+        Assert::assert($cli->get('/'));
+        Assert::same($cli->statusCode, 200);
+        Assert::same($cli->headers['content-encoding'], 'gzip');
+        Assert::same($cli->headers['transfer-encoding'], 'chunked');
+        Assert::same(md5($cli->body), md5_file(__DIR__ . '/../../README.md'));
+        $pm->kill();
+    });
+    Swoole\Event::wait();
+    echo "DONE\n";
+};
+
+$pm->childFunc = function () use ($pm) {
+    $http = new swoole_http_server('127.0.0.1', $pm->getFreePort(), SWOOLE_BASE);
+
+    $http->set([
+        'log_file' => '/dev/null',
+        'http_compression' => true,
+    ]);
+
+    $http->on("WorkerStart", function ($serv, $wid) {
+        global $pm;
+        $pm->wakeup();
+    });
+
+    $http->on("request", function (swoole_http_request $request,  swoole_http_response $response) {
+        $data = str_split(co::readFile(__DIR__ . '/../../README.md'), 1024);
+        foreach ($data as $chunk)
+        {
+            $response->write($chunk);
+        }
+        $response->end();
+    });
+
+    $http->start();
+};
+
+$pm->childFirst();
+$pm->run();
+?>
+--EXPECT--
+DONE
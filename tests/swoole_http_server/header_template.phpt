@@ -0,0 +1,68 @@
+--TEST--
+swoole_http_server: header template
+--SKIPIF--
+<?php require __DIR__ . '/../include/skipif.inc'; ?>
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+
+$pm = new ProcessManager;
+
+$pm->parentFunc = function () use ($pm) {
+    go(function () use ($pm) {
+        $cli = new Swoole\Coroutine\Http\Client('127.0.0.1', $pm->getFreePort());
+        Assert::assert($cli->get('/'));
+        Assert::same($cli->statusCode, 200);
+        Assert::same($cli->headers['content-type'], 'application/json');
+        Assert::same($cli->headers['x-powered-by'], 'swoole');
+        Assert::same($cli->headers['x-request'], '1');
+        Assert::same($cli->headers['server'], 'swoole-http-server');
+        Assert::assert(strtotime($cli->headers['date']) > 0);
+        Assert::same($cli->body, '{"ok":true}');
+
+        // the headers set by the response take precedence over the template
+        Assert::assert($cli->get('/override'));
+        Assert::same($cli->headers['content-type'], 'text/plain');
+        Assert::same($cli->headers['x-powered-by'], 'swoole');
+
+        Assert::assert($cli->get('/plain'));
+        Assert::same($cli->headers['content-type'], 'text/html');
+        Assert::false(isset($cli->headers['x-powered-by']));
+        $pm->kill();
+    });
+    Swoole\Event::wait();
+    echo "DONE\n";
+};
+
+$pm->childFunc = function () use ($pm) {
+    $json = Swoole\Http\Response::createHeaderTemplate([
+        'content-type' => 'application/json',
+        'X-POWERED-BY' => 'swoole',
+    ]);
+    Assert::same($json, 1);
+
+    $http = new swoole_http_server('127.0.0.1', $pm->getFreePort(), SWOOLE_BASE);
+    $http->set(['log_file' => '/dev/null']);
+    $http->on("WorkerStart", function ($serv, $wid) use ($pm) {
+        $pm->wakeup();
+    });
+    $http->on("request", function (swoole_http_request $request, swoole_http_response $response) use ($json) {
+        if ($request->server['request_uri'] == '/plain') {
+            $response->end('hello');
+            return;
+        }
+        Assert::true($response->headerTemplate($json));
+        if ($request->server['request_uri'] == '/override') {
+            $response->header('Content-Type', 'text/plain');
+        }
+        $response->header('X-Request', '1');
+        $response->end('{"ok":true}');
+    });
+    $http->start();
+};
+
+$pm->childFirst();
+$pm->run();
+?>
+--EXPECT--
+DONE
@@ -0,0 +1,72 @@
+--TEST--
+swoole_http_server: dispatch the pipelined requests together
+--SKIPIF--
+<?php require __DIR__ . '/../include/skipif.inc'; ?>
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+
+const N = 16;
+
+$pm = new ProcessManager;
+
+$pm->parentFunc = function ($pid) use ($pm) {
+    $client = new swoole_client(SWOOLE_SOCK_TCP);
+    if (!$client->connect('127.0.0.1', $pm->getFreePort(), 1)) {
+        exit("connect failed. Error: {$client->errCode}\n");
+    }
+    $data = '';
+    for ($i = 0; $i < N; $i++) {
+        $data .= "GET /{$i} HTTP/1.1\r\nHost: localhost\r\nConnection: keep-alive\r\n\r\n";
+    }
+    $client->send($data);
+
+    $html = '';
+    while (substr_count($html, "HTTP/1.1 200 OK") < N) {
+        $data = $client->recv();
+        if (!$data) {
+            echo "ERROR\n";
+            break;
+        }
+        $html .= $data;
+    }
+    preg_match_all('/request#(\d+)/', $html, $matches);
+    Assert::same(array_map('intval', $matches[1]), range(0, N - 1));
+    $pm->kill();
+};
+
+$pm->childFunc = function () use ($pm) {
+    $http = new swoole_http_server('127.0.0.1', $pm->getFreePort(), SWOOLE_PROCESS);
+    $http->set([
+        'worker_num' => 1,
+        'http_pipeline_batch' => true,
+        'log_file' => '/dev/null',
+    ]);
+    $http->on("WorkerStart", function ($serv, $wid) use ($pm) {
+        $pm->wakeup();
+    });
+    $http->on("request", function (swoole_http_request $request, swoole_http_response $response) {
+        $index = (int) substr($request->server['request_uri'], 1);
+        // the handlers finish in reverse order, the responses must keep the order of the requests
+        if ($index % 2 == 0) {
+            Co::sleep((N - $index) / 1000);
+        }
+        // the files of the requests behind the pending ones are queued too
+        if ($index % 4 == 1) {
+            $file = sys_get_temp_dir() . "/swoole_pipeline_batch_{$index}.txt";
+            file_put_contents($file, "request#{$index}");
+            $response->sendfile($file);
+        } else {
+            $response->end("request#{$index}");
+        }
+    });
+    $http->start();
+};
+
+$pm->childFirst();
+$pm->run();
+for ($i = 1; $i < N; $i += 4) {
+    @unlink(sys_get_temp_dir() . "/swoole_pipeline_batch_{$i}.txt");
+}
+?>
+--EXPECT--
@@ -0,0 +1,61 @@
+--TEST--
+swoole_http_server: end() of the pending pipelined requests fails after the connection is closed
+--SKIPIF--
+<?php require __DIR__ . '/../include/skipif.inc'; ?>
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+
+const N = 4;
+
+$failed = new swoole_atomic(0);
+$pm = new ProcessManager;
+
+$pm->parentFunc = function ($pid) use ($pm) {
+    $client = new swoole_client(SWOOLE_SOCK_TCP);
+    if (!$client->connect('127.0.0.1', $pm->getFreePort(), 1)) {
+        exit("connect failed. Error: {$client->errCode}\n");
+    }
+    $data = '';
+    for ($i = 0; $i < N; $i++) {
+        $data .= "GET /{$i} HTTP/1.1\r\nHost: localhost\r\nConnection: keep-alive\r\n\r\n";
+    }
+    $client->send($data);
+    // the requests are dispatched and the first one is still sleeping
+    usleep(10 * 1000);
+    $client->close();
+
+    usleep((N + 2) * 50 * 1000);
+    Assert::same(file_get_contents("http://127.0.0.1:{$pm->getFreePort()}/failed"), (string) N);
+    $pm->kill();
+};
+
+$pm->childFunc = function () use ($pm, $failed) {
+    $http = new swoole_http_server('127.0.0.1', $pm->getFreePort(), SWOOLE_PROCESS);
+    $http->set([
+        'worker_num' => 1,
+        'http_pipeline_batch' => true,
+        'log_file' => '/dev/null',
+    ]);
+    $http->on("WorkerStart", function ($serv, $wid) use ($pm) {
+        $pm->wakeup();
+    });
+    $http->on("request", function (swoole_http_request $request, swoole_http_response $response) use ($failed) {
+        if ($request->server['request_uri'] == '/failed') {
+            $response->end($failed->get());
+            return;
+        }
+        $index = (int) substr($request->server['request_uri'], 1);
+        // every request is the first pending one when it ends, after the client has gone
+        Co::sleep(($index + 1) * 0.05);
+        if (!@$response->end("request#{$index}")) {
+            $failed->add(1);
+        }
+    });
+    $http->start();
+};
+
+$pm->childFirst();
+$pm->run();
+?>
+--EXPECT--
@@ -0,0 +1,69 @@
+--TEST--
+swoole_http_server/static_handler: static file cache and etag
+--SKIPIF--
+<?php
+require __DIR__ . '/../../include/skipif.inc'; ?>
+--FILE--
+<?php
+require __DIR__ . '/../../include/bootstrap.php';
+
+use Swoole\Http\Request;
+use Swoole\Http\Response;
+use Swoole\Http\Server;
+
+$pm = new ProcessManager;
+$pm->parentFunc = function () use ($pm) {
+    Swoole\Coroutine\run(function () use ($pm) {
+        foreach (['/test.jpg', '/logo.svg'] as $file) {
+            $etag = null;
+            for ($i = 0; $i < 3; $i++) {
+                $cli = new Swoole\Coroutine\Http\Client('127.0.0.1', $pm->getFreePort());
+                Assert::assert($cli->get($file));
+                Assert::same($cli->statusCode, 200);
+                Assert::same(md5($cli->body), md5_file(dirname(dirname(dirname(__DIR__))) . '/examples' . $file));
+                Assert::notEmpty($cli->headers['etag']);
+                if ($etag) {
+                    Assert::same($cli->headers['etag'], $etag);
+                }
+                $etag = $cli->headers['etag'];
+            }
+            $cli = new Swoole\Coroutine\Http\Client('127.0.0.1', $pm->getFreePort());
+            $cli->setHeaders(['If-None-Match' => $etag]);
+            Assert::assert($cli->get($file));
+            Assert::same($cli->statusCode, 304);
+
+            // If-Modified-Since is ignored when If-None-Match is present
+            $cli = new Swoole\Coroutine\Http\Client('127.0.0.1', $pm->getFreePort());
+            $cli->setHeaders([
+                'If-None-Match' => '"stale"',
+                'If-Modified-Since' => gmdate('D, d M Y H:i:s \G\M\T', time() + 86400),
+            ]);
+            Assert::assert($cli->get($file));
+            Assert::same($cli->statusCode, 200);
+        }
+    });
+    $pm->kill();
+    echo "DONE\n";
+};
+$pm->childFunc = function () use ($pm) {
+    $http = new Server('127.0.0.1', $pm->getFreePort(), SWOOLE_BASE);
+    $http->set([
+        'log_file' => '/dev/null',
+        'enable_static_handler' => true,
+        'document_root' => dirname(dirname(dirname(__DIR__))) . '/examples/',
+        'static_handler_cache_ttl' => 10,
+        'static_handler_cache_max_file_size' => 8192,
+    ]);
+    $http->on('workerStart', function () use ($pm) {
+        $pm->wakeup();
+    });
+    $http->on('request', function (Request $request, Response $response) {
+        $response->end('hello world');
+    });
+    $http->start();
+};
+$pm->childFirst();
+$pm->run();
+?>
+--EXPECT--
+DONE
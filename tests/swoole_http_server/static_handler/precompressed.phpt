@@ -0,0 +1,87 @@
+--TEST--
+swoole_http_server/static_handler: serve the precompressed sidecar file
+--SKIPIF--
+<?php
+require __DIR__ . '/../../include/skipif.inc'; ?>
+--FILE--
+<?php
+require __DIR__ . '/../../include/bootstrap.php';
+
+use Swoole\Http\Request;
+use Swoole\Http\Response;
+use Swoole\Http\Server;
+
+$root = sys_get_temp_dir() . '/swoole_static_precompressed';
+@mkdir($root);
+$content = str_repeat('swoole static handler ', 1024);
+file_put_contents("{$root}/test.js", $content);
+file_put_contents("{$root}/test.js.gz", gzencode($content));
+
+$pm = new ProcessManager;
+$pm->parentFunc = function () use ($pm, $root, $content) {
+    Swoole\Coroutine\run(function () use ($pm, $root, $content) {
+        $cli = new Swoole\Coroutine\Http\Client('127.0.0.1', $pm->getFreePort());
+        $cli->setHeaders(['Accept-Encoding' => 'gzip']);
+        Assert::assert($cli->get('/test.js'));
+        Assert::same($cli->statusCode, 200);
+        Assert::same($cli->headers['content-encoding'], 'gzip');
+        Assert::same($cli->headers['vary'], 'Accept-Encoding');
+        Assert::same($cli->body, $content);
+        $gzip_etag = $cli->headers['etag'];
+        Assert::endsWith($gzip_etag, '-gzip"');
+
+        $cli = new Swoole\Coroutine\Http\Client('127.0.0.1', $pm->getFreePort());
+        $cli->setHeaders(['Accept-Encoding' => 'identity']);
+        Assert::assert($cli->get('/test.js'));
+        Assert::same($cli->statusCode, 200);
+        Assert::assert(!isset($cli->headers['content-encoding']));
+        Assert::same($cli->headers['vary'], 'Accept-Encoding');
+        Assert::same($cli->body, $content);
+        $etag = $cli->headers['etag'];
+        Assert::notEq($etag, $gzip_etag);
+
+        // gzip is refused by its q-value
+        $cli = new Swoole\Coroutine\Http\Client('127.0.0.1', $pm->getFreePort());
+        $cli->setHeaders(['Accept-Encoding' => 'br;q=0.5, gzip;q=0']);
+        Assert::assert($cli->get('/test.js'));
+        Assert::same($cli->statusCode, 200);
+        Assert::assert(!isset($cli->headers['content-encoding']));
+        Assert::same($cli->headers['etag'], $etag);
+
+        // the ETag of one encoding does not validate the other
+        $cli = new Swoole\Coroutine\Http\Client('127.0.0.1', $pm->getFreePort());
+        $cli->setHeaders(['Accept-Encoding' => 'identity', 'If-None-Match' => $gzip_etag]);
+        Assert::assert($cli->get('/test.js'));
+        Assert::same($cli->statusCode, 200);
+        $cli = new Swoole\Coroutine\Http\Client('127.0.0.1', $pm->getFreePort());
+        $cli->setHeaders(['Accept-Encoding' => 'gzip', 'If-None-Match' => $gzip_etag]);
+        Assert::assert($cli->get('/test.js'));
+        Assert::same($cli->statusCode, 304);
+    });
+    $pm->kill();
+    unlink("{$root}/test.js");
+    unlink("{$root}/test.js.gz");
+    rmdir($root);
+    echo "DONE\n";
+};
+$pm->childFunc = function () use ($pm, $root) {
+    $http = new Server('127.0.0.1', $pm->getFreePort(), SWOOLE_BASE);
+    $http->set([
+        'log_file' => '/dev/null',
+        'enable_static_handler' => true,
+        'document_root' => $root,
+        'static_handler_precompressed' => true,
+    ]);
+    $http->on('workerStart', function () use ($pm) {
+        $pm->wakeup();
+    });
+    $http->on('request', function (Request $request, Response $response) {
+        $response->end('hello world');
+    });
+    $http->start();
+};
+$pm->childFirst();
+$pm->run();
+?>
+--EXPECT--
+DONE
@@ -0,0 +1,38 @@
+--TEST--
+swoole_lock: coroutine lock does not block the worker
+--SKIPIF--
+<?php require __DIR__ . '/../include/skipif.inc'; ?>
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+
+$lock = new Swoole\Lock(SWOOLE_COROLOCK);
+
+go(function () use ($lock) {
+    Assert::true($lock->lock());
+    echo "co1 locked\n";
+    co::sleep(0.1);
+    echo "co1 unlock\n";
+    $lock->unlock();
+});
+
+go(function () use ($lock) {
+    Assert::false($lock->trylock());
+    Assert::true($lock->lock());
+    echo "co2 locked\n";
+    $lock->unlock();
+});
+
+go(function () {
+    // the waiting coroutine must not stall the others
+    co::sleep(0.01);
+    echo "co3 running\n";
+});
+
+swoole_event_wait();
+?>
+--EXPECT--
+co1 locked
+co3 running
+co1 unlock
+co2 locked
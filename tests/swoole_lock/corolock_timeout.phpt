@@ -0,0 +1,38 @@
+--TEST--
+swoole_lock: coroutine lock wait timeout
+--SKIPIF--
+<?php require __DIR__ . '/../include/skipif.inc'; ?>
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+
+$lock = new Swoole\Lock(SWOOLE_COROLOCK);
+
+// outside a coroutine the timeout is honoured as well
+Assert::true($lock->lock());
+$start = microtime(true);
+Assert::false($lock->lockwait(0.05));
+Assert::same($lock->errCode, SOCKET_ETIMEDOUT);
+time_approximate(0.05, microtime(true) - $start);
+$lock->unlock();
+
+go(function () use ($lock) {
+    Assert::true($lock->lock());
+    co::sleep(0.2);
+    $lock->unlock();
+});
+
+go(function () use ($lock) {
+    $start = microtime(true);
+    Assert::false($lock->lockwait(0.05));
+    Assert::same($lock->errCode, SOCKET_ETIMEDOUT);
+    time_approximate(0.05, microtime(true) - $start);
+    Assert::true($lock->lockwait(1));
+    $lock->unlock();
+    echo "DONE\n";
+});
+
+swoole_event_wait();
+?>
+--EXPECT--
+DONE
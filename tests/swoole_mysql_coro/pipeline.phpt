@@ -0,0 +1,52 @@
+--TEST--
+swoole_mysql_coro: send the queries and statements in a pipeline
+--SKIPIF--
+<?php require __DIR__ . '/../include/skipif.inc'; ?>
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+
+use Swoole\Coroutine as Co;
+
+Co\run(function () {
+    $db = new Co\MySQL;
+    $server = [
+        'host' => MYSQL_SERVER_HOST,
+        'port' => MYSQL_SERVER_PORT,
+        'user' => MYSQL_SERVER_USER,
+        'password' => MYSQL_SERVER_PWD,
+        'database' => MYSQL_SERVER_DB
+    ];
+    Assert::true($db->connect($server));
+    $stmt = $db->prepare('SELECT ? + ? AS `n`');
+    $requests = ['SELECT 1 AS `n`'];
+    for ($i = 0; $i < 100; $i++) {
+        $requests[] = [$stmt, [$i, 1]];
+    }
+    $requests[] = 'SELECT * FROM `not_exist_table`';
+    $requests[] = $db->prepare('SELECT 2 AS `n`');
+    $requests[] = 'SET @a = 1';
+
+    $results = $db->pipeline($requests);
+    Assert::count($results, 104);
+    Assert::same($results[0], [['n' => '1']]);
+    for ($i = 0; $i < 100; $i++) {
+        Assert::eq($results[$i + 1][0]['n'], $i + 1);
+    }
+    Assert::false($results[101]);
+    Assert::same($db->errno, 1146);
+    Assert::same($results[102], [['n' => 2]]);
+    Assert::true($results[103]);
+
+    // the connection keeps working
+    Assert::same($db->query('SELECT @a AS `a`'), [['a' => '1']]);
+    Assert::same($db->pipeline([]), []);
+
+    $db->setDefer();
+    Assert::false($db->pipeline(['SELECT 1']));
+    Assert::contains($db->error, 'pipeline');
+});
+echo "DONE\n";
+?>
+--EXPECT--
+DONE
@@ -0,0 +1,60 @@
+--TEST--
+swoole_mysql_coro: reuse the prepared statements by the statement cache
+--SKIPIF--
+<?php require __DIR__ . '/../include/skipif.inc'; ?>
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+
+use Swoole\Coroutine as Co;
+
+function get_session_status(Co\MySQL $db, string $name): int
+{
+    return (int) $db->query("SHOW SESSION STATUS LIKE '{$name}'")[0]['Value'];
+}
+
+Co\run(function () {
+    $db = new Co\MySQL;
+    $server = [
+        'host' => MYSQL_SERVER_HOST,
+        'port' => MYSQL_SERVER_PORT,
+        'user' => MYSQL_SERVER_USER,
+        'password' => MYSQL_SERVER_PWD,
+        'database' => MYSQL_SERVER_DB,
+        'statement_cache_size' => 2
+    ];
+    Assert::true($db->connect($server));
+    $prepared = get_session_status($db, 'Com_stmt_prepare');
+
+    // the same sql shares one statement
+    $stmt1 = $db->prepare('SELECT ? + 1 AS `n`');
+    $stmt2 = $db->prepare('SELECT ? + 1 AS `n`');
+    Assert::same($stmt1->id, $stmt2->id);
+    Assert::same($stmt2->execute([1]), [['n' => 2]]);
+    unset($stmt1, $stmt2);
+    Assert::same($db->prepare('SELECT ? + 1 AS `n`')->execute([2]), [['n' => 3]]);
+    Assert::same(get_session_status($db, 'Com_stmt_prepare'), $prepared + 1);
+
+    // the least recently used one is evicted and closed by the next command
+    $db->prepare('SELECT ? + 2 AS `n`');
+    $db->prepare('SELECT ? + 3 AS `n`');
+    Assert::same(get_session_status($db, 'Com_stmt_close'), 1);
+    Assert::same($db->prepare('SELECT ? + 3 AS `n`')->execute([3]), [['n' => 6]]);
+    Assert::same(get_session_status($db, 'Com_stmt_prepare'), $prepared + 3);
+
+    // prepared again after reconnecting
+    $db->close();
+    Assert::true($db->connect($server));
+    $stmt = $db->prepare('SELECT ? + 3 AS `n`');
+    Assert::same($stmt->execute([4]), [['n' => 7]]);
+    Assert::same(get_session_status($db, 'Com_stmt_prepare'), 1);
+
+    // closing the statement removes it from the cache
+    $id = $stmt->id;
+    $stmt->close();
+    Assert::notSame($db->prepare('SELECT ? + 3 AS `n`')->id, $id);
+});
+echo "DONE\n";
+?>
+--EXPECT--
+DONE
@@ -0,0 +1,70 @@
+--TEST--
+swoole_runtime: curl_exec runs on the reactor with the native curl hook
+--SKIPIF--
+<?php
+require __DIR__ . '/../include/skipif.inc';
+skip_if_extension_not_exist('curl');
+skip_if_constant_not_defined('SWOOLE_HOOK_NATIVE_CURL');
+?>
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+
+const N = 8;
+
+Swoole\Runtime::enableCoroutine(SWOOLE_HOOK_NATIVE_CURL);
+
+go(function () {
+    $port = get_one_free_port();
+    $server = new Co\Http\Server('127.0.0.1', $port, false);
+    $server->handle('/', function ($request, $response) {
+        Co::sleep(0.1);
+        $response->end("hello {$request->get['id']}");
+    });
+    go(function () use ($server) {
+        $server->start();
+    });
+
+    $chan = new Co\Channel(N);
+    $start = microtime(true);
+    for ($i = 0; $i < N; $i++) {
+        go(function () use ($chan, $port, $i) {
+            $ch = curl_init("http://127.0.0.1:{$port}/?id={$i}");
+            curl_setopt($ch, CURLOPT_RETURNTRANSFER, true);
+            $chan->push([$i, curl_exec($ch), curl_getinfo($ch, CURLINFO_HTTP_CODE)]);
+            curl_close($ch);
+        });
+    }
+    for ($i = 0; $i < N; $i++) {
+        list($id, $body, $code) = $chan->pop();
+        Assert::same($code, 200);
+        Assert::same($body, "hello {$id}");
+    }
+    // the requests wait on the server together
+    Assert::lessThan(microtime(true) - $start, 0.1 * N / 2);
+
+    // the write callback runs inside the waiting coroutine
+    $ch = curl_init("http://127.0.0.1:{$port}/?id=callback");
+    $data = '';
+    curl_setopt($ch, CURLOPT_WRITEFUNCTION, function ($ch, $chunk) use (&$data) {
+        Assert::greaterThan(Co::getCid(), 0);
+        $data .= $chunk;
+        return strlen($chunk);
+    });
+    Assert::true(curl_exec($ch));
+    Assert::same($data, 'hello callback');
+    curl_close($ch);
+
+    // connection errors are reported by curl_errno
+    $ch = curl_init('http://127.0.0.1:' . get_one_free_port() . '/');
+    Assert::false(curl_exec($ch));
+    Assert::same(curl_errno($ch), CURLE_COULDNT_CONNECT);
+    curl_close($ch);
+
+    $server->shutdown();
+});
+Swoole\Event::wait();
+echo "DONE\n";
+?>
+--EXPECT--
+DONE
@@ -0,0 +1,71 @@
+--TEST--
+swoole_server: receive large length-checked packages in base mode
+--SKIPIF--
+<?php require __DIR__ . '/../include/skipif.inc'; ?>
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+
+const N = 8;
+$port = get_one_free_port();
+
+$pm = new SwooleTest\ProcessManager;
+
+$pm->parentFunc = function ($pid) use ($pm, $port)
+{
+    $client = new swoole_client(SWOOLE_SOCK_TCP, SWOOLE_SOCK_SYNC);
+    $client->set([
+        'open_length_check' => true,
+        'package_length_type' => 'N',
+        'package_length_offset' => 0,
+        'package_body_offset' => 4,
+        'package_max_length' => 8 * 1024 * 1024,
+    ]);
+    if (!$client->connect('127.0.0.1', $port, 5))
+    {
+        exit("connect failed\n");
+    }
+    $packages = [];
+    for ($i = 0; $i < N; $i++)
+    {
+        $body = str_repeat(chr(ord('a') + $i), mt_rand(1, 4 * 1024 * 1024));
+        $packages[] = $body;
+        $client->send(pack('N', strlen($body)) . $body);
+    }
+    for ($i = 0; $i < N; $i++)
+    {
+        $data = $client->recv();
+        Assert::same($data, pack('N', 32) . md5($packages[$i]));
+    }
+    $pm->kill();
+};
+
+$pm->childFunc = function () use ($pm, $port)
+{
+    $serv = new swoole_server('127.0.0.1', $port, SWOOLE_BASE);
+    $serv->set([
+        'worker_num' => 1,
+        'open_length_check' => true,
+        'package_length_type' => 'N',
+        'package_length_offset' => 0,
+        'package_body_offset' => 4,
+        'package_max_length' => 8 * 1024 * 1024,
+        'log_file' => '/dev/null',
+    ]);
+    $serv->on("workerStart", function ($serv) use ($pm)
+    {
+        $pm->wakeup();
+    });
+    $serv->on('receive', function ($serv, $fd, $rid, $data)
+    {
+        $length = unpack('N', $data)[1];
+        Assert::same(strlen($data), $length + 4);
+        $serv->send($fd, pack('N', 32) . md5(substr($data, 4)));
+    });
+    $serv->start();
+};
+
+$pm->childFirst();
+$pm->run();
+?>
+--EXPECT--
@@ -0,0 +1,59 @@
+--TEST--
+swoole_server: refuse the large package beyond memory_limit in base mode
+--SKIPIF--
+<?php require __DIR__ . '/../include/skipif.inc'; ?>
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+
+$port = get_one_free_port();
+
+$pm = new SwooleTest\ProcessManager;
+
+$pm->parentFunc = function ($pid) use ($pm, $port)
+{
+    $client = new swoole_client(SWOOLE_SOCK_TCP, SWOOLE_SOCK_SYNC);
+    Assert::assert($client->connect('127.0.0.1', $port, 5));
+    // only the header is needed, the buffer is allocated for the whole package
+    $client->send(pack('N', 64 * 1024 * 1024) . 'hello');
+    Assert::same($client->recv(), '');
+
+    // the worker is still alive
+    $client = new swoole_client(SWOOLE_SOCK_TCP, SWOOLE_SOCK_SYNC);
+    Assert::assert($client->connect('127.0.0.1', $port, 5));
+    $body = str_repeat('a', 4 * 1024 * 1024);
+    $client->send(pack('N', strlen($body)) . $body);
+    Assert::same($client->recv(), md5($body));
+    $pm->kill();
+    echo "DONE\n";
+};
+
+$pm->childFunc = function () use ($pm, $port)
+{
+    ini_set('memory_limit', '32M');
+    $serv = new swoole_server('127.0.0.1', $port, SWOOLE_BASE);
+    $serv->set([
+        'worker_num' => 1,
+        'open_length_check' => true,
+        'package_length_type' => 'N',
+        'package_length_offset' => 0,
+        'package_body_offset' => 4,
+        'package_max_length' => 128 * 1024 * 1024,
+        'log_file' => '/dev/null',
+    ]);
+    $serv->on("workerStart", function ($serv) use ($pm)
+    {
+        $pm->wakeup();
+    });
+    $serv->on('receive', function ($serv, $fd, $rid, $data)
+    {
+        $serv->send($fd, md5(substr($data, 4)));
+    });
+    $serv->start();
+};
+
+$pm->childFirst();
+$pm->run();
+?>
+--EXPECT--
+DONE
@@ -0,0 +1,74 @@
+--TEST--
+swoole_server: receive udp packets in batches
+--SKIPIF--
+<?php require __DIR__ . '/../include/skipif.inc'; ?>
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+
+const N = 256;
+$port = get_one_free_port();
+
+$pm = new SwooleTest\ProcessManager;
+
+$pm->parentFunc = function ($pid) use ($pm, $port)
+{
+    $client = new swoole_client(SWOOLE_SOCK_UDP, SWOOLE_SOCK_SYNC);
+    if (!$client->connect('127.0.0.1', $port, 5))
+    {
+        exit("connect failed\n");
+    }
+    for ($i = 0; $i < N; $i++)
+    {
+        $client->send("packet-{$i}");
+    }
+    $replies = [];
+    for ($i = 0; $i < N; $i++)
+    {
+        $data = $client->recv();
+        if (!$data)
+        {
+            break;
+        }
+        $replies[$data] = true;
+    }
+    Assert::same(count($replies), N);
+    for ($i = 0; $i < N; $i++)
+    {
+        Assert::true(isset($replies["reply: packet-{$i}"]));
+    }
+    $client->send('stats');
+    Assert::same($client->recv(), 'dgram_send_fail_count: 0');
+    $pm->kill();
+};
+
+$pm->childFunc = function () use ($pm, $port)
+{
+    $serv = new swoole_server('127.0.0.1', $port, SWOOLE_PROCESS, SWOOLE_SOCK_UDP);
+    $serv->set([
+        'worker_num' => 2,
+        'dgram_recv_batch' => 64,
+        'dgram_max_size' => 2048,
+        'kernel_socket_recv_buffer_size' => 1024 * 1024,
+        'log_file' => '/dev/null',
+    ]);
+    $serv->on("workerStart", function ($serv) use ($pm)
+    {
+        $pm->wakeup();
+    });
+    $serv->on('packet', function ($serv, $data, $client)
+    {
+        if ($data == 'stats')
+        {
+            $serv->sendto($client['address'], $client['port'], "dgram_send_fail_count: " . $serv->stats()['dgram_send_fail_count']);
+            return;
+        }
+        $serv->sendto($client['address'], $client['port'], "reply: {$data}");
+    });
+    $serv->start();
+};
+
+$pm->childFirst();
+$pm->run();
+?>
+--EXPECT--
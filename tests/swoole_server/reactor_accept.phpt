@@ -0,0 +1,56 @@
+--TEST--
+swoole_server: accept in the reactor threads
+--SKIPIF--
+<?php require __DIR__ . '/../include/skipif.inc'; ?>
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+
+const N = 32;
+
+$pm = new SwooleTest\ProcessManager;
+
+$pm->parentFunc = function ($pid) use ($pm) {
+    go(function () use ($pm) {
+        $reactors = [];
+        for ($i = 0; $i < N; $i++) {
+            $client = new Co\Client(SWOOLE_SOCK_TCP);
+            Assert::assert($client->connect('127.0.0.1', $pm->getFreePort()));
+            Assert::assert($client->send("hello"));
+            $reactor_id = $client->recv();
+            Assert::assert(is_numeric($reactor_id));
+            $reactors[$reactor_id] = true;
+            $client->close();
+        }
+        Assert::assert(count($reactors) >= 1);
+        $pm->kill();
+    });
+    Swoole\Event::wait();
+    echo "DONE\n";
+};
+
+$pm->childFunc = function () use ($pm) {
+    $serv = new Swoole\Server('127.0.0.1', $pm->getFreePort(), SWOOLE_PROCESS);
+    $serv->set([
+        'log_file' => '/dev/null',
+        'reactor_num' => 4,
+        'worker_num' => 2,
+        'reactor_accept' => true,
+    ]);
+    $serv->on("workerStart", function ($serv) use ($pm) {
+        $pm->wakeup();
+    });
+    $serv->on('receive', function ($serv, $fd, $reactor_id, $data) {
+        $info = $serv->getClientInfo($fd);
+        Assert::same($info['reactor_id'], $reactor_id);
+        Assert::same($info['server_port'], $serv->port);
+        $serv->send($fd, (string) $reactor_id);
+    });
+    $serv->start();
+};
+
+$pm->childFirst();
+$pm->run();
+?>
+--EXPECT--
+DONE
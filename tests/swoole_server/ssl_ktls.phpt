@@ -0,0 +1,52 @@
+--TEST--
+swoole_server: ssl sendfile with kernel tls
+--SKIPIF--
+<?php require __DIR__ . '/../include/skipif.inc'; skip_if_no_ktls(); ?>
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+
+$pm = new SwooleTest\ProcessManager;
+
+$pm->parentFunc = function ($pid) use ($pm) {
+    $client = new swoole_client(SWOOLE_SOCK_TCP | SWOOLE_SSL, SWOOLE_SOCK_SYNC);
+    $client->set(['ssl_ktls' => true]);
+    if (!$client->connect('127.0.0.1', $pm->getFreePort()))
+    {
+        exit("connect failed\n");
+    }
+    $client->send("sendfile");
+    $size = filesize(TEST_IMAGE);
+    $data = '';
+    while (strlen($data) < $size) {
+        $chunk = $client->recv();
+        if (!$chunk) {
+            break;
+        }
+        $data .= $chunk;
+    }
+    Assert::same(md5($data), md5_file(TEST_IMAGE));
+    $pm->kill();
+};
+
+$pm->childFunc = function () use ($pm) {
+    $serv = new swoole_server('127.0.0.1', $pm->getFreePort(), SWOOLE_BASE, SWOOLE_SOCK_TCP | SWOOLE_SSL);
+    $serv->set([
+        'log_file' => '/dev/null',
+        'ssl_ktls' => true,
+        'ssl_cert_file' => dirname(__DIR__) . '/include/api/swoole_http_server/localhost-ssl/server.crt',
+        'ssl_key_file' => dirname(__DIR__) . '/include/api/swoole_http_server/localhost-ssl/server.key',
+    ]);
+    $serv->on("workerStart", function ($serv) use ($pm) {
+        $pm->wakeup();
+    });
+    $serv->on('receive', function ($serv, $fd, $tid, $data) {
+        $serv->sendfile($fd, TEST_IMAGE);
+    });
+    $serv->start();
+};
+
+$pm->childFirst();
+$pm->run();
+?>
+--EXPECT--
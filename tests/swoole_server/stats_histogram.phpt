@@ -0,0 +1,77 @@
+--TEST--
+swoole_server: latency histograms in stats
+--SKIPIF--
+<?php require __DIR__ . '/../include/skipif.inc'; ?>
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+
+const N = 100;
+$port = get_one_free_port();
+
+$pm = new SwooleTest\ProcessManager;
+
+$pm->parentFunc = function ($pid) use ($pm, $port)
+{
+    $client = new swoole_client(SWOOLE_SOCK_TCP, SWOOLE_SOCK_SYNC);
+    $client->set(['open_eof_check' => true, 'package_eof' => "\r\n"]);
+    if (!$client->connect('127.0.0.1', $port, 5))
+    {
+        exit("connect failed\n");
+    }
+    for ($i = 0; $i < N; $i++)
+    {
+        $client->send("hello\r\n");
+        Assert::same($client->recv(), "world\r\n");
+    }
+    $client->send("stats\r\n");
+    $stats = json_decode(trim($client->recv()), true);
+    $keys = ['handler_time', 'reactor_loop_time', 'reactor_event_num'];
+    // the receive time is only kept when it is compiled with SW_BUFFER_RECV_TIME
+    if (method_exists(swoole_server::class, 'getReceivedTime'))
+    {
+        array_push($keys, 'queue_time', 'send_time');
+    }
+    foreach ($keys as $key)
+    {
+        Assert::keyExists($stats, $key);
+        Assert::greaterThanEq($stats[$key]['count'], N);
+        Assert::lessThanEq($stats[$key]['p50'], $stats[$key]['p99']);
+        Assert::lessThanEq($stats[$key]['p99'], $stats[$key]['max']);
+    }
+    Assert::count($stats['workers'], 1);
+    Assert::greaterThanEq($stats['workers'][0]['request_count'], N);
+    $pm->kill();
+};
+
+$pm->childFunc = function () use ($pm, $port)
+{
+    $serv = new swoole_server('127.0.0.1', $port, SWOOLE_PROCESS);
+    $serv->set([
+        'worker_num' => 1,
+        'open_eof_split' => true,
+        'package_eof' => "\r\n",
+        'log_file' => '/dev/null',
+    ]);
+    $serv->on("workerStart", function ($serv) use ($pm)
+    {
+        $pm->wakeup();
+    });
+    $serv->on('receive', function ($serv, $fd, $rid, $data)
+    {
+        if ($data === "stats\r\n")
+        {
+            $serv->send($fd, json_encode($serv->stats()) . "\r\n");
+        }
+        else
+        {
+            $serv->send($fd, "world\r\n");
+        }
+    });
+    $serv->start();
+};
+
+$pm->childFirst();
+$pm->run();
+?>
+--EXPECT--
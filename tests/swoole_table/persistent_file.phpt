@@ -0,0 +1,49 @@
+--TEST--
+swoole_table: restore the rows from the table file
+--SKIPIF--
+<?php require __DIR__ . '/../include/skipif.inc'; ?>
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+
+const N = 1000;
+$file = sys_get_temp_dir() . '/swoole_table_' . getmypid() . '.table';
+
+function create_table(string $file, int $name_size = 32): Swoole\Table
+{
+    $table = new Swoole\Table(2048);
+    $table->column('id', Swoole\Table::TYPE_INT);
+    $table->column('name', Swoole\Table::TYPE_STRING, $name_size);
+    $table->create($file);
+    return $table;
+}
+
+$table = create_table($file);
+for ($i = 0; $i < N; $i++) {
+    $table->set("key-{$i}", ['id' => $i, 'name' => "name-{$i}"]);
+}
+
+// the file is mapped by the table, another one can not attach it at the same time
+$other = new Swoole\Table(2048);
+$other->column('id', Swoole\Table::TYPE_INT);
+$other->column('name', Swoole\Table::TYPE_STRING, 32);
+Assert::false(@$other->create($file));
+$table->destroy();
+
+// the next server attaches the same file
+$table = create_table($file);
+Assert::same($table->count(), N);
+for ($i = 0; $i < N; $i++) {
+    Assert::same($table->get("key-{$i}"), ['id' => $i, 'name' => "name-{$i}"]);
+}
+$table->destroy();
+
+// the file of another schema is dropped
+$table = create_table($file, 64);
+Assert::same($table->count(), 0);
+$table->destroy();
+unlink($file);
+echo "DONE\n";
+?>
+--EXPECT--
+DONE
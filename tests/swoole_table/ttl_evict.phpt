@@ -0,0 +1,45 @@
+--TEST--
+swoole_table: expire the rows and evict the least recently used ones
+--SKIPIF--
+<?php require __DIR__ . '/../include/skipif.inc'; ?>
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+
+$table = new Swoole\Table(64);
+$table->column('id', Swoole\Table::TYPE_INT);
+$table->create();
+
+// the rows set with a ttl are gone once it has passed
+$table->set('short', ['id' => 1], 1);
+$table->set('long', ['id' => 2], 60);
+$table->set('forever', ['id' => 3]);
+Assert::same($table->get('short', 'id'), 1);
+sleep(2);
+Assert::false($table->get('short'));
+Assert::false($table->exists('short'));
+Assert::same($table->get('long', 'id'), 2);
+Assert::same($table->get('forever', 'id'), 3);
+
+// the ttl must fit the 32-bit expiry time
+Assert::false(@$table->set('invalid', ['id' => 5], -1));
+Assert::false(@$table->set('invalid', ['id' => 5], PHP_INT_MAX));
+Assert::false($table->exists('invalid'));
+
+$table->set('swept', ['id' => 4], 1);
+sleep(2);
+Assert::same($table->sweep(), 1);
+Assert::same($table->count(), 2);
+
+// a full table evicts the rows instead of failing
+Assert::true($table->setEvictPolicy(Swoole\Table::EVICT_LRU));
+for ($i = 0; $i < 1000; $i++) {
+    Assert::true($table->set("key-{$i}", ['id' => $i]));
+    Assert::same($table->get('forever', 'id'), 3);
+}
+Assert::same($table->get('key-999', 'id'), 999);
+Assert::lessThan($table->count(), 1000);
+echo "DONE\n";
+?>
+--EXPECT--
+DONE